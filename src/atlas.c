@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <pcg_variants.h>
+
+#include "atlas.h"
+#include "attractor.h"
+
+static uint32_t get_scores_size(uint32_t num_cells) { return (num_cells + 3) & ~3u; }
+
+// Checks that the header describes a file of the given size, so a truncated or foreign file is never read past its
+// end
+static bool is_header_valid(const AtlasHeader *header, size_t size) {
+    if (memcmp(header->magic, ATLAS_MAGIC, sizeof(header->magic)) != 0 || header->version != ATLAS_VERSION) {
+        return false;
+    }
+
+    if (header->num_parameters == 0 || header->num_parameters > ATTRACTOR_MAX_PARAMETERS || header->steps == 0 ||
+        !(header->max > header->min)) {
+        return false;
+    }
+
+    uint64_t num_cells = 1;
+    for (uint32_t i = 0; i < header->num_parameters; i++) {
+        num_cells *= header->steps;
+
+        if (num_cells > ATLAS_MAX_CELLS) {
+            return false;
+        }
+    }
+
+    if (num_cells != header->num_cells || header->num_interesting > header->num_cells) {
+        return false;
+    }
+
+    uint64_t expected = sizeof(AtlasHeader) + get_scores_size(header->num_cells) +
+                        (uint64_t)header->num_interesting * sizeof(uint32_t);
+
+    return size >= expected;
+}
+
+// A corrupt list of interesting cells would have atlas_sample read scores past the end of the map
+static bool are_cells_valid(const AtlasHeader *header, const uint32_t *interesting) {
+    for (uint32_t i = 0; i < header->num_interesting; i++) {
+        if (interesting[i] >= header->num_cells) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Maps the file without reading the scores. Pages are only loaded when a score is looked up, and only the list of
+// interesting cells is read to check it, so startup costs little for any atlas size.
+Atlas *atlas_open(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "failed to open atlas %s\n", path);
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(AtlasHeader)) {
+        fprintf(stderr, "atlas %s is too small\n", path);
+        close(fd);
+        return NULL;
+    }
+
+    void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "failed to map atlas %s\n", path);
+        return NULL;
+    }
+
+    const AtlasHeader *header      = data;
+    const uint8_t     *scores      = (const uint8_t *)data + sizeof(AtlasHeader);
+    const uint32_t    *interesting = (const uint32_t *)(scores + get_scores_size(header->num_cells));
+
+    // The list is only read once the header says it is inside the file
+    if (!is_header_valid(header, st.st_size) || !are_cells_valid(header, interesting)) {
+        fprintf(stderr, "atlas %s is corrupt or from an incompatible version\n", path);
+        munmap(data, st.st_size);
+        return NULL;
+    }
+
+    Atlas *atlas = malloc(sizeof(Atlas));
+
+    atlas->data        = data;
+    atlas->size        = st.st_size;
+    atlas->header      = header;
+    atlas->scores      = scores;
+    atlas->interesting = interesting;
+
+    return atlas;
+}
+
+void atlas_close(Atlas *atlas) {
+    if (atlas == NULL) {
+        return;
+    }
+
+    munmap(atlas->data, atlas->size);
+    free(atlas);
+}
+
+// Writes an atlas from a header describing the grid and one score per cell. The list of interesting cells is built
+// here, and num_interesting in the header is ignored.
+bool atlas_write(const char *path, const AtlasHeader *header, const uint8_t *scores) {
+    AtlasHeader out = *header;
+
+    memcpy(out.magic, ATLAS_MAGIC, sizeof(out.magic));
+    out.version         = ATLAS_VERSION;
+    out.num_interesting = 0;
+
+    for (uint32_t i = 0; i < out.num_cells; i++) {
+        out.num_interesting += scores[i] >= ATLAS_MIN_INTERESTING_SCORE;
+    }
+
+    uint32_t *interesting = malloc((out.num_interesting > 0 ? out.num_interesting : 1) * sizeof(uint32_t));
+    uint32_t  count       = 0;
+
+    for (uint32_t i = 0; i < out.num_cells; i++) {
+        if (scores[i] >= ATLAS_MIN_INTERESTING_SCORE) {
+            interesting[count++] = i;
+        }
+    }
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        fprintf(stderr, "failed to open %s\n", path);
+        free(interesting);
+        return false;
+    }
+
+    uint8_t  padding[4]   = {0};
+    uint32_t padding_size = get_scores_size(out.num_cells) - out.num_cells;
+
+    bool ok = fwrite(&out, sizeof(out), 1, file) == 1;
+    ok      = ok && fwrite(scores, 1, out.num_cells, file) == out.num_cells;
+    ok      = ok && fwrite(padding, 1, padding_size, file) == padding_size;
+    ok      = ok && fwrite(interesting, sizeof(uint32_t), count, file) == count;
+    ok      = fclose(file) == 0 && ok;
+
+    free(interesting);
+
+    if (!ok) {
+        fprintf(stderr, "failed to write %s\n", path);
+    }
+
+    return ok;
+}
+
+bool atlas_matches(const Atlas *atlas, const Attractor *attractor) {
+    return atlas->header->type == attractor->type && atlas->header->num_parameters == attractor->num_parameters;
+}
+
+// Cells are numbered with the first parameter varying fastest, like the sweeps of the scanner. Returns UINT32_MAX
+// for parameters outside of the atlas.
+uint32_t atlas_get_cell(const Atlas *atlas, const float *parameters) {
+    const AtlasHeader *header = atlas->header;
+    uint32_t           cell   = 0;
+    uint32_t           stride = 1;
+
+    for (uint32_t i = 0; i < header->num_parameters; i++) {
+        float t = (parameters[i] - header->min) / (header->max - header->min);
+
+        if (!(t >= 0 && t <= 1)) {
+            return UINT32_MAX;
+        }
+
+        uint32_t index = t * header->steps;
+        if (index >= header->steps) {
+            index = header->steps - 1;
+        }
+
+        cell += index * stride;
+        stride *= header->steps;
+    }
+
+    return cell;
+}
+
+// From 0 to 1, the fraction of probes in the cell that were chaotic
+float atlas_get_score(const Atlas *atlas, const float *parameters) {
+    uint32_t cell = atlas_get_cell(atlas, parameters);
+
+    if (cell == UINT32_MAX) {
+        return 0;
+    }
+
+    return atlas->scores[cell] / 255.0f;
+}
+
+void atlas_get_cell_bounds(const AtlasHeader *header, uint32_t cell, float *min, float *max) {
+    float cell_size = (header->max - header->min) / header->steps;
+
+    for (uint32_t i = 0; i < header->num_parameters; i++) {
+        uint32_t index = cell % header->steps;
+
+        min[i] = header->min + index * cell_size;
+        max[i] = min[i] + cell_size;
+        cell /= header->steps;
+    }
+}
+
+// Puts a random point of a random interesting cell into the attractor's parameters, using its own rng. Cells are
+// picked uniformly and then kept with a chance equal to their score, so the draws are weighted by score without
+// needing a prefix sum over the list. Returns false when the atlas has no interesting cells.
+bool atlas_sample(const Atlas *atlas, Attractor *attractor) {
+    const AtlasHeader *header = atlas->header;
+
+    if (header->num_interesting == 0) {
+        return false;
+    }
+
+    uint32_t cell;
+    do {
+        cell = atlas->interesting[pcg32_boundedrand_r(&attractor->rng, header->num_interesting)];
+    } while (attractor_random(attractor) * 255 >= atlas->scores[cell]);
+
+    float min[ATTRACTOR_MAX_PARAMETERS];
+    float max[ATTRACTOR_MAX_PARAMETERS];
+    atlas_get_cell_bounds(header, cell, min, max);
+
+    for (uint32_t i = 0; i < header->num_parameters; i++) {
+        attractor->parameters[i] = min[i] + attractor_random(attractor) * (max[i] - min[i]);
+    }
+
+    return true;
+}
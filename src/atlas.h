@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef SRC_ATLAS_H_
+#define SRC_ATLAS_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "attractor.h"
+
+#define ATLAS_MAGIC   "ATTRATLS"
+#define ATLAS_VERSION 1
+
+// Loaded at startup when it exists and no other atlas was given
+#define ATLAS_DEFAULT_PATH "clifford.atlas"
+
+// Cells scoring at least this are listed as interesting, which is 1 chaotic probe out of CHAOS_BATCH_LANES
+#define ATLAS_MIN_INTERESTING_SCORE 32
+
+// Largest atlas the scanner builds. Cell indices are 32 bits, and 4 parameters at 128 steps is already 256MB.
+#define ATLAS_MAX_CELLS (1u << 28)
+
+// File layout, all in host byte order: this header, one score byte per cell padded to a multiple of 4 bytes, then
+// the indices of the interesting cells as u32, ascending. Everything is aligned, so the file is used in place once
+// mapped.
+typedef struct {
+    char     magic[8];
+    uint32_t version;
+    uint32_t type;           // AttractorType the atlas was built for
+    uint32_t num_parameters; // Dimensions of the grid
+    uint32_t steps;          // Cells along each dimension
+    float    min;            // Range of every parameter
+    float    max;
+    uint32_t num_cells;
+    uint32_t num_interesting;
+} AtlasHeader;
+
+// Precomputed chaos scores over a coarse grid of parameter space. A cell's score is the fraction of the random
+// parameter sets probed inside it that were chaotic, quantized to a byte. Random searches draw from the interesting
+// cells instead of the whole space, so far fewer candidates get rejected.
+struct Atlas {
+    void  *data; // The whole file, mapped read only
+    size_t size;
+
+    const AtlasHeader *header;
+    const uint8_t     *scores;
+    const uint32_t    *interesting;
+};
+
+Atlas *atlas_open(const char *path);
+void   atlas_close(Atlas *atlas);
+bool   atlas_write(const char *path, const AtlasHeader *header, const uint8_t *scores);
+
+bool     atlas_matches(const Atlas *atlas, const Attractor *attractor);
+uint32_t atlas_get_cell(const Atlas *atlas, const float *parameters);
+float    atlas_get_score(const Atlas *atlas, const float *parameters);
+bool     atlas_sample(const Atlas *atlas, Attractor *attractor);
+
+void atlas_get_cell_bounds(const AtlasHeader *header, uint32_t cell, float *min, float *max);
+
+#endif // SRC_ATLAS_H_
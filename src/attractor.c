@@ -16,18 +16,155 @@
  *
  */
 
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-#include <GLFW/glfw3.h>
-
+#include "atlas.h"
 #include "attractor.h"
+#include "buddhabrot.h"
+#include "chaos.h"
 #include "clifford.h"
+#include "custom.h"
+#include "escape_time.h"
+#include "flame.h"
+#include "flows_c.h"
+#include "maps_c.h"
+#include "sprott.h"
+#include "utils.h"
 
-// Default parameter values for Clifford attractor
+// Default parameter values and the ranges random parameters are drawn from, for each attractor
 float clifford_default_params[4] = {-1.4f, 1.6f, 1.0f, 0.7f};
+float clifford_min_params[4]     = {-2, -2, -2, -2};
+float clifford_max_params[4]     = {2, 2, 2, 2};
+
+float de_jong_default_params[4] = {1.641f, 1.902f, 0.316f, 1.525f};
+float de_jong_min_params[4]     = {-3, -3, -3, -3};
+float de_jong_max_params[4]     = {3, 3, 3, 3};
+
+float henon_default_params[2] = {1.4f, 0.3f};
+float henon_min_params[2]     = {0, -0.5f};
+float henon_max_params[2]     = {1.5f, 0.5f};
+
+float svensson_default_params[4] = {1.4f, 1.56f, 1.4f, -6.56f};
+float svensson_min_params[4]     = {-3, -3, -3, -8};
+float svensson_max_params[4]     = {3, 3, 3, 8};
+
+float bedhead_default_params[2] = {-0.81f, -0.92f};
+float bedhead_min_params[2]     = {-1, -1};
+float bedhead_max_params[2]     = {1, 1};
+
+float tinkerbell_default_params[4] = {0.9f, -0.6013f, 2.0f, 0.5f};
+float tinkerbell_min_params[4]     = {-0.5f, -1, 1.5f, 0};
+float tinkerbell_max_params[4]     = {1, 0, 2.5f, 1};
+
+float gumowski_mira_default_params[3] = {0.008f, 0.05f, -0.496f};
+float gumowski_mira_min_params[3]     = {0, 0, -1};
+float gumowski_mira_max_params[3]     = {0.05f, 0.1f, 1};
+
+float ikeda_default_params[1] = {0.9f};
+float ikeda_min_params[1]     = {0.6f};
+float ikeda_max_params[1]     = {0.99f};
+
+// Sprott's maps draw every coefficient from the letters A to Y, see sprott.h. The defaults are the codes MCPVLETHBNSJ
+// and OPPPOBUBSGUDANJKGJWE.
+float sprott_quadratic_default_params[12] = {0, -1.0f, 0.3f, 0.9f, -0.1f, -0.8f, 0.7f, -0.5f, -1.1f, 0.1f, 0.6f, -0.3f};
+float sprott_quadratic_min_params[12]     = {-1.2f, -1.2f, -1.2f, -1.2f, -1.2f, -1.2f,
+                                             -1.2f, -1.2f, -1.2f, -1.2f, -1.2f, -1.2f};
+float sprott_quadratic_max_params[12]     = {1.2f, 1.2f, 1.2f, 1.2f, 1.2f, 1.2f, 1.2f, 1.2f, 1.2f, 1.2f, 1.2f, 1.2f};
+
+float sprott_cubic_default_params[20] = {0.2f, 0.3f,  0.3f,  0.3f, 0.2f,  -1.1f, 0.8f,  -1.1f, 0.6f, -0.6f,
+                                         0.8f, -0.9f, -1.2f, 0.1f, -0.3f, -0.2f, -0.6f, -0.3f, 1.0f, -0.8f};
+float sprott_cubic_min_params[20]     = {-1.2f, -1.2f, -1.2f, -1.2f, -1.2f, -1.2f, -1.2f, -1.2f, -1.2f, -1.2f,
+                                         -1.2f, -1.2f, -1.2f, -1.2f, -1.2f, -1.2f, -1.2f, -1.2f, -1.2f, -1.2f};
+float sprott_cubic_max_params[20]     = {1.2f, 1.2f, 1.2f, 1.2f, 1.2f, 1.2f, 1.2f, 1.2f, 1.2f, 1.2f,
+                                         1.2f, 1.2f, 1.2f, 1.2f, 1.2f, 1.2f, 1.2f, 1.2f, 1.2f, 1.2f};
+
+// Continuous time attractors, see flows.hpp
+float lorenz_default_params[3] = {10, 28, 8.0f / 3};
+float lorenz_min_params[3]     = {5, 20, 1};
+float lorenz_max_params[3]     = {20, 60, 4};
+
+float rossler_default_params[3] = {0.2f, 0.2f, 5.7f};
+float rossler_min_params[3]     = {0.1f, 0.1f, 3};
+float rossler_max_params[3]     = {0.4f, 1, 12};
+
+float aizawa_default_params[6] = {0.95f, 0.7f, 0.6f, 3.5f, 0.25f, 0.1f};
+float aizawa_min_params[6]     = {0.7f, 0.6f, 0.5f, 3, 0.1f, 0};
+float aizawa_max_params[6]     = {1, 0.8f, 0.7f, 4, 0.4f, 0.2f};
+
+float thomas_default_params[1] = {0.208186f};
+float thomas_min_params[1]     = {0.1f};
+float thomas_max_params[1]     = {0.25f};
+
+float halvorsen_default_params[1] = {1.4f};
+float halvorsen_min_params[1]     = {1.25f};
+float halvorsen_max_params[1]     = {2.2f};
+
+// Each row is a transform, in the order of FlameParameter: weight, color, a to f, variation and blend
+float flame_default_params[FLAME_NUM_PARAMETERS] = {
+    0.5f, 0.0f,  0.56f, -0.32f, 0.1f,  0.32f, 0.56f, 0.2f,  FLAME_VARIATION_SWIRL,     0.6f,
+    0.3f, 0.5f,  0.5f,  0.0f,   0.5f,  0.0f,  0.5f,  -0.3f, FLAME_VARIATION_SPHERICAL, 0.5f,
+    0.2f, 1.0f,  -0.4f, 0.3f,   -0.4f, -0.3f, -0.4f, 0.4f,  FLAME_VARIATION_JULIA,     0.8f,
+    0.0f, 0.25f, 1.0f,  0.0f,   0.0f,  0.0f,  1.0f,  0.0f,  FLAME_VARIATION_LINEAR,    0.0f,
+};
+
+// Variations are truncated, so the top of their range stays short of FLAME_VARIATION_COUNT
+#define FLAME_TRANSFORM_MIN 0, 0, -1, -1, -1, -1, -1, -1, 0, 0
+#define FLAME_TRANSFORM_MAX 1, 1, 1, 1, 1, 1, 1, 1, FLAME_VARIATION_COUNT - 0.01f, 1
+
+float flame_min_params[FLAME_NUM_PARAMETERS] = {FLAME_TRANSFORM_MIN, FLAME_TRANSFORM_MIN, FLAME_TRANSFORM_MIN,
+                                                FLAME_TRANSFORM_MIN};
+float flame_max_params[FLAME_NUM_PARAMETERS] = {FLAME_TRANSFORM_MAX, FLAME_TRANSFORM_MAX, FLAME_TRANSFORM_MAX,
+                                                FLAME_TRANSFORM_MAX};
 
+#define FLAME_TRANSFORM_NAMES(n)                                                                                       \
+    n " weight", n " color", n " a", n " b", n " c", n " d", n " e", n " f", n " variation", n " blend"
+
+char *flame_parameter_names[FLAME_NUM_PARAMETERS] = {FLAME_TRANSFORM_NAMES("1"), FLAME_TRANSFORM_NAMES("2"),
+                                                     FLAME_TRANSFORM_NAMES("3"), FLAME_TRANSFORM_NAMES("4")};
+
+// A Nebulabrot: red for orbits escaping within 5000 steps, green within 500 and blue within 50
+float buddhabrot_default_params[BUDDHABROT_NUM_PARAMETERS] = {-0.4f, 0.0f, 0.0f, 5000.0f, 500.0f, 50.0f};
+float buddhabrot_min_params[BUDDHABROT_NUM_PARAMETERS]     = {-1.8f, -1.2f, 0.0f, 100.0f, 20.0f, 10.0f};
+float buddhabrot_max_params[BUDDHABROT_NUM_PARAMETERS]     = {0.6f, 1.2f, 10.0f, 10000.0f, 2000.0f, 500.0f};
+
+char *buddhabrot_parameter_names[BUDDHABROT_NUM_PARAMETERS] = {"center x",  "center y",    "zoom",
+                                                               "red limit", "green limit", "blue limit"};
+
+float mandelbrot_default_params[1] = {1000.0f};
+float mandelbrot_min_params[1]     = {100.0f};
+float mandelbrot_max_params[1]     = {50000.0f};
+
+char *mandelbrot_parameter_names[1] = {"iterations"};
+
+// A classic, all long spirals
+float julia_default_params[JULIA_NUM_PARAMETERS] = {-0.8f, 0.156f, 1000.0f};
+float julia_min_params[JULIA_NUM_PARAMETERS]     = {-2.0f, -1.2f, 100.0f};
+float julia_max_params[JULIA_NUM_PARAMETERS]     = {0.6f, 1.2f, 50000.0f};
+
+char *julia_parameter_names[JULIA_NUM_PARAMETERS] = {"c x", "c y", "iterations"};
+
+// Clifford's, for the default formula, see CUSTOM_DEFAULT_FORMULA
+float custom_default_params[EXPRESSION_NUM_PARAMETERS] = {-1.4f, 1.6f, 1.0f, 0.7f, 0, 0};
+float custom_min_params[EXPRESSION_NUM_PARAMETERS]     = {-3, -3, -3, -3, -3, -3};
+float custom_max_params[EXPRESSION_NUM_PARAMETERS]     = {3, 3, 3, 3, 3, 3};
+
+// The kernels generated for a map in FOR_EACH_MAP, see maps_c.h
+#define MAP_FUNCTIONS(name)                                                                                            \
+    {                                                                                                                  \
+        .iterate = iterate_##name, .probe = probe_##name, .probe_batch = probe_##name##_batch,                         \
+        .advance = advance_##name,                                                                                     \
+    }
+
+// The kernels generated for a flow in FOR_EACH_FLOW, see flows_c.h
+#define FLOW_FUNCTIONS(name)                                                                                           \
+    {                                                                                                                  \
+        .iterate = iterate_##name, .probe = probe_##name, .advance = advance_##name,                                   \
+    }
+
+// Indexed by AttractorType
 const AttractorSettings attractors[] = {
     {.type           = ATTRACTOR_TYPE_CLIFFORD,
      .name           = "Clifford",
@@ -35,10 +172,221 @@ const AttractorSettings attractors[] = {
                        "sin(b x(n)) + d cos(b y(n))",
      .num_parameters = 4,
      .default_parameters = clifford_default_params,
+     .parameter_min      = clifford_min_params,
+     .parameter_max      = clifford_max_params,
+     .functions          = {
+                  .iterate     = iterate_clifford,
+                  .randomize   = randomize_clifford,
+                  .probe       = probe_clifford,
+                  .probe_batch = probe_clifford_batch,
+                  .advance     = advance_clifford,
+     }},
+    {.type               = ATTRACTOR_TYPE_DE_JONG,
+     .name               = "Peter de Jong",
+     .description        = "x(n+1) = sin(a y(n)) - cos(b x(n)), y(n+1) = sin(c x(n)) - cos(d y(n))",
+     .num_parameters     = 4,
+     .default_parameters = de_jong_default_params,
+     .parameter_min      = de_jong_min_params,
+     .parameter_max      = de_jong_max_params,
+     .functions          = MAP_FUNCTIONS(de_jong)},
+    {.type               = ATTRACTOR_TYPE_HENON,
+     .name               = "Henon",
+     .description        = "x(n+1) = 1 - a x(n)^2 + y(n), y(n+1) = b x(n)",
+     .num_parameters     = 2,
+     .default_parameters = henon_default_params,
+     .parameter_min      = henon_min_params,
+     .parameter_max      = henon_max_params,
+     .functions          = MAP_FUNCTIONS(henon)},
+    {.type               = ATTRACTOR_TYPE_SVENSSON,
+     .name               = "Johnny Svensson",
+     .description        = "x(n+1) = d sin(a x(n)) - sin(b y(n)), y(n+1) = c cos(a x(n)) + cos(b y(n))",
+     .num_parameters     = 4,
+     .default_parameters = svensson_default_params,
+     .parameter_min      = svensson_min_params,
+     .parameter_max      = svensson_max_params,
+     .functions          = MAP_FUNCTIONS(svensson)},
+    {.type               = ATTRACTOR_TYPE_BEDHEAD,
+     .name               = "Bedhead",
+     .description        = "x(n+1) = sin(x(n) y(n) / b) y(n) + cos(a x(n) - y(n)), y(n+1) = x(n) + sin(y(n)) / b",
+     .num_parameters     = 2,
+     .default_parameters = bedhead_default_params,
+     .parameter_min      = bedhead_min_params,
+     .parameter_max      = bedhead_max_params,
+     .functions          = MAP_FUNCTIONS(bedhead)},
+    {.type               = ATTRACTOR_TYPE_TINKERBELL,
+     .name               = "Tinkerbell",
+     .description        = "x(n+1) = x(n)^2 - y(n)^2 + a x(n) + b y(n), y(n+1) = 2 x(n) y(n) + c x(n) + d y(n)",
+     .num_parameters     = 4,
+     .default_parameters = tinkerbell_default_params,
+     .parameter_min      = tinkerbell_min_params,
+     .parameter_max      = tinkerbell_max_params,
+     .functions          = MAP_FUNCTIONS(tinkerbell)},
+    {.type               = ATTRACTOR_TYPE_GUMOWSKI_MIRA,
+     .name               = "Gumowski-Mira",
+     .description        = "x(n+1) = y(n) + a (1 - b y(n)^2) y(n) + f(x(n)), y(n+1) = -x(n) + f(x(n+1)), where f(x) = "
+                           "mu x + 2 (1 - mu) x^2 / (1 + x^2)",
+     .num_parameters     = 3,
+     .default_parameters = gumowski_mira_default_params,
+     .parameter_min      = gumowski_mira_min_params,
+     .parameter_max      = gumowski_mira_max_params,
+     .functions          = MAP_FUNCTIONS(gumowski_mira)},
+    {.type               = ATTRACTOR_TYPE_IKEDA,
+     .name               = "Ikeda",
+     .description        = "x(n+1) = 1 + u (x(n) cos t - y(n) sin t), y(n+1) = u (x(n) sin t + y(n) cos t), where t = "
+                           "0.4 - 6 / (1 + x(n)^2 + y(n)^2)",
+     .num_parameters     = 1,
+     .default_parameters = ikeda_default_params,
+     .parameter_min      = ikeda_min_params,
+     .parameter_max      = ikeda_max_params,
+     .functions          = MAP_FUNCTIONS(ikeda)},
+    {.type               = ATTRACTOR_TYPE_SPROTT_QUADRATIC,
+     .name               = "Sprott quadratic",
+     .description        = "x(n+1) = a0 + a1 x + a2 x^2 + a3 x y + a4 y + a5 y^2, y(n+1) = a6 + a7 x + a8 x^2 + a9 x y "
+                           "+ a10 y + a11 y^2, named by a 12 letter code",
+     .num_parameters     = 12,
+     .default_parameters = sprott_quadratic_default_params,
+     .parameter_min      = sprott_quadratic_min_params,
+     .parameter_max      = sprott_quadratic_max_params,
+     .functions          = {
+                  .iterate     = iterate_sprott_quadratic,
+                  .randomize   = randomize_sprott,
+                  .probe       = probe_sprott_quadratic,
+                  .probe_batch = probe_sprott_quadratic_batch,
+                  .advance     = advance_sprott_quadratic,
+     }},
+    {.type               = ATTRACTOR_TYPE_SPROTT_CUBIC,
+     .name               = "Sprott cubic",
+     .description        = "Every term of x and y up to the third degree in both x(n+1) and y(n+1), named by a 20 "
+                           "letter code",
+     .num_parameters     = 20,
+     .default_parameters = sprott_cubic_default_params,
+     .parameter_min      = sprott_cubic_min_params,
+     .parameter_max      = sprott_cubic_max_params,
      .functions          = {
-                  .iterate   = iterate_clifford,
-                  .randomize = randomize_clifford,
-     }}};
+                  .iterate     = iterate_sprott_cubic,
+                  .randomize   = randomize_sprott,
+                  .probe       = probe_sprott_cubic,
+                  .probe_batch = probe_sprott_cubic_batch,
+                  .advance     = advance_sprott_cubic,
+     }},
+    {.type               = ATTRACTOR_TYPE_LORENZ,
+     .name               = "Lorenz",
+     .description        = "dx/dt = sigma (y - x), dy/dt = x (rho - z) - y, dz/dt = x y - beta z, drawn on the x z "
+                           "plane",
+     .num_parameters     = 3,
+     .default_parameters = lorenz_default_params,
+     .parameter_min      = lorenz_min_params,
+     .parameter_max      = lorenz_max_params,
+     .is_3d              = true,
+     .functions          = FLOW_FUNCTIONS(lorenz)},
+    {.type               = ATTRACTOR_TYPE_ROSSLER,
+     .name               = "Rossler",
+     .description        = "dx/dt = -y - z, dy/dt = x + a y, dz/dt = b + z (x - c), drawn on the x y plane",
+     .num_parameters     = 3,
+     .default_parameters = rossler_default_params,
+     .parameter_min      = rossler_min_params,
+     .parameter_max      = rossler_max_params,
+     .is_3d              = true,
+     .functions          = FLOW_FUNCTIONS(rossler)},
+    {.type               = ATTRACTOR_TYPE_AIZAWA,
+     .name               = "Aizawa",
+     .description        = "dx/dt = (z - b) x - d y, dy/dt = d x + (z - b) y, dz/dt = c + a z - z^3 / 3 - (x^2 + y^2) "
+                           "(1 + e z) + f z x^3, drawn on the x z plane",
+     .num_parameters     = 6,
+     .default_parameters = aizawa_default_params,
+     .parameter_min      = aizawa_min_params,
+     .parameter_max      = aizawa_max_params,
+     .is_3d              = true,
+     .functions          = FLOW_FUNCTIONS(aizawa)},
+    {.type               = ATTRACTOR_TYPE_THOMAS,
+     .name               = "Thomas",
+     .description        = "dx/dt = sin(y) - b x, dy/dt = sin(z) - b y, dz/dt = sin(x) - b z, drawn on the x y "
+                           "plane",
+     .num_parameters     = 1,
+     .default_parameters = thomas_default_params,
+     .parameter_min      = thomas_min_params,
+     .parameter_max      = thomas_max_params,
+     .is_3d              = true,
+     .functions          = FLOW_FUNCTIONS(thomas)},
+    {.type               = ATTRACTOR_TYPE_HALVORSEN,
+     .name               = "Halvorsen",
+     .description        = "dx/dt = -a x - 4 y - 4 z - y^2, and the same for y and z with the coordinates rotated, "
+                           "drawn on the x y plane",
+     .num_parameters     = 1,
+     .default_parameters = halvorsen_default_params,
+     .parameter_min      = halvorsen_min_params,
+     .parameter_max      = halvorsen_max_params,
+     .is_3d              = true,
+     .functions          = FLOW_FUNCTIONS(halvorsen)},
+    {.type               = ATTRACTOR_TYPE_FLAME,
+     .name               = "Fractal Flame",
+     .description        = "Chaos game over 4 weighted affine transforms (x, y) -> (a x + b y + c, d x + e y + f), "
+                           "each bent by one of 13 classic variations (0 linear, 1 sinusoidal, 2 spherical, 3 swirl, "
+                           "4 horseshoe, 5 polar, 6 handkerchief, 7 heart, 8 disc, 9 spiral, 10 hyperbolic, "
+                           "11 diamond, 12 julia) by its blend. Samples are colored by the transforms they went "
+                           "through.",
+     .num_parameters     = FLAME_NUM_PARAMETERS,
+     .default_parameters = flame_default_params,
+     .parameter_min      = flame_min_params,
+     .parameter_max      = flame_max_params,
+     .has_color          = true,
+     .parameter_names    = flame_parameter_names,
+     .functions          = {.iterate = iterate_flame, .probe = probe_flame}},
+    {.type               = ATTRACTOR_TYPE_BUDDHABROT,
+     .name               = "Buddhabrot",
+     .description        = "Orbits of the points c escaping under z -> z^2 + c, drawn in the view centered on "
+                           "(center x, center y) and zoomed in by powers of two. Orbits escaping within the blue, "
+                           "green and red limits are drawn in that color, the lowest limit first. Starting points are "
+                           "sampled by Metropolis-Hastings chains that keep to the orbits crossing the view.",
+     .num_parameters     = BUDDHABROT_NUM_PARAMETERS,
+     .default_parameters = buddhabrot_default_params,
+     .parameter_min      = buddhabrot_min_params,
+     .parameter_max      = buddhabrot_max_params,
+     .has_color          = true,
+     .parameter_names    = buddhabrot_parameter_names,
+     .functions          = {.destroy                 = destroy_buddhabrot,
+                            .iterate                 = iterate_buddhabrot,
+                            .randomize               = randomize_buddhabrot,
+                            .randomize_until_chaotic = randomize_buddhabrot_until_visible}},
+    {.type               = ATTRACTOR_TYPE_MANDELBROT,
+     .name               = "Mandelbrot",
+     .description        = "Points c whose orbit under z -> z^2 + c from 0 stays bounded, colored outside by how fast "
+                           "the orbit escapes. Drag to pan and scroll to zoom, as deep as double double precision "
+                           "allows.",
+     .num_parameters     = 1,
+     .default_parameters = mandelbrot_default_params,
+     .parameter_min      = mandelbrot_min_params,
+     .parameter_max      = mandelbrot_max_params,
+     .is_escape_time     = true,
+     .parameter_names    = mandelbrot_parameter_names,
+     .functions          = {.destroy = destroy_escape_time, .iterate = iterate_escape_time}},
+    {.type               = ATTRACTOR_TYPE_JULIA,
+     .name               = "Julia",
+     .description        = "Starting points z whose orbit under z -> z^2 + c stays bounded, colored outside by how "
+                           "fast the orbit escapes. Drag to pan and scroll to zoom.",
+     .num_parameters     = JULIA_NUM_PARAMETERS,
+     .default_parameters = julia_default_params,
+     .parameter_min      = julia_min_params,
+     .parameter_max      = julia_max_params,
+     .is_escape_time     = true,
+     .parameter_names    = julia_parameter_names,
+     .functions          = {.destroy   = destroy_escape_time,
+                            .iterate   = iterate_escape_time,
+                            .randomize = randomize_julia}},
+    {.type               = ATTRACTOR_TYPE_CUSTOM,
+     .name               = "Custom",
+     .description        = "x(n+1) and y(n+1) given by formulas over x, y and the parameters a to f, typed in or "
+                           "loaded with --formula. The formulas are compiled for the parameters and run on many "
+                           "orbits at once.",
+     .num_parameters     = EXPRESSION_NUM_PARAMETERS,
+     .default_parameters = custom_default_params,
+     .parameter_min      = custom_min_params,
+     .parameter_max      = custom_max_params,
+     .functions          = {.destroy = destroy_custom,
+                            .iterate = iterate_custom,
+                            .probe   = probe_custom,
+                            .advance = advance_custom}},
+};
 
 const AttractorFunctions attractor_functions = {
     .initialize = initialize_attractor,
@@ -51,13 +399,21 @@ Attractor *make_attractor(AttractorType type, uint32_t width, uint32_t height) {
     attractor->type           = type;
     attractor->width          = width;
     attractor->height         = height;
+    attractor->downsample     = 1;
     attractor->num_parameters = attractors[type].num_parameters;
+    attractor->atlas          = NULL;
+    attractor->frame_valid    = false;
+    attractor->camera_enabled = false;
+    attractor->volume         = NULL;
+    attractor->kernel_data    = NULL;
 
     attractor->functions = attractors[type].functions;
 
     attractor->density_map = malloc(width * height * sizeof(uint32_t));
+    attractor->color_map   = attractors[type].has_color ? malloc(width * height * 3 * sizeof(uint64_t)) : NULL;
     attractor->parameters  = malloc(attractor->num_parameters * sizeof(float));
 
+    seed_attractor(attractor, ((uint64_t)pcg32_random() << 32) | pcg32_random(), pcg32_random());
     reset_attractor(attractor);
 
     return attractor;
@@ -69,6 +425,7 @@ void destroy_attractor(Attractor *attractor) {
     }
 
     free(attractor->density_map);
+    free(attractor->color_map);
     free(attractor->parameters);
     free(attractor);
 }
@@ -86,15 +443,16 @@ void iterate_attractor(Attractor *attractor, uint32_t num_iterations) {
 }
 
 void iterate_until_timeout(Attractor *attractor, float timeout) {
-    float start_time = glfwGetTime();
+    float start_time = get_time();
 
-    while (glfwGetTime() - start_time < timeout) {
+    while (get_time() - start_time < timeout) {
         iterate_attractor(attractor, 10000);
     }
 }
 
 void reset_attractor(Attractor *attractor) {
     clean_attractor(attractor);
+    invalidate_orbit(attractor);
 
     memcpy(attractor->parameters, attractors[attractor->type].default_parameters,
            attractors[attractor->type].num_parameters * sizeof(float));
@@ -102,35 +460,290 @@ void reset_attractor(Attractor *attractor) {
 
 void clean_attractor(Attractor *attractor) {
     memset(attractor->density_map, 0, attractor->width * attractor->height * sizeof(uint32_t));
+
+    if (attractor->color_map != NULL) {
+        memset(attractor->color_map, 0, attractor->width * attractor->height * 3 * sizeof(uint64_t));
+    }
+}
+
+// Shannon entropy of the density map, normalized by the entropy of a uniform map of the same size, so 0 means all
+// samples landed on a single pixel and 1 means every pixel was hit equally often
+float get_density_entropy(Attractor *attractor) {
+    uint32_t size  = get_attractor_map_width(attractor) * get_attractor_map_height(attractor);
+    double   total = 0;
+
+    for (uint32_t i = 0; i < size; i++) {
+        total += attractor->density_map[i];
+    }
+
+    if (total == 0 || size < 2) {
+        return 0;
+    }
+
+    double entropy = 0;
+
+    for (uint32_t i = 0; i < size; i++) {
+        if (attractor->density_map[i] > 0) {
+            double p = attractor->density_map[i] / total;
+            entropy -= p * log(p);
+        }
+    }
+
+    return entropy / log(size);
 }
 
 float get_occupancy(Attractor *attractor) {
-    float occupancy = 0;
+    float    occupancy = 0;
+    uint32_t size      = get_attractor_map_width(attractor) * get_attractor_map_height(attractor);
 
-    for (int i = 0; i < attractor->width * attractor->height; i++) {
+    for (int i = 0; i < size; i++) {
         if (attractor->density_map[i] > 0) {
             occupancy++;
         }
     }
 
-    return occupancy / (attractor->width * attractor->height);
+    return occupancy / size;
+}
+
+void seed_attractor(Attractor *attractor, uint64_t seed, uint64_t stream) {
+    pcg32_srandom_r(&attractor->rng, seed, stream);
+}
+
+// Uniform in [0, 1)
+float attractor_random(Attractor *attractor) { return ldexp(pcg32_random_r(&attractor->rng), -32); }
+
+// FNV-1a over the density map, used to check that two renders produced exactly the same image
+uint64_t get_density_checksum(const Attractor *attractor) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    uint32_t size = get_attractor_map_width(attractor) * get_attractor_map_height(attractor);
+
+    for (uint32_t i = 0; i < size; i++) {
+        hash ^= attractor->density_map[i];
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+void set_attractor_parameters(Attractor *attractor, const float *parameters) {
+    float parameter_delta = 0;
+
+    for (uint32_t i = 0; i < attractor->num_parameters; i++) {
+        parameter_delta = fmaxf(parameter_delta, fabsf(parameters[i] - attractor->parameters[i]));
+    }
+
+    memcpy(attractor->parameters, parameters, attractor->num_parameters * sizeof(float));
+
+    warm_start_orbit(attractor, parameter_delta);
+}
+
+// Makes random draws come from the atlas. Atlases built for another attractor are refused, and NULL goes back to
+// drawing from the whole parameter space.
+bool set_attractor_atlas(Attractor *attractor, const Atlas *atlas) {
+    if (atlas != NULL && !atlas_matches(atlas, attractor)) {
+        return false;
+    }
+
+    attractor->atlas = atlas;
+    return true;
+}
+
+// Has the kernels of 3D orbits project through a camera, see Attractor::view_projection. NULL goes back to drawing
+// on a plane. Orbits are kept either way, since only where their points land changes.
+void set_attractor_camera(Attractor *attractor, const float *view_projection) {
+    attractor->camera_enabled = view_projection != NULL;
+
+    if (view_projection != NULL) {
+        memcpy(attractor->view_projection, view_projection, sizeof(attractor->view_projection));
+    }
+}
+
+// Has the kernels of 3D orbits deposit into a volume instead of the density map, which is left alone. NULL goes back
+// to the density map.
+void set_attractor_volume(Attractor *attractor, Volume *volume) { attractor->volume = volume; }
+
+// Keeps the current orbit as the seed for the new parameters. The burn in grows with the size of the change, since
+// the further the attractor moved, the longer the old orbit takes to settle on it.
+void warm_start_orbit(Attractor *attractor, float parameter_delta) {
+    if (!attractor->orbit_valid || parameter_delta <= 0) {
+        return;
+    }
+
+    if (parameter_delta > ATTRACTOR_WARM_START_MAX_DELTA) {
+        invalidate_orbit(attractor);
+        return;
+    }
+
+    float    t       = parameter_delta / ATTRACTOR_WARM_START_MAX_DELTA;
+    uint32_t burn_in = ATTRACTOR_MIN_BURN_IN + t * (ATTRACTOR_COLD_BURN_IN - ATTRACTOR_MIN_BURN_IN);
+
+    if (burn_in > attractor->burn_in) {
+        attractor->burn_in = burn_in;
+    }
+}
+
+// Forces the next iteration to start from a random point, with a full burn in
+void invalidate_orbit(Attractor *attractor) {
+    attractor->orbit_valid = false;
+    attractor->burn_in     = ATTRACTOR_COLD_BURN_IN;
+}
+
+void set_attractor_downsample(Attractor *attractor, uint32_t downsample) {
+    attractor->downsample = downsample > 0 ? downsample : 1;
+    clean_attractor(attractor);
+}
+
+const char *get_attractor_name(AttractorType type) {
+    if (type >= ATTRACTOR_TYPE_COUNT) {
+        return "Unknown";
+    }
+
+    return attractors[type].name;
+}
+
+bool is_attractor_3d(AttractorType type) { return type < ATTRACTOR_TYPE_COUNT && attractors[type].is_3d; }
+
+bool is_attractor_escape_time(AttractorType type) {
+    return type < ATTRACTOR_TYPE_COUNT && attractors[type].is_escape_time;
+}
+
+// NULL when the attractor has no names for its parameters
+const char *get_attractor_parameter_name(const Attractor *attractor, uint32_t index) {
+    const AttractorSettings *settings = &attractors[attractor->type];
+
+    return settings->parameter_names != NULL && index < settings->num_parameters ? settings->parameter_names[index]
+                                                                                   : NULL;
+}
+
+void get_attractor_parameter_range(const Attractor *attractor, uint32_t index, float *min, float *max) {
+    *min = attractors[attractor->type].parameter_min[index];
+    *max = attractors[attractor->type].parameter_max[index];
+}
+
+uint32_t get_attractor_map_width(const Attractor *attractor) { return attractor->width / attractor->downsample; }
+
+uint32_t get_attractor_map_height(const Attractor *attractor) { return attractor->height / attractor->downsample; }
+
+static void draw_random_parameters(Attractor *attractor) {
+    if (attractor->atlas != NULL && atlas_sample(attractor->atlas, attractor)) {
+        return;
+    }
+
+    if (attractor->functions.randomize) {
+        attractor->functions.randomize(attractor);
+        return;
+    }
+
+    for (uint32_t i = 0; i < attractor->num_parameters; i++) {
+        float min, max;
+        get_attractor_parameter_range(attractor, i, &min, &max);
+
+        attractor->parameters[i] = min + attractor_random(attractor) * (max - min);
+    }
 }
 
 void randomize_attractor(Attractor *attractor) {
     reset_attractor(attractor);
-    attractor->functions.randomize(attractor);
+    draw_random_parameters(attractor);
 }
 
 void randomize_until_chaotic(Attractor *attractor) {
+    while (!randomize_candidate(attractor)) {
+    }
+}
+
+// Draws a lane's worth of random parameter sets and probes them together. The first chaotic one is kept.
+static bool randomize_candidate_batch(Attractor *attractor) {
+    float      parameters[CHAOS_BATCH_LANES * ATTRACTOR_MAX_PARAMETERS];
+    ChaosProbe probes[CHAOS_BATCH_LANES];
+    uint32_t   num_parameters = attractor->num_parameters;
+    uint32_t   chosen         = CHAOS_BATCH_LANES - 1;
+
+    for (uint32_t i = 0; i < CHAOS_BATCH_LANES; i++) {
+        draw_random_parameters(attractor);
+        memcpy(parameters + i * num_parameters, attractor->parameters, num_parameters * sizeof(float));
+    }
+
+    probe_attractor_batch(attractor, parameters, CHAOS_BATCH_LANES, CHAOS_PROBE_ITERATIONS, probes);
+
+    for (uint32_t i = 0; i < CHAOS_BATCH_LANES; i++) {
+        if (is_orbit_chaotic(&probes[i])) {
+            chosen = i;
+            break;
+        }
+    }
+
+    reset_attractor(attractor);
+    memcpy(attractor->parameters, parameters + chosen * num_parameters, num_parameters * sizeof(float));
+
+    return is_orbit_chaotic(&probes[chosen]);
+}
+
+// Draws random parameters and returns whether they are chaotic. The candidate is left in the attractor either way, so
+// the caller can keep it or draw again. Attractors with a batch probe draw several candidates per call, and those with
+// their own randomize_until_chaotic get a single draw of it, which is always accepted.
+bool randomize_candidate(Attractor *attractor) {
+    ChaosProbe probe;
+
     if (attractor->functions.randomize_until_chaotic) {
         attractor->functions.randomize_until_chaotic(attractor);
-        return;
+        return true;
+    }
+
+    if (attractor->functions.probe_batch && attractor->num_parameters <= ATTRACTOR_MAX_PARAMETERS) {
+        return randomize_candidate_batch(attractor);
     }
 
-    do {
-        randomize_attractor(attractor);
-        iterate_attractor(attractor, 25000);
-    } while (get_occupancy(attractor) < 0.01);
+    randomize_attractor(attractor);
+
+    // Divergent, convergent and periodic orbits are rejected without filling and scanning the density map, and with
+    // a Lyapunov estimate the probe alone is enough to accept or reject the candidate
+    if (probe_attractor(attractor, CHAOS_PROBE_ITERATIONS, &probe)) {
+        if (!is_orbit_chaotic(&probe)) {
+            return false;
+        }
+
+        if (probe.has_lyapunov) {
+            return true;
+        }
+    }
+
+    iterate_attractor(attractor, 25000);
+
+    return get_occupancy(attractor) >= 0.01;
+}
+
+float get_lyapunov_exponent(Attractor *attractor) {
+    ChaosProbe probe;
+
+    if (!probe_attractor(attractor, CHAOS_PROBE_ITERATIONS, &probe) || !probe.has_lyapunov) {
+        return NAN;
+    }
+
+    return probe.lyapunov;
+}
+
+// Returns false if the attractor has no probe, in which case nothing is known about the orbit
+bool probe_attractor(Attractor *attractor, uint32_t num_iterations, ChaosProbe *probe) {
+    if (!attractor->functions.probe) {
+        return false;
+    }
+
+    attractor->functions.probe(attractor, num_iterations, probe);
+
+    return true;
+}
+
+// Returns false if the attractor has no batch probe
+bool probe_attractor_batch(Attractor *attractor, const float *parameters, uint32_t count, uint32_t num_iterations,
+                           ChaosProbe *probes) {
+    if (!attractor->functions.probe_batch) {
+        return false;
+    }
+
+    attractor->functions.probe_batch(attractor, parameters, count, num_iterations, probes);
+
+    return true;
 }
 
 void initialize_attractor(Attractor *attractor) {
@@ -19,15 +19,62 @@
 #ifndef SRC_ATTRACTOR_H_
 #define SRC_ATTRACTOR_H_
 
+#include <stdbool.h>
 #include <stdint.h>
 
+#include <pcg_variants.h>
+
+#include "volume.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ATTRACTOR_ORBIT_DIMENSIONS 3
+#define ATTRACTOR_MAX_PARAMETERS   40 // Enough for the transforms of a flame, see flame.h
+// Orbits advanced side by side by the kernels that fill SIMD lanes with orbits rather than parameter sets
+#define ATTRACTOR_MAX_ORBITS 16
+
+// Iterations discarded when an orbit starts from a random point
+#define ATTRACTOR_COLD_BURN_IN 1000
+// Iterations discarded after the smallest parameter change
+#define ATTRACTOR_MIN_BURN_IN 16
+// Parameter changes larger than this (in the largest parameter) start a new orbit instead of reusing the old one
+#define ATTRACTOR_WARM_START_MAX_DELTA 0.5f
+
 typedef enum {
     ATTRACTOR_TYPE_CLIFFORD,
+    ATTRACTOR_TYPE_DE_JONG,
+    ATTRACTOR_TYPE_HENON,
+    ATTRACTOR_TYPE_SVENSSON,
+    ATTRACTOR_TYPE_BEDHEAD,
+    ATTRACTOR_TYPE_TINKERBELL,
+    ATTRACTOR_TYPE_GUMOWSKI_MIRA,
+    ATTRACTOR_TYPE_IKEDA,
+    ATTRACTOR_TYPE_SPROTT_QUADRATIC,
+    ATTRACTOR_TYPE_SPROTT_CUBIC,
+    ATTRACTOR_TYPE_LORENZ,
+    ATTRACTOR_TYPE_ROSSLER,
+    ATTRACTOR_TYPE_AIZAWA,
+    ATTRACTOR_TYPE_THOMAS,
+    ATTRACTOR_TYPE_HALVORSEN,
+    ATTRACTOR_TYPE_FLAME,
+    ATTRACTOR_TYPE_BUDDHABROT,
+    ATTRACTOR_TYPE_MANDELBROT,
+    ATTRACTOR_TYPE_JULIA,
+    ATTRACTOR_TYPE_CUSTOM,
+    ATTRACTOR_TYPE_COUNT,
 } AttractorType;
 
 // Forward declaration of Attractor struct
 typedef struct Attractor Attractor;
 
+// Defined in chaos.h
+typedef struct ChaosProbe ChaosProbe;
+
+// Defined in atlas.h
+typedef struct Atlas Atlas;
+
 typedef struct {
     void (*initialize)(Attractor *attractor);
     void (*destroy)(Attractor *attractor);
@@ -36,8 +83,20 @@ typedef struct {
     void (*iterate_until_timeout)(Attractor *attractor, float timeout);
     void (*reset)(Attractor *attractor);
     float (*get_occupancy)(Attractor *attractor);
+    // Optional. Without it parameters are drawn uniformly from the ranges in AttractorSettings.
     void (*randomize)(Attractor *attractor);
     void (*randomize_until_chaotic)(Attractor *attractor);
+    // Optional. Iterates a fresh orbit without touching the density map, classifies it and estimates its Lyapunov
+    // exponent, so candidates can be scored from a few thousand steps.
+    void (*probe)(Attractor *attractor, uint32_t num_iterations, ChaosProbe *probe);
+    // Optional. Probes count parameter sets at once (count * num_parameters floats, one set after the other), with
+    // one set per SIMD lane. Meant for searches, where many candidates are scored and few are kept.
+    void (*probe_batch)(Attractor *attractor, const float *parameters, uint32_t count, uint32_t num_iterations,
+                        ChaosProbe *probes);
+    // Optional. Advances the orbit in state by num_iterations steps of the map with the given parameters, without
+    // touching the density map. Each point visited is written to points (ATTRACTOR_ORBIT_DIMENSIONS floats per step)
+    // unless it is NULL, so other renderers can bin the orbit their own way.
+    void (*advance)(const float *parameters, float *state, uint32_t num_iterations, float *points);
 } AttractorFunctions;
 
 typedef struct {
@@ -46,6 +105,12 @@ typedef struct {
     char         *description;
     uint32_t      num_parameters;
     float        *default_parameters;
+    float        *parameter_min; // Range random parameters are drawn from, and the GUI sliders cover
+    float        *parameter_max;
+    bool          is_3d;           // The orbit fills space, and can be viewed through a camera
+    bool          has_color;       // Samples carry a color, added up on a color map next to the density map
+    bool          is_escape_time;  // Every pixel is iterated on its own instead of sampled, see escape_time.h
+    char        **parameter_names; // Optional, labels for the GUI sliders
 
     AttractorFunctions functions;
 } AttractorSettings;
@@ -60,6 +125,48 @@ struct Attractor {
     uint32_t  width;
     uint32_t  height;
     uint32_t *density_map;
+    // Optional, for attractors with has_color. Red, green and blue of every sample added up per pixel, laid out like
+    // density_map with three values per pixel. Divided by the density it gives the average color. 64 bits wide since
+    // a busy pixel outgrows 32 bits long before its density does.
+    uint64_t *color_map;
+
+    // Accumulate into a (width / downsample) x (height / downsample) map stored at the start of density_map. Used
+    // for quick, low resolution previews. 1 means full resolution.
+    uint32_t downsample;
+
+    // Orbit state kept between calls to iterate, so small parameter changes can continue from where the orbit was
+    // instead of waiting out the transient of a random starting point again
+    float    orbit[ATTRACTOR_ORBIT_DIMENSIONS];
+    bool     orbit_valid;
+    // Same, for kernels advancing several orbits at once. One row per coordinate, one column per orbit.
+    float orbit_lanes[ATTRACTOR_ORBIT_DIMENSIONS][ATTRACTOR_MAX_ORBITS];
+    uint32_t burn_in;
+
+    // Each attractor owns its random stream, so workers never share generator state
+    pcg32_random_t rng;
+
+    // Region of the plane drawn on the density map, for kernels that measure it instead of knowing it in closed form,
+    // and the parameters it was measured for. The 2D maps only use the first two coordinates, and 3D orbits keep the
+    // bounds of every coordinate, the plane being two of them.
+    float frame_min[ATTRACTOR_ORBIT_DIMENSIONS];
+    float frame_max[ATTRACTOR_ORBIT_DIMENSIONS];
+    float frame_parameters[ATTRACTOR_MAX_PARAMETERS];
+    bool  frame_valid;
+
+    // Optional, for 3D orbits. Points are moved into a normalized space, centered on the frame and scaled so its
+    // longest side spans [-1, 1], then projected with this column major matrix instead of drawn on a plane.
+    bool  camera_enabled;
+    float view_projection[16];
+
+    // Optional, for 3D orbits, and shared by every worker. Samples are counted in its voxels instead of on the density
+    // map, in the same normalized space the camera uses.
+    Volume *volume;
+
+    // Optional and shared read only. Random parameters are drawn from its interesting cells instead of the whole space.
+    const Atlas *atlas;
+
+    // Optional, private to the kernels of the type, which allocate it and free it in functions.destroy
+    void *kernel_data;
 
     AttractorFunctions functions;
 };
@@ -74,8 +181,39 @@ void  iterate_attractor(Attractor *attractor, uint32_t num_iterations);
 void  iterate_until_timeout(Attractor *attractor, float timeout);
 void  randomize_attractor(Attractor *attractor);
 void  randomize_until_chaotic(Attractor *attractor);
+bool  randomize_candidate(Attractor *attractor);
 void  reset_attractor(Attractor *attractor);
 void  clean_attractor(Attractor *attractor);
 float get_occupancy(Attractor *attractor);
+float get_density_entropy(Attractor *attractor);
+bool  probe_attractor(Attractor *attractor, uint32_t num_iterations, ChaosProbe *probe);
+bool  probe_attractor_batch(Attractor *attractor, const float *parameters, uint32_t count, uint32_t num_iterations,
+                            ChaosProbe *probes);
+float get_lyapunov_exponent(Attractor *attractor);
+
+const char *get_attractor_name(AttractorType type);
+bool        is_attractor_3d(AttractorType type);
+bool        is_attractor_escape_time(AttractorType type);
+const char *get_attractor_parameter_name(const Attractor *attractor, uint32_t index);
+void        get_attractor_parameter_range(const Attractor *attractor, uint32_t index, float *min, float *max);
+
+void     seed_attractor(Attractor *attractor, uint64_t seed, uint64_t stream);
+float    attractor_random(Attractor *attractor);
+uint64_t get_density_checksum(const Attractor *attractor);
+
+void set_attractor_parameters(Attractor *attractor, const float *parameters);
+bool set_attractor_atlas(Attractor *attractor, const Atlas *atlas);
+void set_attractor_camera(Attractor *attractor, const float *view_projection);
+void set_attractor_volume(Attractor *attractor, Volume *volume);
+void warm_start_orbit(Attractor *attractor, float parameter_delta);
+void invalidate_orbit(Attractor *attractor);
+
+void     set_attractor_downsample(Attractor *attractor, uint32_t downsample);
+uint32_t get_attractor_map_width(const Attractor *attractor);
+uint32_t get_attractor_map_height(const Attractor *attractor);
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif // SRC_ATTRACTOR_H_
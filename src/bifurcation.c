@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "attractor.h"
+#include "bifurcation.h"
+#include "chaos.h"
+
+Bifurcation *bifurcation_init(uint32_t num_columns) {
+    Bifurcation *bifurcation = malloc(sizeof(Bifurcation));
+
+    bifurcation->parameter  = 0;
+    bifurcation->coordinate = 0;
+    bifurcation->min        = -2;
+    bifurcation->max        = 2;
+    bifurcation->low        = -1;
+    bifurcation->high       = 1;
+
+    bifurcation->num_columns = num_columns;
+    bifurcation->columns     = calloc(num_columns, sizeof(BifurcationColumn));
+    bifurcation->next        = 0;
+
+    return bifurcation;
+}
+
+void bifurcation_destroy(Bifurcation *bifurcation) {
+    free(bifurcation->columns);
+    free(bifurcation);
+}
+
+// Value of the swept parameter at the center of a column, when the sweep is split into num_columns
+float bifurcation_get_parameter(const Bifurcation *bifurcation, uint32_t column, uint32_t num_columns) {
+    return bifurcation->min + (column + 0.5f) / num_columns * (bifurcation->max - bifurcation->min);
+}
+
+static void randomize_state(Attractor *attractor, float *state) {
+    for (uint32_t i = 0; i < ATTRACTOR_ORBIT_DIMENSIONS; i++) {
+        state[i] = attractor_random(attractor) * 2 - 1;
+    }
+}
+
+// Samples a few columns across the sweep and fits the plotted coordinate's range to what they visit, with a small
+// margin. Divergent orbits are left out.
+static void measure_range(Bifurcation *bifurcation, Attractor *attractor) {
+    float parameters[ATTRACTOR_MAX_PARAMETERS];
+    float points[BIFURCATION_RANGE_ITERATIONS * ATTRACTOR_ORBIT_DIMENSIONS];
+    float state[ATTRACTOR_ORBIT_DIMENSIONS];
+    float low  = INFINITY;
+    float high = -INFINITY;
+
+    memcpy(parameters, attractor->parameters, attractor->num_parameters * sizeof(float));
+
+    for (uint32_t i = 0; i < BIFURCATION_RANGE_COLUMNS; i++) {
+        parameters[bifurcation->parameter] = bifurcation_get_parameter(bifurcation, i, BIFURCATION_RANGE_COLUMNS);
+
+        randomize_state(attractor, state);
+        attractor->functions.advance(parameters, state, BIFURCATION_BURN_IN, NULL);
+        attractor->functions.advance(parameters, state, BIFURCATION_RANGE_ITERATIONS, points);
+
+        for (uint32_t j = 0; j < BIFURCATION_RANGE_ITERATIONS; j++) {
+            float value = points[j * ATTRACTOR_ORBIT_DIMENSIONS + bifurcation->coordinate];
+
+            if (fabsf(value) < CHAOS_DIVERGENCE_LIMIT) {
+                low  = fminf(low, value);
+                high = fmaxf(high, value);
+            }
+        }
+    }
+
+    if (!(low <= high)) {
+        low  = -1;
+        high = 1;
+    }
+
+    float margin = fmaxf((high - low) * 0.05f, 1e-3f);
+
+    bifurcation->low  = low - margin;
+    bifurcation->high = high + margin;
+}
+
+// Every column burns in again, but keeps its orbit as the starting point, since for a small parameter change it is
+// already close to the new attractor. The workers must be paused and idle, and the attractor must hold the
+// parameters being rendered.
+void bifurcation_reset(Bifurcation *bifurcation, Attractor *attractor) {
+    for (uint32_t i = 0; i < bifurcation->num_columns; i++) {
+        bifurcation->columns[i].burn_in = BIFURCATION_BURN_IN;
+        bifurcation->columns[i].busy    = false;
+    }
+
+    bifurcation->next = 0;
+
+    if (attractor->functions.advance != NULL) {
+        measure_range(bifurcation, attractor);
+    }
+}
+
+// Spreads num_iterations steps over the next columns, BIFURCATION_COLUMN_ITERATIONS at a time, and bins them into
+// the attractor's density map. Columns held by another worker are skipped, which only happens when there are
+// about as many workers as columns.
+void bifurcation_iterate(Bifurcation *bifurcation, Attractor *attractor, uint32_t num_iterations) {
+    uint32_t width  = get_attractor_map_width(attractor);
+    uint32_t height = get_attractor_map_height(attractor);
+
+    if (attractor->functions.advance == NULL || width > bifurcation->num_columns) {
+        return;
+    }
+
+    float    parameters[ATTRACTOR_MAX_PARAMETERS];
+    float    points[BIFURCATION_COLUMN_ITERATIONS * ATTRACTOR_ORBIT_DIMENSIONS];
+    float    scale = height / (bifurcation->high - bifurcation->low);
+    uint32_t skips = 0;
+
+    memcpy(parameters, attractor->parameters, attractor->num_parameters * sizeof(float));
+
+    while (num_iterations > 0 && skips < width) {
+        uint32_t           index    = __atomic_fetch_add(&bifurcation->next, 1, __ATOMIC_RELAXED) % width;
+        BifurcationColumn *column   = &bifurcation->columns[index];
+        bool               expected = false;
+
+        if (!__atomic_compare_exchange_n(&column->busy, &expected, true, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            skips++;
+            continue;
+        }
+
+        parameters[bifurcation->parameter] = bifurcation_get_parameter(bifurcation, index, width);
+
+        if (!column->state_valid) {
+            randomize_state(attractor, column->state);
+            column->state_valid = true;
+            column->burn_in     = BIFURCATION_BURN_IN;
+        }
+
+        if (column->burn_in > 0) {
+            attractor->functions.advance(parameters, column->state, column->burn_in, NULL);
+            column->burn_in = 0;
+        }
+
+        uint32_t count = num_iterations;
+        if (count > BIFURCATION_COLUMN_ITERATIONS) {
+            count = BIFURCATION_COLUMN_ITERATIONS;
+        }
+
+        attractor->functions.advance(parameters, column->state, count, points);
+
+        for (uint32_t i = 0; i < count; i++) {
+            float y = (points[i * ATTRACTOR_ORBIT_DIMENSIONS + bifurcation->coordinate] - bifurcation->low) * scale;
+
+            if (y >= 0 && y < height) {
+                attractor->density_map[index + (uint32_t)y * width] += 1;
+            }
+        }
+
+        for (uint32_t i = 0; i < ATTRACTOR_ORBIT_DIMENSIONS; i++) {
+            if (!isfinite(column->state[i])) {
+                column->state_valid = false;
+            }
+        }
+
+        __atomic_store_n(&column->busy, false, __ATOMIC_RELEASE);
+        num_iterations -= count;
+    }
+}
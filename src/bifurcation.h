@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef SRC_BIFURCATION_H_
+#define SRC_BIFURCATION_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "attractor.h"
+
+// Steps a column is advanced by each time a worker claims it
+#define BIFURCATION_COLUMN_ITERATIONS 256
+// Samples per compute tick. A whole number of claims, or the column claimed last in every tick would always be left
+// short, and with one worker that is the same few columns every time.
+#define BIFURCATION_TICK_ITERATIONS (40 * BIFURCATION_COLUMN_ITERATIONS)
+// Steps discarded after a cold start or a parameter change, before a column's orbit is binned
+#define BIFURCATION_BURN_IN ATTRACTOR_COLD_BURN_IN
+// Columns probed on reset to find the range of the plotted coordinate, and the steps each one is sampled for
+#define BIFURCATION_RANGE_COLUMNS    32
+#define BIFURCATION_RANGE_ITERATIONS 1024
+
+typedef struct {
+    float    state[ATTRACTOR_ORBIT_DIMENSIONS];
+    bool     state_valid;
+    uint32_t burn_in;
+    bool     busy; // Held by the worker advancing the column, so two workers never share an orbit
+} BifurcationColumn;
+
+// Bifurcation diagram: one parameter sweeps the map's x axis, and every column bins a coordinate of its own orbit
+// along y. Columns keep their orbits between claims and are handed out round robin, so any number of workers can
+// advance them at once. The samples go into each worker's density map, and are merged and normalized like any
+// other render.
+typedef struct {
+    uint32_t parameter;  // Parameter swept along x
+    uint32_t coordinate; // Orbit coordinate binned along y
+    float    min;        // Range of the swept parameter
+    float    max;
+    float    low; // Range of the coordinate shown, measured on reset
+    float    high;
+
+    uint32_t           num_columns; // Largest map width, see get_attractor_map_width
+    BifurcationColumn *columns;
+    uint32_t           next; // Next column to claim
+} Bifurcation;
+
+Bifurcation *bifurcation_init(uint32_t num_columns);
+void         bifurcation_destroy(Bifurcation *bifurcation);
+void         bifurcation_reset(Bifurcation *bifurcation, Attractor *attractor);
+void         bifurcation_iterate(Bifurcation *bifurcation, Attractor *attractor, uint32_t num_iterations);
+
+float bifurcation_get_parameter(const Bifurcation *bifurcation, uint32_t column, uint32_t num_columns);
+
+#endif // SRC_BIFURCATION_H_
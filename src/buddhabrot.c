@@ -0,0 +1,406 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+// Buddhabrot: the orbits of the points c escaping under z -> z^2 + c, drawn instead of the points themselves. Built
+// with the SIMD flags.
+//
+// Starting points are not drawn uniformly. ATTRACTOR_MAX_ORBITS Metropolis-Hastings chains each hold a point whose
+// orbit crosses the view, and propose a new one, usually a small mutation of it and sometimes a fresh point anywhere.
+// The proposal is accepted when its orbit crosses the view too, and the orbit the chain holds is drawn after every
+// proposal, accepted or not. Every orbit crossing the view is then equally likely, so the image converges to the one
+// uniform sampling gives, but zoomed views stop wasting nearly every orbit on points that never come near them.
+//
+// The chains trace their proposals side by side, one SIMD lane each, a block of steps at a time. A lane that escaped
+// or ran out of steps idles until the end of the block, then it is settled and starts its next proposal while the
+// other lanes carry on, so short orbits never wait on long ones. Each lane writes its orbits to its own buffers, since
+// an orbit is only drawn once the chain decides on it, and the one it holds is drawn again after every rejection.
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "buddhabrot.h"
+
+#define BUDDHABROT_LANES ATTRACTOR_MAX_ORBITS
+// Steps every lane takes between two checks for settled lanes
+#define BUDDHABROT_BLOCK 8
+#define BUDDHABROT_ESCAPE_RADIUS2 4.0f
+// Half the height of the view at zoom 0, and half the side of the square fresh points are drawn from
+#define BUDDHABROT_HALF_HEIGHT 1.4f
+#define BUDDHABROT_SEED_RADIUS 2.0f
+// Odds of a proposal being a fresh point instead of a mutation, which keeps the chains from getting stuck on one
+// patch of the plane
+#define BUDDHABROT_JUMP_PROBABILITY 0.2f
+// Range of the distance a mutation moves the point by, as fractions of the height of the view. The distance is drawn
+// log uniformly, so both fine and coarse moves are tried.
+#define BUDDHABROT_MIN_MUTATION 1e-4f
+#define BUDDHABROT_MAX_MUTATION 1e-1f
+// Points of an orbit binned at once when it is drawn
+#define BUDDHABROT_DEPOSIT_CHUNK 64
+// Random views are centered on a point escaping within this range of steps, which lies close to the boundary
+#define BUDDHABROT_RANDOM_MIN_ESCAPE 20
+#define BUDDHABROT_RANDOM_MAX_ESCAPE 1000
+#define BUDDHABROT_RANDOM_TRIES      1000
+#define BUDDHABROT_RANDOM_MAX_ZOOM   4.0f
+
+// The view and the color limits, unpacked from the parameters
+typedef struct {
+    float    min_x;
+    float    min_y;
+    float    scale_x;
+    float    scale_y;
+    float    size; // Height of the view on the plane
+    float    width;
+    float    height;
+    uint32_t map_width;
+    uint32_t limits[3];
+    uint32_t max_iterations;
+} BuddhabrotView;
+
+// Kept in kernel_data between calls. The two orbit buffers of a lane hold the orbit of its chain and the proposal
+// being traced, and swap roles when a proposal is accepted.
+typedef struct {
+    float parameters[BUDDHABROT_NUM_PARAMETERS]; // Parameters the chains were started for
+    float orbit_x[BUDDHABROT_LANES][2][BUDDHABROT_MAX_ITERATIONS];
+    float orbit_y[BUDDHABROT_LANES][2][BUDDHABROT_MAX_ITERATIONS];
+
+    // Proposal being traced by each lane
+    float    c_x[BUDDHABROT_LANES];
+    float    c_y[BUDDHABROT_LANES];
+    float    z_x[BUDDHABROT_LANES];
+    float    z_y[BUDDHABROT_LANES];
+    uint32_t length[BUDDHABROT_LANES];
+    uint32_t escaped[BUDDHABROT_LANES];
+
+    // Point held by each chain, if it found one yet
+    float    held_x[BUDDHABROT_LANES];
+    float    held_y[BUDDHABROT_LANES];
+    uint32_t held_length[BUDDHABROT_LANES];
+    uint32_t held_slot[BUDDHABROT_LANES];
+    uint32_t holding[BUDDHABROT_LANES];
+
+    uint32_t rng[BUDDHABROT_LANES];
+} BuddhabrotChains;
+
+// xorshift32, like the flames
+static inline uint32_t next_random(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+
+    return x;
+}
+
+// Uniform in [0, 1) from the top 24 bits
+static inline float to_unit(uint32_t bits) { return (bits >> 8) * (1.0f / (1 << 24)); }
+
+static uint32_t get_limit(float value) { return fminf(fmaxf(value, 1), BUDDHABROT_MAX_ITERATIONS); }
+
+static void load_view(Attractor *attractor, BuddhabrotView *view) {
+    const float *parameters  = attractor->parameters;
+    float        half_height = BUDDHABROT_HALF_HEIGHT / exp2f(parameters[BUDDHABROT_ZOOM]);
+
+    view->map_width = get_attractor_map_width(attractor);
+    view->width     = view->map_width;
+    view->height    = get_attractor_map_height(attractor);
+    view->size      = 2 * half_height;
+
+    float half_width = half_height * view->width / view->height;
+
+    attractor->frame_min[0] = parameters[BUDDHABROT_CENTER_X] - half_width;
+    attractor->frame_max[0] = parameters[BUDDHABROT_CENTER_X] + half_width;
+    attractor->frame_min[1] = parameters[BUDDHABROT_CENTER_Y] - half_height;
+    attractor->frame_max[1] = parameters[BUDDHABROT_CENTER_Y] + half_height;
+    attractor->frame_valid  = true;
+
+    view->min_x   = attractor->frame_min[0];
+    view->min_y   = attractor->frame_min[1];
+    view->scale_x = view->width / (2 * half_width);
+    view->scale_y = view->height / (2 * half_height);
+
+    view->max_iterations = 0;
+    for (uint32_t c = 0; c < 3; c++) {
+        view->limits[c] = get_limit(parameters[BUDDHABROT_RED_LIMIT + c]);
+
+        if (view->limits[c] > view->max_iterations) {
+            view->max_iterations = view->limits[c];
+        }
+    }
+}
+
+// Red, green or blue, whichever has the lowest limit the orbit escaped within
+static uint32_t get_channel(const BuddhabrotView *view, uint32_t length) {
+    uint32_t channel = 0;
+
+    for (uint32_t c = 0; c < 3; c++) {
+        if (length <= view->limits[c] && (length > view->limits[channel] || view->limits[c] < view->limits[channel])) {
+            channel = c;
+        }
+    }
+
+    return channel;
+}
+
+// Points of the main cardioid and of the period 2 bulb never escape, and are the most common of those that do not
+static bool is_interior(float x, float y) {
+    float q = (x - 0.25f) * (x - 0.25f) + y * y;
+
+    return q * (q + (x - 0.25f)) <= 0.25f * y * y || (x + 1) * (x + 1) + y * y <= 0.0625f;
+}
+
+// Scalar, for the few orbits traced outside of the chains. Returns 0 when the orbit did not escape.
+static uint32_t get_escape_time(float c_x, float c_y, uint32_t max_iterations) {
+    float x = 0, y = 0;
+
+    for (uint32_t i = 1; i <= max_iterations; i++) {
+        float next_x = x * x - y * y + c_x;
+
+        y = 2 * x * y + c_y;
+        x = next_x;
+
+        if (x * x + y * y > BUDDHABROT_ESCAPE_RADIUS2) {
+            return i;
+        }
+    }
+
+    return 0;
+}
+
+// Starts the next proposal of a lane. Interior points are given up on at once, and settle as rejected.
+static void propose(BuddhabrotChains *chains, uint32_t lane, const BuddhabrotView *view) {
+    uint32_t *rng = &chains->rng[lane];
+
+    if (!chains->holding[lane] || to_unit(next_random(rng)) < BUDDHABROT_JUMP_PROBABILITY) {
+        chains->c_x[lane] = (to_unit(next_random(rng)) * 2 - 1) * BUDDHABROT_SEED_RADIUS;
+        chains->c_y[lane] = (to_unit(next_random(rng)) * 2 - 1) * BUDDHABROT_SEED_RADIUS;
+    } else {
+        float distance = view->size * BUDDHABROT_MIN_MUTATION *
+                         powf(BUDDHABROT_MAX_MUTATION / BUDDHABROT_MIN_MUTATION, to_unit(next_random(rng)));
+        float angle    = to_unit(next_random(rng)) * 2 * 3.14159265f;
+
+        chains->c_x[lane] = chains->held_x[lane] + distance * cosf(angle);
+        chains->c_y[lane] = chains->held_y[lane] + distance * sinf(angle);
+    }
+
+    chains->z_x[lane]     = 0;
+    chains->z_y[lane]     = 0;
+    chains->escaped[lane] = 0;
+    chains->length[lane]  = is_interior(chains->c_x[lane], chains->c_y[lane]) ? view->max_iterations : 0;
+}
+
+static void start_chains(Attractor *attractor, BuddhabrotChains *chains, const BuddhabrotView *view) {
+    uint32_t seed = pcg32_random_r(&attractor->rng);
+
+    memcpy(chains->parameters, attractor->parameters, sizeof(chains->parameters));
+
+    for (uint32_t l = 0; l < BUDDHABROT_LANES; l++) {
+        chains->rng[l] = (seed + l * 0x6d2b79f5u) | 1;
+        next_random(&chains->rng[l]);
+
+        chains->holding[l]   = 0;
+        chains->held_slot[l] = 0;
+        propose(chains, l, view);
+    }
+}
+
+// Advances every lane's proposal by BUDDHABROT_BLOCK steps, writing the points to block. Lanes that escaped or ran
+// out of steps keep computing but stay put, so the loop over lanes has no branches.
+static void trace_block(BuddhabrotChains *chains, uint32_t max_iterations, float block_x[][BUDDHABROT_LANES],
+                        float block_y[][BUDDHABROT_LANES]) {
+    for (uint32_t k = 0; k < BUDDHABROT_BLOCK; k++) {
+        for (uint32_t l = 0; l < BUDDHABROT_LANES; l++) {
+            float    x      = chains->z_x[l];
+            float    y      = chains->z_y[l];
+            float    next_x = x * x - y * y + chains->c_x[l];
+            float    next_y = 2 * x * y + chains->c_y[l];
+            uint32_t active = (chains->escaped[l] == 0) & (chains->length[l] < max_iterations);
+
+            block_x[k][l] = next_x;
+            block_y[k][l] = next_y;
+
+            chains->z_x[l] = active ? next_x : x;
+            chains->z_y[l] = active ? next_y : y;
+            chains->length[l] += active;
+            chains->escaped[l] |= active & (next_x * next_x + next_y * next_y > BUDDHABROT_ESCAPE_RADIUS2);
+        }
+    }
+}
+
+// Whether the orbit, or its mirror image across the real axis, has a point inside the view
+static bool crosses_view(const BuddhabrotView *view, const float *x, const float *y, uint32_t length) {
+    uint32_t crosses = 0;
+
+    for (uint32_t i = 0; i < length; i++) {
+        float pixel_x  = (x[i] - view->min_x) * view->scale_x;
+        float pixel_y  = (y[i] - view->min_y) * view->scale_y;
+        float mirror_y = (-y[i] - view->min_y) * view->scale_y;
+
+        crosses |= (pixel_x >= 0) & (pixel_x < view->width) &
+                   (((pixel_y >= 0) & (pixel_y < view->height)) | ((mirror_y >= 0) & (mirror_y < view->height)));
+    }
+
+    return crosses;
+}
+
+// The Buddhabrot is symmetric across the real axis, since conjugating c conjugates its whole orbit, so every orbit is
+// drawn twice, once mirrored. That is half the orbits for the same image.
+static void deposit_orbit(Attractor *attractor, const BuddhabrotView *view, const float *x, const float *y,
+                          uint32_t length, uint32_t channel) {
+    uint32_t *density_map = attractor->density_map;
+    uint64_t *color_map   = attractor->color_map;
+
+    for (uint32_t start = 0; start < length; start += BUDDHABROT_DEPOSIT_CHUNK) {
+        uint32_t count = length - start < BUDDHABROT_DEPOSIT_CHUNK ? length - start : BUDDHABROT_DEPOSIT_CHUNK;
+        uint32_t cell[2 * BUDDHABROT_DEPOSIT_CHUNK], hit[2 * BUDDHABROT_DEPOSIT_CHUNK];
+
+        for (uint32_t i = 0; i < count; i++) {
+            float pixel_x  = (x[start + i] - view->min_x) * view->scale_x;
+            float pixel_y  = (y[start + i] - view->min_y) * view->scale_y;
+            float mirror_y = (-y[start + i] - view->min_y) * view->scale_y;
+
+            uint32_t inside_x = (pixel_x >= 0) & (pixel_x < view->width);
+            uint32_t inside   = inside_x & (pixel_y >= 0) & (pixel_y < view->height);
+            uint32_t mirrored = inside_x & (mirror_y >= 0) & (mirror_y < view->height);
+            uint32_t column   = inside_x ? (uint32_t)pixel_x : 0;
+
+            cell[2 * i]     = inside ? column + (uint32_t)pixel_y * view->map_width : 0;
+            cell[2 * i + 1] = mirrored ? column + (uint32_t)mirror_y * view->map_width : 0;
+            hit[2 * i]      = inside;
+            hit[2 * i + 1]  = mirrored;
+        }
+
+        for (uint32_t i = 0; i < 2 * count; i++) {
+            density_map[cell[i]] += hit[i];
+            color_map[cell[i] * 3 + channel] += hit[i] * 255;
+        }
+    }
+}
+
+// Accepts the lane's proposal if its orbit crosses the view, draws the orbit the chain holds, and starts over. The
+// point past the escape radius is left out of the orbit, so the points c escaping at once draw nothing and the square
+// fresh points come from leaves no edge.
+static void settle_lane(Attractor *attractor, BuddhabrotChains *chains, uint32_t lane, const BuddhabrotView *view) {
+    uint32_t slot = 1 - chains->held_slot[lane];
+
+    if (chains->escaped[lane] &&
+        crosses_view(view, chains->orbit_x[lane][slot], chains->orbit_y[lane][slot], chains->length[lane] - 1)) {
+        chains->held_x[lane]      = chains->c_x[lane];
+        chains->held_y[lane]      = chains->c_y[lane];
+        chains->held_length[lane] = chains->length[lane];
+        chains->held_slot[lane]   = slot;
+        chains->holding[lane]     = 1;
+    }
+
+    if (chains->holding[lane]) {
+        uint32_t held = chains->held_slot[lane];
+
+        deposit_orbit(attractor, view, chains->orbit_x[lane][held], chains->orbit_y[lane][held],
+                      chains->held_length[lane] - 1, get_channel(view, chains->held_length[lane]));
+    }
+
+    propose(chains, lane, view);
+}
+
+// num_iterations counts steps of the lanes, idle ones included, so calls take about the same time whatever the view.
+// The chains carry over between calls and restart when the parameters change. They need no burn in: a chain's first
+// point is the first fresh point whose orbit crosses the view, which is already a uniform pick among them.
+void iterate_buddhabrot(Attractor *attractor, uint32_t num_iterations) {
+    BuddhabrotView view;
+
+    load_view(attractor, &view);
+
+    if (attractor->kernel_data == NULL) {
+        attractor->kernel_data = malloc(sizeof(BuddhabrotChains));
+        attractor->orbit_valid = false;
+    }
+
+    BuddhabrotChains *chains = attractor->kernel_data;
+
+    if (!attractor->orbit_valid ||
+        memcmp(chains->parameters, attractor->parameters, sizeof(chains->parameters)) != 0) {
+        start_chains(attractor, chains, &view);
+    }
+    attractor->orbit_valid = true;
+    attractor->burn_in     = 0;
+
+    for (uint32_t i = 0; i < num_iterations; i += BUDDHABROT_BLOCK * BUDDHABROT_LANES) {
+        float    block_x[BUDDHABROT_BLOCK][BUDDHABROT_LANES];
+        float    block_y[BUDDHABROT_BLOCK][BUDDHABROT_LANES];
+        uint32_t start[BUDDHABROT_LANES];
+
+        memcpy(start, chains->length, sizeof(start));
+        trace_block(chains, view.max_iterations, block_x, block_y);
+
+        for (uint32_t l = 0; l < BUDDHABROT_LANES; l++) {
+            uint32_t slot = 1 - chains->held_slot[l];
+
+            for (uint32_t k = 0; k < chains->length[l] - start[l]; k++) {
+                chains->orbit_x[l][slot][start[l] + k] = block_x[k][l];
+                chains->orbit_y[l][slot][start[l] + k] = block_y[k][l];
+            }
+
+            if (chains->escaped[l] || chains->length[l] >= view.max_iterations) {
+                settle_lane(attractor, chains, l, &view);
+            }
+        }
+    }
+}
+
+// Draws the limits log uniformly from their ranges, and a view centered on a point close to the boundary of the
+// Mandelbrot set, where the orbits are long and the Buddhabrot is detailed
+void randomize_buddhabrot(Attractor *attractor) {
+    float *parameters = attractor->parameters;
+
+    for (uint32_t i = BUDDHABROT_RED_LIMIT; i <= BUDDHABROT_BLUE_LIMIT; i++) {
+        float min, max;
+        get_attractor_parameter_range(attractor, i, &min, &max);
+
+        parameters[i] = min * powf(max / min, attractor_random(attractor));
+    }
+
+    parameters[BUDDHABROT_ZOOM] = attractor_random(attractor) * BUDDHABROT_RANDOM_MAX_ZOOM;
+
+    for (uint32_t i = 0; i < BUDDHABROT_RANDOM_TRIES; i++) {
+        for (uint32_t j = BUDDHABROT_CENTER_X; j <= BUDDHABROT_CENTER_Y; j++) {
+            float min, max;
+            get_attractor_parameter_range(attractor, j, &min, &max);
+
+            parameters[j] = min + attractor_random(attractor) * (max - min);
+        }
+
+        uint32_t escape_time = get_escape_time(parameters[BUDDHABROT_CENTER_X], parameters[BUDDHABROT_CENTER_Y],
+                                               BUDDHABROT_RANDOM_MAX_ESCAPE);
+
+        if (escape_time >= BUDDHABROT_RANDOM_MIN_ESCAPE) {
+            break;
+        }
+    }
+}
+
+// Every view near the boundary shows part of the Buddhabrot, so the first random one is kept, without waiting for the
+// occupancy check of randomize_candidate, which a sparse Buddhabrot can take a while to pass
+void randomize_buddhabrot_until_visible(Attractor *attractor) { randomize_attractor(attractor); }
+
+void destroy_buddhabrot(Attractor *attractor) {
+    free(attractor->kernel_data);
+    attractor->kernel_data = NULL;
+}
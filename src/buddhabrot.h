@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef SRC_BUDDHABROT_H_
+#define SRC_BUDDHABROT_H_
+
+#include <stdint.h>
+
+#include "attractor.h"
+
+// Longest orbit traced, which sizes the orbit buffers of every worker
+#define BUDDHABROT_MAX_ITERATIONS 10000
+
+// The view is a window on the complex plane, and each color is drawn by the orbits escaping within its limit and
+// above the next lower one, so the three colors split the orbits by escape time like a Nebulabrot
+typedef enum {
+    BUDDHABROT_CENTER_X,
+    BUDDHABROT_CENTER_Y,
+    BUDDHABROT_ZOOM, // Powers of two
+    BUDDHABROT_RED_LIMIT,
+    BUDDHABROT_GREEN_LIMIT,
+    BUDDHABROT_BLUE_LIMIT,
+    BUDDHABROT_NUM_PARAMETERS,
+} BuddhabrotParameter;
+
+void iterate_buddhabrot(Attractor *attractor, uint32_t num_iterations);
+void randomize_buddhabrot(Attractor *attractor);
+void randomize_buddhabrot_until_visible(Attractor *attractor);
+void destroy_buddhabrot(Attractor *attractor);
+
+#endif // SRC_BUDDHABROT_H_
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "budget.h"
+
+void budget_init(RenderBudget *budget) {
+    memset(budget, 0, sizeof(RenderBudget));
+    budget->mode           = BUDGET_MODE_NONE;
+    budget->target_samples = 1000000000;
+    budget->target_seconds = 60.0f;
+}
+
+void budget_reset(RenderBudget *budget, float current_time) {
+    budget->start_time = current_time;
+    budget->elapsed    = 0;
+    budget->samples    = 0;
+    budget->done       = false;
+}
+
+void budget_set_samples(RenderBudget *budget, uint64_t target_samples) {
+    budget->mode           = BUDGET_MODE_SAMPLES;
+    budget->target_samples = target_samples;
+    budget->done           = false;
+}
+
+void budget_set_time(RenderBudget *budget, float target_seconds) {
+    budget->mode           = BUDGET_MODE_TIME;
+    budget->target_seconds = target_seconds;
+    budget->done           = false;
+}
+
+void budget_clear(RenderBudget *budget) {
+    budget->mode = BUDGET_MODE_NONE;
+    budget->done = false;
+}
+
+bool budget_update(RenderBudget *budget, uint64_t samples, float current_time) {
+    if (budget->done) {
+        return false;
+    }
+
+    budget->samples = samples;
+    budget->elapsed = current_time - budget->start_time;
+
+    switch (budget->mode) {
+        case BUDGET_MODE_SAMPLES: budget->done = budget->samples >= budget->target_samples; break;
+        case BUDGET_MODE_TIME: budget->done = budget->elapsed >= budget->target_seconds; break;
+        default: break;
+    }
+
+    return budget->done;
+}
+
+float budget_get_progress(const RenderBudget *budget) {
+    float progress = 0;
+
+    switch (budget->mode) {
+        case BUDGET_MODE_SAMPLES:
+            if (budget->target_samples > 0) {
+                progress = (double)budget->samples / budget->target_samples;
+            }
+            break;
+        case BUDGET_MODE_TIME:
+            if (budget->target_seconds > 0) {
+                progress = budget->elapsed / budget->target_seconds;
+            }
+            break;
+        default: break;
+    }
+
+    if (budget->done || progress > 1) {
+        return 1;
+    }
+
+    return progress;
+}
+
+float budget_get_samples_per_second(const RenderBudget *budget) {
+    if (budget->elapsed <= 0) {
+        return 0;
+    }
+
+    return budget->samples / budget->elapsed;
+}
+
+// Returns a negative value while there is not enough data for an estimate
+float budget_get_eta(const RenderBudget *budget) {
+    if (budget->done) {
+        return 0;
+    }
+
+    switch (budget->mode) {
+        case BUDGET_MODE_SAMPLES: {
+            float rate = budget_get_samples_per_second(budget);
+            if (rate <= 0) {
+                return -1;
+            }
+
+            return (budget->target_samples - budget->samples) / rate;
+        }
+        case BUDGET_MODE_TIME: return budget->target_seconds - budget->elapsed;
+        default: return -1;
+    }
+}
+
+uint64_t budget_get_remaining_samples(const RenderBudget *budget, uint64_t samples) {
+    if (samples >= budget->target_samples) {
+        return 0;
+    }
+
+    return budget->target_samples - samples;
+}
+
+void budget_format_progress(const RenderBudget *budget, char *buffer, size_t size) {
+    float eta = budget_get_eta(budget);
+
+    switch (budget->mode) {
+        case BUDGET_MODE_SAMPLES:
+            snprintf(buffer, size, "%5.1f%%  %.3e / %.3e samples  %.2e samples/s  eta: %.1fs",
+                     budget_get_progress(budget) * 100.0f, (double)budget->samples, (double)budget->target_samples,
+                     budget_get_samples_per_second(budget), eta < 0 ? 0 : eta);
+            break;
+        case BUDGET_MODE_TIME:
+            snprintf(buffer, size, "%5.1f%%  %.1fs / %.1fs  %.3e samples  eta: %.1fs",
+                     budget_get_progress(budget) * 100.0f, budget->elapsed, budget->target_seconds,
+                     (double)budget->samples, eta < 0 ? 0 : eta);
+            break;
+        default:
+            snprintf(buffer, size, "%.3e samples  %.2e samples/s", (double)budget->samples,
+                     budget_get_samples_per_second(budget));
+            break;
+    }
+}
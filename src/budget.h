@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef SRC_BUDGET_H_
+#define SRC_BUDGET_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum {
+    BUDGET_MODE_NONE,
+    BUDGET_MODE_SAMPLES,
+    BUDGET_MODE_TIME,
+} BudgetMode;
+
+typedef struct {
+    BudgetMode mode;
+    uint64_t   target_samples;
+    float      target_seconds;
+
+    // Progress of the current render, refreshed by budget_update
+    float    start_time;
+    float    elapsed;
+    uint64_t samples;
+    bool     done;
+} RenderBudget;
+
+void budget_init(RenderBudget *budget);
+void budget_reset(RenderBudget *budget, float current_time);
+void budget_set_samples(RenderBudget *budget, uint64_t target_samples);
+void budget_set_time(RenderBudget *budget, float target_seconds);
+void budget_clear(RenderBudget *budget);
+
+// Returns true only on the update that completes the budget
+bool budget_update(RenderBudget *budget, uint64_t samples, float current_time);
+
+float budget_get_progress(const RenderBudget *budget);
+float budget_get_eta(const RenderBudget *budget);
+float budget_get_samples_per_second(const RenderBudget *budget);
+
+uint64_t budget_get_remaining_samples(const RenderBudget *budget, uint64_t samples);
+
+void budget_format_progress(const RenderBudget *budget, char *buffer, size_t size);
+
+#endif // SRC_BUDGET_H_
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include <cglm/cglm.h>
+
+#include "camera.h"
+
+void camera_init(Camera *camera) {
+    camera->yaw      = 0;
+    camera->pitch    = 0.3f;
+    camera->distance = CAMERA_DEFAULT_DISTANCE;
+    camera->fov      = CAMERA_DEFAULT_FOV;
+}
+
+// Turns the camera around the origin by a mouse movement, in pixels
+void camera_orbit(Camera *camera, float delta_x, float delta_y) {
+    camera->yaw   = fmodf(camera->yaw + delta_x * CAMERA_ORBIT_SPEED, 2 * GLM_PI);
+    camera->pitch = fminf(fmaxf(camera->pitch + delta_y * CAMERA_ORBIT_SPEED, -CAMERA_MAX_PITCH), CAMERA_MAX_PITCH);
+}
+
+// Positive steps move closer, like scrolling up
+void camera_zoom(Camera *camera, float steps) {
+    camera->distance = fminf(fmaxf(camera->distance * powf(CAMERA_ZOOM_STEP, -steps), CAMERA_MIN_DISTANCE),
+                             CAMERA_MAX_DISTANCE);
+}
+
+static void camera_get_eye(const Camera *camera, vec3 eye) {
+    eye[0] = camera->distance * cosf(camera->pitch) * cosf(camera->yaw);
+    eye[1] = camera->distance * cosf(camera->pitch) * sinf(camera->yaw);
+    eye[2] = camera->distance * sinf(camera->pitch);
+}
+
+// Column major 4x4 matrix, like cglm's mat4, taking the normalized space to clip space. z is up, which is the axis
+// most of the flows are drawn around.
+void camera_get_view_projection(const Camera *camera, float aspect, float *view_projection) {
+    vec3 eye;
+    vec3 center = {0, 0, 0};
+    vec3 up     = {0, 0, 1};
+
+    camera_get_eye(camera, eye);
+
+    mat4 view, projection, product;
+    glm_lookat(eye, center, up, view);
+    glm_perspective(camera->fov, aspect, CAMERA_NEAR_PLANE, CAMERA_FAR_PLANE, projection);
+    glm_mat4_mul(projection, view, product);
+
+    memcpy(view_projection, product, sizeof(mat4));
+}
+
+// The same view as camera_get_view_projection, for casting rays. The ray through the point (x, y) of normalized device
+// coordinates leaves the eye along forward + x * right + y * up: right and up are scaled to half the width and height
+// of the image plane at distance 1.
+void camera_get_rays(const Camera *camera, float aspect, float *eye, float *forward, float *right, float *up) {
+    vec3 world_up = {0, 0, 1};
+    vec3 f, r, u;
+
+    camera_get_eye(camera, eye);
+    glm_vec3_negate_to(eye, f);
+    glm_vec3_normalize(f);
+    glm_vec3_crossn(f, world_up, r);
+    glm_vec3_cross(r, f, u);
+
+    float half_height = tanf(camera->fov * 0.5f);
+    float half_width  = half_height * aspect;
+
+    for (int i = 0; i < 3; i++) {
+        forward[i] = f[i];
+        right[i]   = r[i] * half_width;
+        up[i]      = u[i] * half_height;
+    }
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef SRC_CAMERA_H_
+#define SRC_CAMERA_H_
+
+#include <stdint.h>
+
+#define CAMERA_DEFAULT_DISTANCE 3.5f
+#define CAMERA_MIN_DISTANCE     1.5f
+#define CAMERA_MAX_DISTANCE     20.0f
+#define CAMERA_DEFAULT_FOV      0.7f // Vertical, in radians
+// Kept short of straight up or down, where the up vector of the view would line up with the view direction
+#define CAMERA_MAX_PITCH 1.55f
+// Radians per pixel of mouse movement, and the distance factor per step of the wheel
+#define CAMERA_ORBIT_SPEED 0.005f
+#define CAMERA_ZOOM_STEP   1.1f
+#define CAMERA_NEAR_PLANE  0.05f
+#define CAMERA_FAR_PLANE   100.0f
+
+// Orbit camera for the attractors with 3D orbits. It circles the origin of the attractor's normalized space, where
+// the frame spans [-1, 1] along its longest side (see Attractor::view_projection), so the same camera frames any of
+// them.
+typedef struct {
+    float yaw;      // Around the vertical axis
+    float pitch;    // Above the horizontal plane
+    float distance; // From the origin, in units of half the frame's longest side
+    float fov;
+} Camera;
+
+void camera_init(Camera *camera);
+void camera_orbit(Camera *camera, float delta_x, float delta_y);
+void camera_zoom(Camera *camera, float steps);
+void camera_get_view_projection(const Camera *camera, float aspect, float *view_projection);
+void camera_get_rays(const Camera *camera, float aspect, float *eye, float *forward, float *right, float *up);
+
+#endif // SRC_CAMERA_H_
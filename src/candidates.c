@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "attractor.h"
+#include "candidates.h"
+
+CandidateQueue *candidate_queue_init(AttractorType type, const Atlas *atlas) {
+    CandidateQueue *queue = malloc(sizeof(CandidateQueue));
+
+    // The density map is only used by attractors without a probe, so it can be tiny
+    queue->scratch        = make_attractor(type, 128, 128);
+    queue->num_parameters = queue->scratch->num_parameters;
+    queue->parameters     = malloc(CANDIDATE_QUEUE_CAPACITY * queue->num_parameters * sizeof(float));
+    set_attractor_atlas(queue->scratch, atlas);
+
+    queue->head    = 0;
+    queue->tail    = 0;
+    queue->running = true;
+
+    void *(*thread_func)(void *) = (void *(*)(void *))candidate_queue_loop;
+    pthread_create(&queue->thread, NULL, thread_func, (void *)queue);
+
+    return queue;
+}
+
+void candidate_queue_destroy(CandidateQueue *queue) {
+    __atomic_store_n(&queue->running, false, __ATOMIC_SEQ_CST);
+    pthread_join(queue->thread, NULL);
+
+    destroy_attractor(queue->scratch);
+    free(queue->parameters);
+    free(queue);
+}
+
+// The producer only does work while the queue has room. Refilling it takes a few milliseconds of a single core, after
+// which the thread just sleeps, so it never competes with the render for long.
+void candidate_queue_loop(CandidateQueue *queue) {
+    while (__atomic_load_n(&queue->running, __ATOMIC_SEQ_CST)) {
+        if (candidate_queue_size(queue) >= CANDIDATE_QUEUE_CAPACITY) {
+            struct timespec ts = {0, CANDIDATE_QUEUE_IDLE_SLEEP_NS};
+            nanosleep(&ts, NULL);
+            continue;
+        }
+
+        if (!randomize_candidate(queue->scratch)) {
+            continue;
+        }
+
+        uint32_t tail = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+        float   *slot = queue->parameters + (tail % CANDIDATE_QUEUE_CAPACITY) * queue->num_parameters;
+
+        memcpy(slot, queue->scratch->parameters, queue->num_parameters * sizeof(float));
+
+        // Publishes the slot. Pairs with the acquire in candidate_queue_pop.
+        __atomic_store_n(&queue->tail, tail + 1, __ATOMIC_RELEASE);
+    }
+}
+
+// Returns false if the queue is empty
+bool candidate_queue_pop(CandidateQueue *queue, float *parameters) {
+    uint32_t head = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+    uint32_t tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+
+    if (head == tail) {
+        return false;
+    }
+
+    float *slot = queue->parameters + (head % CANDIDATE_QUEUE_CAPACITY) * queue->num_parameters;
+    memcpy(parameters, slot, queue->num_parameters * sizeof(float));
+
+    // Hands the slot back to the producer only after it was copied out
+    __atomic_store_n(&queue->head, head + 1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+uint32_t candidate_queue_size(CandidateQueue *queue) {
+    uint32_t head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+    uint32_t tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+
+    return tail - head;
+}
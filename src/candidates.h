@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef SRC_CANDIDATES_H_
+#define SRC_CANDIDATES_H_
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "attractor.h"
+
+#define CANDIDATE_QUEUE_CAPACITY 16
+
+// Time the producer sleeps for while the queue is full
+#define CANDIDATE_QUEUE_IDLE_SLEEP_NS 10000000
+
+// Chaotic parameter sets found ahead of time by a background thread, so Randomize can pop one instantly instead of
+// searching. Single producer, single consumer ring buffer: only the producer moves tail and only the consumer moves
+// head, so no locking is needed.
+typedef struct {
+    uint32_t num_parameters;
+    float   *parameters; // CANDIDATE_QUEUE_CAPACITY slots of num_parameters each
+
+    uint32_t head; // Next slot to pop
+    uint32_t tail; // Next slot to push
+
+    bool       running;
+    Attractor *scratch; // Producer owned, candidates are drawn and probed on it
+    pthread_t  thread;
+} CandidateQueue;
+
+CandidateQueue *candidate_queue_init(AttractorType type, const Atlas *atlas);
+void            candidate_queue_destroy(CandidateQueue *queue);
+void            candidate_queue_loop(CandidateQueue *queue);
+
+bool     candidate_queue_pop(CandidateQueue *queue, float *parameters);
+uint32_t candidate_queue_size(CandidateQueue *queue);
+
+#endif // SRC_CANDIDATES_H_
@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "chaos.h"
+
+void cycle_detector_init(CycleDetector *cycle, const float *state, uint32_t dimensions) {
+    memcpy(cycle->tortoise, state, dimensions * sizeof(float));
+    cycle->dimensions = dimensions;
+    cycle->power      = 1;
+    cycle->lambda     = 0;
+}
+
+// Feed every new state of the orbit. Returns true when the state matches the saved one, in which case lambda holds
+// the period.
+bool cycle_detector_update(CycleDetector *cycle, const float *state) {
+    bool same_state = true;
+
+    cycle->lambda++;
+
+    for (uint32_t i = 0; i < cycle->dimensions; i++) {
+        float tolerance = CHAOS_CYCLE_TOLERANCE * (1.0f + fabsf(cycle->tortoise[i]));
+
+        if (fabsf(state[i] - cycle->tortoise[i]) > tolerance) {
+            same_state = false;
+            break;
+        }
+    }
+
+    if (same_state) {
+        return true;
+    }
+
+    if (cycle->lambda == cycle->power) {
+        memcpy(cycle->tortoise, state, cycle->dimensions * sizeof(float));
+        cycle->power *= 2;
+        cycle->lambda = 0;
+    }
+
+    return false;
+}
+
+void lyapunov_init(LyapunovEstimator *lyapunov, const float *state, float *shadow, uint32_t dimensions) {
+    lyapunov->log_sum    = 0;
+    lyapunov->samples    = 0;
+    lyapunov->dimensions = dimensions;
+
+    memcpy(shadow, state, dimensions * sizeof(float));
+    shadow[0] += CHAOS_LYAPUNOV_SEPARATION;
+}
+
+void lyapunov_update(LyapunovEstimator *lyapunov, const float *state, float *shadow, bool accumulate) {
+    float distance = 0;
+
+    for (uint32_t i = 0; i < lyapunov->dimensions; i++) {
+        float delta = shadow[i] - state[i];
+        distance += delta * delta;
+    }
+
+    distance = sqrtf(distance);
+
+    // Both orbits collapsed onto the same float, the separation is below what we can measure
+    if (distance < 1e-30f) {
+        distance = 1e-30f;
+        shadow[0] += 1e-30f;
+    }
+
+    if (accumulate) {
+        lyapunov->log_sum += log(distance / CHAOS_LYAPUNOV_SEPARATION);
+        lyapunov->samples++;
+    }
+
+    float scale = CHAOS_LYAPUNOV_SEPARATION / distance;
+    for (uint32_t i = 0; i < lyapunov->dimensions; i++) {
+        shadow[i] = state[i] + (shadow[i] - state[i]) * scale;
+    }
+}
+
+float lyapunov_get_exponent(const LyapunovEstimator *lyapunov) {
+    if (lyapunov->samples == 0) {
+        return 0;
+    }
+
+    return lyapunov->log_sum / lyapunov->samples;
+}
+
+void chaos_probe_init(ChaosProbe *probe) {
+    probe->classification = ORBIT_APERIODIC;
+    probe->period         = 0;
+    probe->iterations     = 0;
+    probe->has_lyapunov   = false;
+    probe->lyapunov       = 0;
+    probe->has_coverage   = false;
+    probe->coverage       = 0;
+
+    for (uint32_t i = 0; i < ATTRACTOR_ORBIT_DIMENSIONS; i++) {
+        probe->min[i] = INFINITY;
+        probe->max[i] = -INFINITY;
+    }
+}
+
+// Meant to be called by the kernels after every step. Returns true once the orbit is known to be divergent, a fixed
+// point or periodic, at which point there is no reason to keep iterating it.
+bool chaos_probe_update(ChaosProbe *probe, CycleDetector *cycle, const float *state) {
+    probe->iterations++;
+
+    for (uint32_t i = 0; i < cycle->dimensions; i++) {
+        if (!isfinite(state[i]) || fabsf(state[i]) > CHAOS_DIVERGENCE_LIMIT) {
+            probe->classification = ORBIT_DIVERGENT;
+            return true;
+        }
+    }
+
+    if (cycle_detector_update(cycle, state)) {
+        probe->period         = cycle->lambda;
+        probe->classification = cycle->lambda == 1 ? ORBIT_FIXED_POINT : ORBIT_PERIODIC;
+        return true;
+    }
+
+    if (probe->iterations > CHAOS_PROBE_WARMUP) {
+        for (uint32_t i = 0; i < cycle->dimensions; i++) {
+            probe->min[i] = fminf(probe->min[i], state[i]);
+            probe->max[i] = fmaxf(probe->max[i], state[i]);
+        }
+    }
+
+    return false;
+}
+
+void chaos_probe_finish(ChaosProbe *probe, const LyapunovEstimator *lyapunov) {
+    probe->has_lyapunov = lyapunov->samples > 0;
+    probe->lyapunov     = lyapunov_get_exponent(lyapunov);
+}
+
+// The batch probes have no cycle detection, so an orbit they did not see settle is only known to be aperiodic if its
+// nearby orbits do not converge
+void chaos_probe_classify_by_lyapunov(ChaosProbe *probe) {
+    if (probe->classification == ORBIT_APERIODIC && probe->has_lyapunov && probe->lyapunov < 0) {
+        probe->classification = ORBIT_CONVERGENT;
+    }
+}
+
+// Largest side of the bounding box, or zero if the orbit did not make it past the warmup
+float get_probe_extent(const ChaosProbe *probe) {
+    float extent = 0;
+
+    for (uint32_t i = 0; i < ATTRACTOR_ORBIT_DIMENSIONS; i++) {
+        if (probe->max[i] >= probe->min[i]) {
+            extent = fmaxf(extent, probe->max[i] - probe->min[i]);
+        }
+    }
+
+    return extent;
+}
+
+// A negative Lyapunov exponent means nearby orbits converge, onto a fixed point or a cycle. The batch probes have no
+// cycle detection and rely on this to reject them.
+bool is_orbit_rejected(const ChaosProbe *probe) {
+    if (probe->classification != ORBIT_APERIODIC) {
+        return true;
+    }
+
+    return probe->has_lyapunov && probe->lyapunov < 0;
+}
+
+// Without a Lyapunov estimate, not being rejected is the best we can tell
+bool is_orbit_chaotic(const ChaosProbe *probe) {
+    if (is_orbit_rejected(probe)) {
+        return false;
+    }
+
+    if (!probe->has_lyapunov) {
+        return true;
+    }
+
+    if (probe->has_coverage && probe->coverage < CHAOS_MIN_COVERAGE) {
+        return false;
+    }
+
+    return probe->lyapunov > CHAOS_LYAPUNOV_THRESHOLD && get_probe_extent(probe) > CHAOS_MIN_EXTENT;
+}
+
+const char *get_orbit_class_name(OrbitClass classification) {
+    switch (classification) {
+        case ORBIT_APERIODIC: return "aperiodic";
+        case ORBIT_FIXED_POINT: return "fixed point";
+        case ORBIT_PERIODIC: return "periodic";
+        case ORBIT_DIVERGENT: return "divergent";
+        case ORBIT_CONVERGENT: return "convergent";
+        case ORBIT_UNKNOWN: return "unknown";
+        default: return "unknown";
+    }
+}
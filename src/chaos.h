@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef SRC_CHAOS_H_
+#define SRC_CHAOS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "attractor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Iterations a probe runs before giving up on finding a cycle
+#define CHAOS_PROBE_ITERATIONS 4096
+// Orbits leaving this box are considered unbounded
+#define CHAOS_DIVERGENCE_LIMIT 1e6f
+// Two states closer than this (relative to their magnitude) are considered the same point of a cycle
+#define CHAOS_CYCLE_TOLERANCE 1e-6f
+
+// Distance the shadow orbit is kept at when estimating the Lyapunov exponent
+#define CHAOS_LYAPUNOV_SEPARATION 1e-4f
+// Iterations skipped before accumulating the Lyapunov exponent and the bounding box, so the transient does not bias
+// them
+#define CHAOS_PROBE_WARMUP 128
+// Largest Lyapunov exponent above which a bounded orbit is considered chaotic
+#define CHAOS_LYAPUNOV_THRESHOLD 0.01f
+// Chaotic orbits confined to a smaller box than this would render as a dot
+#define CHAOS_MIN_EXTENT 1e-2f
+
+// Parameter sets probed together by the batch kernels, one per lane
+#define CHAOS_BATCH_LANES 8
+// Side of the coarse occupancy bitmap kept by the batch kernels, in cells
+#define CHAOS_COVERAGE_GRID 32
+// Chaotic orbits covering less of the coverage grid than this are too thin to be worth rendering
+#define CHAOS_MIN_COVERAGE 0.01f
+
+typedef enum {
+    ORBIT_APERIODIC, // No cycle was found, the orbit may be chaotic
+    ORBIT_FIXED_POINT,
+    ORBIT_PERIODIC,
+    ORBIT_DIVERGENT,
+    ORBIT_CONVERGENT, // Negative Lyapunov exponent, bound for a fixed point or cycle the probe could not pin down
+    ORBIT_UNKNOWN,    // Not probed
+} OrbitClass;
+
+struct ChaosProbe {
+    OrbitClass classification;
+    uint32_t   period;
+    uint32_t   iterations; // Iterations it took to reach the verdict
+
+    bool  has_lyapunov;
+    float lyapunov; // Estimate of the largest Lyapunov exponent, in nats per iteration
+
+    bool  has_coverage;
+    float coverage; // Fraction of a CHAOS_COVERAGE_GRID grid over the attractor's bounds visited after the warmup
+
+    // Bounding box of the orbit after the warmup
+    float min[ATTRACTOR_ORBIT_DIMENSIONS];
+    float max[ATTRACTOR_ORBIT_DIMENSIONS];
+};
+
+// Brent's cycle detection. The tortoise jumps to the hare at every power of two, so a cycle of length p entered after
+// m steps is found within about 2 * max(m, p) steps, using a single saved state.
+typedef struct {
+    float    tortoise[ATTRACTOR_ORBIT_DIMENSIONS];
+    uint32_t dimensions;
+    uint32_t power;
+    uint32_t lambda;
+} CycleDetector;
+
+void cycle_detector_init(CycleDetector *cycle, const float *state, uint32_t dimensions);
+bool cycle_detector_update(CycleDetector *cycle, const float *state);
+
+// Two orbit estimator of the largest Lyapunov exponent. The kernel iterates a shadow orbit next to the real one, and
+// after every step the separation is measured and the shadow pulled back to CHAOS_LYAPUNOV_SEPARATION along it. This
+// only needs the map itself, so any kernel can provide it.
+typedef struct {
+    double   log_sum;
+    uint32_t samples;
+    uint32_t dimensions;
+} LyapunovEstimator;
+
+void  lyapunov_init(LyapunovEstimator *lyapunov, const float *state, float *shadow, uint32_t dimensions);
+void  lyapunov_update(LyapunovEstimator *lyapunov, const float *state, float *shadow, bool accumulate);
+float lyapunov_get_exponent(const LyapunovEstimator *lyapunov);
+
+void chaos_probe_init(ChaosProbe *probe);
+bool chaos_probe_update(ChaosProbe *probe, CycleDetector *cycle, const float *state);
+
+void chaos_probe_finish(ChaosProbe *probe, const LyapunovEstimator *lyapunov);
+void chaos_probe_classify_by_lyapunov(ChaosProbe *probe);
+
+float get_probe_extent(const ChaosProbe *probe);
+
+bool        is_orbit_rejected(const ChaosProbe *probe);
+bool        is_orbit_chaotic(const ChaosProbe *probe);
+const char *get_orbit_class_name(OrbitClass classification);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SRC_CHAOS_H_
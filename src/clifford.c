@@ -19,12 +19,11 @@
 #include <math.h>
 #include <stdio.h>
 
-#include <GLFW/glfw3.h>
-
+#include "chaos.h"
 #include "clifford.h"
 #include "utils.h"
 
-void iterate_clifford_impl(Attractor *attractor, uint32_t num_iterations, float x, float y) {
+void iterate_clifford_impl(Attractor *attractor, uint32_t num_iterations, float *x_ptr, float *y_ptr) {
     // xn + 1 = sin(a yn) + c cos(a xn)
     // yn + 1 = sin(b xn) + d cos(b yn)
 
@@ -33,6 +32,9 @@ void iterate_clifford_impl(Attractor *attractor, uint32_t num_iterations, float
     float c = attractor->parameters[2];
     float d = attractor->parameters[3];
 
+    float x = *x_ptr;
+    float y = *y_ptr;
+
     // HACK: The attractor engine shouldn't have to care about rendering
     const float margin = 0.05; // 5% margin
     const float min_x  = (-1 - fabs(c)) * (1 + margin);
@@ -40,6 +42,9 @@ void iterate_clifford_impl(Attractor *attractor, uint32_t num_iterations, float
     const float min_y  = (-1 - fabs(d)) * (1 + margin);
     const float max_y  = (1 + fabs(d)) * (1 + margin);
 
+    const uint32_t width  = get_attractor_map_width(attractor);
+    const uint32_t height = get_attractor_map_height(attractor);
+
     for (uint32_t i = 0; i < num_iterations; i++) {
         float x_new = sin(a * y) + c * cos(a * x);
         float y_new = sin(b * x) + d * cos(b * y);
@@ -48,21 +53,132 @@ void iterate_clifford_impl(Attractor *attractor, uint32_t num_iterations, float
         y = y_new;
 
         // Normalize to fit the texture from 0,0 to width,height
-        uint32_t scaled_x = (uint32_t)((x + max_x) / (max_x - min_x) * attractor->width);
-        uint32_t scaled_y = (uint32_t)((y + max_y) / (max_y - min_y) * attractor->height);
+        uint32_t scaled_x = (uint32_t)((x + max_x) / (max_x - min_x) * width);
+        uint32_t scaled_y = (uint32_t)((y + max_y) / (max_y - min_y) * height);
+
+        attractor->density_map[scaled_x + scaled_y * width] += 1;
+    }
+
+    *x_ptr = x;
+    *y_ptr = y;
+}
+
+void burn_in_clifford(Attractor *attractor, uint32_t num_iterations, float *x_ptr, float *y_ptr) {
+    float a = attractor->parameters[0];
+    float b = attractor->parameters[1];
+    float c = attractor->parameters[2];
+    float d = attractor->parameters[3];
+
+    float x = *x_ptr;
+    float y = *y_ptr;
+
+    for (uint32_t i = 0; i < num_iterations; i++) {
+        float x_new = sin(a * y) + c * cos(a * x);
+        float y_new = sin(b * x) + d * cos(b * y);
+
+        x = x_new;
+        y = y_new;
+    }
+
+    *x_ptr = x;
+    *y_ptr = y;
+}
+
+void advance_clifford(const float *parameters, float *state, uint32_t num_iterations, float *points) {
+    float a = parameters[0];
+    float b = parameters[1];
+    float c = parameters[2];
+    float d = parameters[3];
+
+    float x = state[0];
+    float y = state[1];
+
+    for (uint32_t i = 0; i < num_iterations; i++) {
+        float x_new = sin(a * y) + c * cos(a * x);
+        float y_new = sin(b * x) + d * cos(b * y);
 
-        attractor->density_map[scaled_x + scaled_y * attractor->width] += 1;
+        x = x_new;
+        y = y_new;
+
+        if (points != NULL) {
+            points[i * ATTRACTOR_ORBIT_DIMENSIONS + 0] = x;
+            points[i * ATTRACTOR_ORBIT_DIMENSIONS + 1] = y;
+            points[i * ATTRACTOR_ORBIT_DIMENSIONS + 2] = 0;
+        }
     }
+
+    state[0] = x;
+    state[1] = y;
 }
 
-// Wrapper function to match the expected function signature in AttractorFunctions
+// Wrapper function to match the expected function signature in AttractorFunctions. Continues the orbit left by the
+// previous call, discarding the burn in requested by a cold start or a parameter change first.
 void iterate_clifford(Attractor *attractor, uint32_t num_iterations) {
-    iterate_clifford_impl(attractor, num_iterations, random() * 2 - 1, random() * 2 - 1);
+    if (!attractor->orbit_valid) {
+        attractor->orbit[0]    = attractor_random(attractor) * 2 - 1;
+        attractor->orbit[1]    = attractor_random(attractor) * 2 - 1;
+        attractor->orbit_valid = true;
+    }
+
+    float x = attractor->orbit[0];
+    float y = attractor->orbit[1];
+
+    if (attractor->burn_in > 0) {
+        burn_in_clifford(attractor, attractor->burn_in, &x, &y);
+        attractor->burn_in = 0;
+    }
+
+    iterate_clifford_impl(attractor, num_iterations, &x, &y);
+
+    attractor->orbit[0] = x;
+    attractor->orbit[1] = y;
+
+    if (!isfinite(x) || !isfinite(y)) {
+        invalidate_orbit(attractor);
+    }
+}
+
+void probe_clifford(Attractor *attractor, uint32_t num_iterations, ChaosProbe *probe) {
+    float a = attractor->parameters[0];
+    float b = attractor->parameters[1];
+    float c = attractor->parameters[2];
+    float d = attractor->parameters[3];
+
+    float state[2] = {attractor_random(attractor) * 2 - 1, attractor_random(attractor) * 2 - 1};
+    float shadow[2];
+
+    CycleDetector     cycle;
+    LyapunovEstimator lyapunov;
+    cycle_detector_init(&cycle, state, 2);
+    lyapunov_init(&lyapunov, state, shadow, 2);
+    chaos_probe_init(probe);
+
+    for (uint32_t i = 0; i < num_iterations; i++) {
+        float x = state[0];
+        float y = state[1];
+
+        state[0] = sin(a * y) + c * cos(a * x);
+        state[1] = sin(b * x) + d * cos(b * y);
+
+        if (chaos_probe_update(probe, &cycle, state)) {
+            break;
+        }
+
+        float shadow_x = shadow[0];
+        float shadow_y = shadow[1];
+
+        shadow[0] = sin(a * shadow_y) + c * cos(a * shadow_x);
+        shadow[1] = sin(b * shadow_x) + d * cos(b * shadow_y);
+
+        lyapunov_update(&lyapunov, state, shadow, i >= CHAOS_PROBE_WARMUP);
+    }
+
+    chaos_probe_finish(probe, &lyapunov);
 }
 
 void randomize_clifford(Attractor *attractor) {
-    attractor->parameters[0] = random() * 4 - 2;
-    attractor->parameters[1] = random() * 4 - 2;
-    attractor->parameters[2] = random() * 4 - 2;
-    attractor->parameters[3] = random() * 4 - 2;
+    attractor->parameters[0] = attractor_random(attractor) * 4 - 2;
+    attractor->parameters[1] = attractor_random(attractor) * 4 - 2;
+    attractor->parameters[2] = attractor_random(attractor) * 4 - 2;
+    attractor->parameters[3] = attractor_random(attractor) * 4 - 2;
 }
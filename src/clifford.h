@@ -30,8 +30,13 @@
 // yn + 1 = sin(b xn) + d cos(b yn)
 // where a, b, c, d are variables that define each attractor.
 
-void iterate_clifford_impl(Attractor *attractor, uint32_t num_iterations, float x, float y);
+void iterate_clifford_impl(Attractor *attractor, uint32_t num_iterations, float *x, float *y);
+void burn_in_clifford(Attractor *attractor, uint32_t num_iterations, float *x, float *y);
 void iterate_clifford(Attractor *attractor, uint32_t num_iterations);
+void advance_clifford(const float *parameters, float *state, uint32_t num_iterations, float *points);
 void randomize_clifford(Attractor *attractor);
+void probe_clifford(Attractor *attractor, uint32_t num_iterations, ChaosProbe *probe);
+void probe_clifford_batch(Attractor *attractor, const float *parameters, uint32_t count, uint32_t num_iterations,
+                          ChaosProbe *probes);
 
 #endif // SRC_CLIFFORD_H_
@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+// Lane per parameter set batch probe for the Clifford attractor. This file is built with vector math flags (see
+// SIMD_FLAGS in the Makefile), so that sinf, cosf and logf in the lane loops become libmvec SIMD calls. Under
+// -ffast-math isfinite can not be relied on, so nothing here checks for it.
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "chaos.h"
+#include "clifford.h"
+
+// State of CHAOS_BATCH_LANES probes in structure of arrays form, one parameter set per lane
+typedef struct {
+    float a[CHAOS_BATCH_LANES];
+    float b[CHAOS_BATCH_LANES];
+    float c[CHAOS_BATCH_LANES];
+    float d[CHAOS_BATCH_LANES];
+
+    float x[CHAOS_BATCH_LANES];
+    float y[CHAOS_BATCH_LANES];
+    float shadow_x[CHAOS_BATCH_LANES];
+    float shadow_y[CHAOS_BATCH_LANES];
+    float log_sum[CHAOS_BATCH_LANES];
+
+    float min_x[CHAOS_BATCH_LANES];
+    float max_x[CHAOS_BATCH_LANES];
+    float min_y[CHAOS_BATCH_LANES];
+    float max_y[CHAOS_BATCH_LANES];
+
+    // Maps the bounds of each attractor, |x| <= 1 + |c| and |y| <= 1 + |d|, onto the coverage grid
+    float    bound_x[CHAOS_BATCH_LANES];
+    float    bound_y[CHAOS_BATCH_LANES];
+    float    cell_scale_x[CHAOS_BATCH_LANES];
+    float    cell_scale_y[CHAOS_BATCH_LANES];
+    uint32_t cell[CHAOS_BATCH_LANES];
+    uint32_t coverage[CHAOS_BATCH_LANES][CHAOS_COVERAGE_GRID]; // One bit per cell
+} CliffordLanes;
+
+// Probes one parameter set per lane. The loops over the lanes are branch free, so the compiler runs all lanes in one
+// instruction stream. There is no cycle detection, periodic orbits and fixed points are rejected by their Lyapunov
+// exponent instead. Lanes past count repeat the first parameter set and their results are discarded.
+static void probe_clifford_lanes(const float *parameters, const float *states, uint32_t count,
+                                 uint32_t num_iterations, ChaosProbe *probes) {
+    CliffordLanes lanes;
+
+    memset(lanes.coverage, 0, sizeof(lanes.coverage));
+
+    for (uint32_t l = 0; l < CHAOS_BATCH_LANES; l++) {
+        uint32_t source = l < count ? l : 0;
+
+        lanes.a[l] = parameters[source * 4 + 0];
+        lanes.b[l] = parameters[source * 4 + 1];
+        lanes.c[l] = parameters[source * 4 + 2];
+        lanes.d[l] = parameters[source * 4 + 3];
+
+        lanes.x[l]        = states[source * 2 + 0];
+        lanes.y[l]        = states[source * 2 + 1];
+        lanes.shadow_x[l] = lanes.x[l] + CHAOS_LYAPUNOV_SEPARATION;
+        lanes.shadow_y[l] = lanes.y[l];
+        lanes.log_sum[l]  = 0;
+
+        lanes.min_x[l] = INFINITY;
+        lanes.max_x[l] = -INFINITY;
+        lanes.min_y[l] = INFINITY;
+        lanes.max_y[l] = -INFINITY;
+
+        lanes.bound_x[l]      = 1 + fabsf(lanes.c[l]);
+        lanes.bound_y[l]      = 1 + fabsf(lanes.d[l]);
+        lanes.cell_scale_x[l] = CHAOS_COVERAGE_GRID / (2 * lanes.bound_x[l]);
+        lanes.cell_scale_y[l] = CHAOS_COVERAGE_GRID / (2 * lanes.bound_y[l]);
+    }
+
+    for (uint32_t i = 0; i < num_iterations; i++) {
+        float accumulate = i >= CHAOS_PROBE_WARMUP ? 1 : 0;
+
+        for (uint32_t l = 0; l < CHAOS_BATCH_LANES; l++) {
+            float a = lanes.a[l];
+            float b = lanes.b[l];
+            float c = lanes.c[l];
+            float d = lanes.d[l];
+
+            float x        = sinf(a * lanes.y[l]) + c * cosf(a * lanes.x[l]);
+            float y        = sinf(b * lanes.x[l]) + d * cosf(b * lanes.y[l]);
+            float shadow_x = sinf(a * lanes.shadow_y[l]) + c * cosf(a * lanes.shadow_x[l]);
+            float shadow_y = sinf(b * lanes.shadow_x[l]) + d * cosf(b * lanes.shadow_y[l]);
+
+            float delta_x  = shadow_x - x;
+            float delta_y  = shadow_y - y;
+            float distance = fmaxf(sqrtf(delta_x * delta_x + delta_y * delta_y), 1e-30f);
+            float scale    = CHAOS_LYAPUNOV_SEPARATION / distance;
+
+            lanes.log_sum[l] += accumulate * logf(distance / CHAOS_LYAPUNOV_SEPARATION);
+
+            lanes.x[l]        = x;
+            lanes.y[l]        = y;
+            lanes.shadow_x[l] = x + delta_x * scale;
+            lanes.shadow_y[l] = y + delta_y * scale;
+        }
+
+        if (i < CHAOS_PROBE_WARMUP) {
+            continue;
+        }
+
+        for (uint32_t l = 0; l < CHAOS_BATCH_LANES; l++) {
+            lanes.min_x[l] = fminf(lanes.min_x[l], lanes.x[l]);
+            lanes.max_x[l] = fmaxf(lanes.max_x[l], lanes.x[l]);
+            lanes.min_y[l] = fminf(lanes.min_y[l], lanes.y[l]);
+            lanes.max_y[l] = fmaxf(lanes.max_y[l], lanes.y[l]);
+
+            float    cell_x = (lanes.x[l] + lanes.bound_x[l]) * lanes.cell_scale_x[l];
+            float    cell_y = (lanes.y[l] + lanes.bound_y[l]) * lanes.cell_scale_y[l];
+            uint32_t column = fminf(fmaxf(cell_x, 0), CHAOS_COVERAGE_GRID - 1);
+            uint32_t row    = fminf(fmaxf(cell_y, 0), CHAOS_COVERAGE_GRID - 1);
+
+            lanes.cell[l] = row * CHAOS_COVERAGE_GRID + column;
+        }
+
+        // The scatter into the bitmaps is the only part that stays scalar
+        for (uint32_t l = 0; l < CHAOS_BATCH_LANES; l++) {
+            uint32_t cell = lanes.cell[l];
+
+            lanes.coverage[l][cell / CHAOS_COVERAGE_GRID] |= 1u << (cell % CHAOS_COVERAGE_GRID);
+        }
+    }
+
+    for (uint32_t l = 0; l < count; l++) {
+        ChaosProbe *probe = &probes[l];
+
+        // A Clifford orbit never leaves |x| <= 1 + |c|, |y| <= 1 + |d|, so it can not diverge
+        chaos_probe_init(probe);
+        probe->iterations = num_iterations;
+
+        if (num_iterations <= CHAOS_PROBE_WARMUP) {
+            continue;
+        }
+
+        uint32_t cells = 0;
+        for (uint32_t row = 0; row < CHAOS_COVERAGE_GRID; row++) {
+            cells += __builtin_popcount(lanes.coverage[l][row]);
+        }
+
+        probe->has_lyapunov = true;
+        probe->lyapunov     = lanes.log_sum[l] / (num_iterations - CHAOS_PROBE_WARMUP);
+        probe->has_coverage = true;
+        probe->coverage     = (float)cells / (CHAOS_COVERAGE_GRID * CHAOS_COVERAGE_GRID);
+        probe->min[0]       = lanes.min_x[l];
+        probe->max[0]       = lanes.max_x[l];
+        probe->min[1]       = lanes.min_y[l];
+        probe->max[1]       = lanes.max_y[l];
+
+        chaos_probe_classify_by_lyapunov(probe);
+    }
+}
+
+// parameters holds count sets of 4, one per candidate. The starting points are drawn from the attractor's rng.
+void probe_clifford_batch(Attractor *attractor, const float *parameters, uint32_t count, uint32_t num_iterations,
+                          ChaosProbe *probes) {
+    float states[CHAOS_BATCH_LANES * 2];
+
+    for (uint32_t start = 0; start < count; start += CHAOS_BATCH_LANES) {
+        uint32_t lanes = count - start < CHAOS_BATCH_LANES ? count - start : CHAOS_BATCH_LANES;
+
+        for (uint32_t l = 0; l < lanes * 2; l++) {
+            states[l] = attractor_random(attractor) * 2 - 1;
+        }
+
+        probe_clifford_lanes(parameters + start * 4, states, lanes, num_iterations, probes + start);
+    }
+}
@@ -17,7 +17,9 @@
  */
 
 #include <pthread.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <time.h>
 
 #include "attractor.h"
 #include "compute.h"
@@ -26,6 +28,15 @@ Compute *compute_init(Attractor *attractor) {
     Compute *compute   = malloc(sizeof(Compute));
     compute->attractor = attractor;
     compute->state     = COMPUTE_STATE_PAUSED;
+    compute->busy      = false;
+
+    compute->samples     = 0;
+    compute->sample_pool = NULL;
+    compute->schedule    = NULL;
+    compute->bifurcation = NULL;
+
+    compute->job.tick = NULL;
+    compute->job.data = NULL;
 
     void *(*thread_func)(void *) = (void *(*)(void *))compute_loop;
     pthread_create(&compute->thread, NULL, thread_func, (void *)compute);
@@ -34,23 +45,157 @@ Compute *compute_init(Attractor *attractor) {
 }
 
 void compute_destroy(Compute *compute) {
-    compute->state = COMPUTE_STATE_DIE;
+    __atomic_store_n(&compute->state, COMPUTE_STATE_DIE, __ATOMIC_SEQ_CST);
     pthread_join(compute->thread, NULL);
     free(compute);
 }
 
-void compute_tick(Compute *compute) { iterate_attractor(compute->attractor, 10000); }
+// Takes up to num_samples from the shared pool, without locking, so the workers never overshoot the budget
+static uint32_t claim_samples(Compute *compute, uint32_t num_samples) {
+    if (compute->sample_pool == NULL) {
+        return num_samples;
+    }
+
+    uint64_t remaining = __atomic_load_n(compute->sample_pool, __ATOMIC_RELAXED);
+    uint32_t claimed;
+
+    do {
+        if (remaining == 0) {
+            return 0;
+        }
+
+        claimed = remaining < num_samples ? remaining : num_samples;
+    } while (!__atomic_compare_exchange_n(compute->sample_pool, &remaining, remaining - claimed, true,
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    return claimed;
+}
+
+// Accumulates num_iterations samples of whatever is being rendered into the worker's density map
+static void compute_iterate(Compute *compute, uint32_t num_iterations) {
+    if (compute->bifurcation != NULL) {
+        bifurcation_iterate(compute->bifurcation, compute->attractor, num_iterations);
+        return;
+    }
+
+    iterate_attractor(compute->attractor, num_iterations);
+}
+
+// Runs one block of the deterministic schedule. The block reseeds the attractor and starts a fresh orbit, so its
+// samples do not depend on which worker runs it or on what that worker did before.
+static void compute_tick_block(Compute *compute) {
+    BlockSchedule *schedule = compute->schedule;
+    uint64_t       block    = __atomic_fetch_add(&schedule->next_block, 1, __ATOMIC_RELAXED);
+    uint64_t       start    = block * schedule->block_size;
+
+    if (start >= schedule->total_samples) {
+        return;
+    }
+
+    uint64_t num_iterations = schedule->total_samples - start;
+    if (num_iterations > schedule->block_size) {
+        num_iterations = schedule->block_size;
+    }
+
+    seed_attractor(compute->attractor, schedule->seed, block);
+    invalidate_orbit(compute->attractor);
+    compute_iterate(compute, num_iterations);
+
+    __atomic_fetch_add(&compute->samples, num_iterations, __ATOMIC_RELEASE);
+}
+
+void compute_tick(Compute *compute) {
+    if (compute->schedule != NULL) {
+        compute_tick_block(compute);
+        return;
+    }
+
+    uint32_t tick_iterations = compute->bifurcation != NULL ? BIFURCATION_TICK_ITERATIONS : COMPUTE_TICK_ITERATIONS;
+    uint32_t num_iterations  = claim_samples(compute, tick_iterations);
+
+    if (num_iterations == 0) {
+        return;
+    }
+
+    compute_iterate(compute, num_iterations);
+
+    __atomic_fetch_add(&compute->samples, num_iterations, __ATOMIC_RELEASE);
+}
+
+void compute_resume(Compute *compute) { __atomic_store_n(&compute->state, COMPUTE_STATE_RUNNING, __ATOMIC_SEQ_CST); }
 
-void compute_resume(Compute *compute) { compute->state = COMPUTE_STATE_RUNNING; }
+void compute_pause(Compute *compute) { __atomic_store_n(&compute->state, COMPUTE_STATE_PAUSED, __ATOMIC_SEQ_CST); }
 
-void compute_pause(Compute *compute) { compute->state = COMPUTE_STATE_PAUSED; }
+// Pausing only stops the worker from starting a new tick. This waits for the current one to finish, after which the
+// attractor can be safely modified.
+void compute_wait_idle(Compute *compute) {
+    while (__atomic_load_n(&compute->busy, __ATOMIC_SEQ_CST)) {
+        // Sleep for 0.1ms
+        struct timespec ts = {0, 100000};
+        nanosleep(&ts, NULL);
+    }
+}
 
 void compute_loop(Compute *compute) {
-    while (compute->state != COMPUTE_STATE_DIE) {
-        compute_tick(compute);
+    while (__atomic_load_n(&compute->state, __ATOMIC_SEQ_CST) != COMPUTE_STATE_DIE) {
+        // Flag as busy before checking the state, so compute_wait_idle can not miss a tick that is about to start
+        __atomic_store_n(&compute->busy, true, __ATOMIC_SEQ_CST);
+
+        if (__atomic_load_n(&compute->state, __ATOMIC_SEQ_CST) == COMPUTE_STATE_RUNNING) {
+            // A job runs even when the render is done, since it has nothing to do with the render budget
+            if (compute->job.tick != NULL) {
+                compute->job.tick(compute->job.data);
+                __atomic_store_n(&compute->busy, false, __ATOMIC_SEQ_CST);
+                continue;
+            }
+
+            if (!compute_is_done(compute)) {
+                compute_tick(compute);
+                __atomic_store_n(&compute->busy, false, __ATOMIC_SEQ_CST);
+                continue;
+            }
+        }
+
+        __atomic_store_n(&compute->busy, false, __ATOMIC_SEQ_CST);
+
+        // Sleep for 1ms
+        struct timespec ts = {0, 1000000};
+        nanosleep(&ts, NULL);
+    }
+}
+
+void compute_set_sample_pool(Compute *compute, uint64_t *sample_pool) { compute->sample_pool = sample_pool; }
+
+void compute_set_schedule(Compute *compute, BlockSchedule *schedule) { compute->schedule = schedule; }
+
+// The worker must be paused and idle, see compute_wait_idle
+void compute_set_bifurcation(Compute *compute, Bifurcation *bifurcation) { compute->bifurcation = bifurcation; }
+
+// Acquire pairs with the release in compute_tick, so once the samples are visible so are their density map writes
+uint64_t compute_get_samples(Compute *compute) { return __atomic_load_n(&compute->samples, __ATOMIC_ACQUIRE); }
+
+bool compute_is_done(Compute *compute) {
+    if (compute->schedule != NULL) {
+        BlockSchedule *schedule = compute->schedule;
+        uint64_t       block    = __atomic_load_n(&schedule->next_block, __ATOMIC_RELAXED);
+
+        return block * schedule->block_size >= schedule->total_samples;
     }
+
+    return compute->sample_pool != NULL && __atomic_load_n(compute->sample_pool, __ATOMIC_RELAXED) == 0;
+}
+
+// The worker must be paused and idle, see compute_wait_idle
+void compute_set_job(Compute *compute, void (*tick)(void *data), void *data) {
+    compute->job.tick = tick;
+    compute->job.data = data;
 }
 
-void compute_clean_attractor(Compute *compute) { clean_attractor(compute->attractor); }
+void compute_clear_job(Compute *compute) { compute_set_job(compute, NULL, NULL); }
+
+void compute_clean_attractor(Compute *compute) {
+    clean_attractor(compute->attractor);
+    __atomic_store_n(&compute->samples, 0, __ATOMIC_RELAXED);
+}
 
 void compute_reset_attractor(Compute *compute) { reset_attractor(compute->attractor); }
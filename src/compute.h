@@ -20,8 +20,17 @@
 #define SRC_COMPUTE_H_
 
 #include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
 
 #include "attractor.h"
+#include "bifurcation.h"
+
+#define COMPUTE_TICK_ITERATIONS 10000
+
+// Samples per block in deterministic mode. Every block pays for a cold burn in, so it has to be much larger than
+// ATTRACTOR_COLD_BURN_IN, but small enough for a worker to finish it within a frame.
+#define COMPUTE_BLOCK_SIZE (1 << 18)
 
 typedef enum {
     COMPUTE_STATE_PAUSED,
@@ -29,10 +38,43 @@ typedef enum {
     COMPUTE_STATE_DIE,
 } ComputeState;
 
+// Splits a render into fixed size blocks, each seeded from (seed, block id). Since a block always produces the same
+// samples no matter which worker runs it, the merged image only depends on how many samples were rendered.
+typedef struct {
+    uint64_t seed;
+    uint64_t block_size;
+    uint64_t total_samples; // UINT64_MAX when there is no sample target
+    uint64_t next_block;    // Claimed by the workers with atomics
+} BlockSchedule;
+
+// Work that replaces the render tick while it is set, e.g. a parameter search. The tick is called over and over with
+// the same data until the job is cleared, and should return within a few milliseconds so the worker can be paused.
+typedef struct {
+    void (*tick)(void *data);
+    void *data;
+} ComputeJob;
+
 typedef struct {
     ComputeState state;
+    bool         busy; // Set while the worker is inside a tick
     Attractor   *attractor;
 
+    // Number of samples accumulated since the last clean. It is updated with atomics and read through
+    // compute_get_samples, so no locking is needed.
+    uint64_t samples;
+
+    // Samples left in the render budget, shared by all workers. NULL when rendering without a sample target.
+    uint64_t *sample_pool;
+
+    // Deterministic render schedule, shared by all workers. NULL when rendering freely.
+    BlockSchedule *schedule;
+
+    // Bifurcation diagram rendered instead of the attractor, shared by all workers. NULL when rendering the attractor.
+    Bifurcation *bifurcation;
+
+    // Only changed while the worker is paused and idle
+    ComputeJob job;
+
     pthread_t thread;
 } Compute;
 
@@ -40,9 +82,19 @@ Compute *compute_init(Attractor *attractor);
 void     compute_destroy(Compute *compute);
 void     compute_pause(Compute *compute);
 void     compute_resume(Compute *compute);
+void     compute_wait_idle(Compute *compute);
 void     compute_tick(Compute *compute);
 void     compute_loop(Compute *compute);
 
+void     compute_set_sample_pool(Compute *compute, uint64_t *sample_pool);
+void     compute_set_schedule(Compute *compute, BlockSchedule *schedule);
+void     compute_set_bifurcation(Compute *compute, Bifurcation *bifurcation);
+uint64_t compute_get_samples(Compute *compute);
+bool     compute_is_done(Compute *compute);
+
+void compute_set_job(Compute *compute, void (*tick)(void *data), void *data);
+void compute_clear_job(Compute *compute);
+
 void compute_clean_attractor(Compute *compute);
 void compute_reset_attractor(Compute *compute);
 
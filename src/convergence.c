@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "convergence.h"
+
+void convergence_init(Convergence *convergence, uint32_t width, uint32_t height) {
+    memset(convergence, 0, sizeof(Convergence));
+
+    convergence->enabled         = true;
+    convergence->threshold       = 0.001f;
+    convergence->required_checks = 3;
+    convergence->check_interval  = 1.0f;
+
+    convergence->tiles_x  = (width + CONVERGENCE_TILE_SIZE - 1) / CONVERGENCE_TILE_SIZE;
+    convergence->tiles_y  = (height + CONVERGENCE_TILE_SIZE - 1) / CONVERGENCE_TILE_SIZE;
+    convergence->previous = malloc(convergence->tiles_x * convergence->tiles_y * sizeof(float));
+    convergence->current  = malloc(convergence->tiles_x * convergence->tiles_y * sizeof(float));
+
+    convergence_reset(convergence);
+}
+
+void convergence_destroy(Convergence *convergence) {
+    free(convergence->previous);
+    free(convergence->current);
+}
+
+void convergence_reset(Convergence *convergence) {
+    convergence->has_previous    = false;
+    convergence->last_check_time = 0;
+    convergence->change          = INFINITY;
+    convergence->stable_checks   = 0;
+    convergence->converged       = false;
+}
+
+static void take_snapshot(Convergence *convergence, const float *texture_data_gl, uint32_t width, uint32_t height) {
+    memset(convergence->current, 0, convergence->tiles_x * convergence->tiles_y * sizeof(float));
+
+    for (uint32_t y = 0; y < height; y++) {
+        float *tile_row = &convergence->current[(y / CONVERGENCE_TILE_SIZE) * convergence->tiles_x];
+
+        for (uint32_t x = 0; x < width; x++) {
+            tile_row[x / CONVERGENCE_TILE_SIZE] += texture_data_gl[(x + y * width) * 4];
+        }
+    }
+
+    const float tile_area = CONVERGENCE_TILE_SIZE * CONVERGENCE_TILE_SIZE;
+    for (uint32_t i = 0; i < convergence->tiles_x * convergence->tiles_y; i++) {
+        convergence->current[i] /= tile_area;
+    }
+}
+
+static float compare_snapshots(const Convergence *convergence) {
+    float max_change = 0;
+
+    for (uint32_t i = 0; i < convergence->tiles_x * convergence->tiles_y; i++) {
+        float previous = convergence->previous[i];
+        float change   = fabsf(convergence->current[i] - previous) / fmaxf(previous, CONVERGENCE_MIN_TILE_VALUE);
+
+        if (change > max_change) {
+            max_change = change;
+        }
+    }
+
+    return max_change;
+}
+
+bool convergence_update(Convergence *convergence, const float *texture_data_gl, uint32_t width, uint32_t height,
+                        float current_time) {
+    if (!convergence->enabled || convergence->converged) {
+        return false;
+    }
+
+    if (convergence->has_previous && current_time - convergence->last_check_time < convergence->check_interval) {
+        return false;
+    }
+
+    take_snapshot(convergence, texture_data_gl, width, height);
+
+    if (convergence->has_previous) {
+        convergence->change = compare_snapshots(convergence);
+
+        if (convergence->change < convergence->threshold) {
+            convergence->stable_checks++;
+        } else {
+            convergence->stable_checks = 0;
+        }
+
+        convergence->converged = convergence->stable_checks >= convergence->required_checks;
+    }
+
+    float *swap                  = convergence->previous;
+    convergence->previous        = convergence->current;
+    convergence->current         = swap;
+    convergence->has_previous    = true;
+    convergence->last_check_time = current_time;
+
+    return convergence->converged;
+}
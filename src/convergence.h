@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef SRC_CONVERGENCE_H_
+#define SRC_CONVERGENCE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define CONVERGENCE_TILE_SIZE 16
+
+// Tiles darker than this are compared against this floor instead, so sparse background noise does not dominate the
+// relative change
+#define CONVERGENCE_MIN_TILE_VALUE 0.01f
+
+typedef struct {
+    bool     enabled;
+    float    threshold;       // Maximum relative change of any tile between two snapshots
+    uint32_t required_checks; // Consecutive snapshots below the threshold needed to declare convergence
+    float    check_interval;  // Seconds between snapshots
+
+    uint32_t tiles_x;
+    uint32_t tiles_y;
+    float   *previous;
+    float   *current;
+    bool     has_previous;
+
+    float    last_check_time;
+    float    change;
+    uint32_t stable_checks;
+    bool     converged;
+} Convergence;
+
+void convergence_init(Convergence *convergence, uint32_t width, uint32_t height);
+void convergence_destroy(Convergence *convergence);
+void convergence_reset(Convergence *convergence);
+
+// Takes a snapshot of the normalized RGBA image if the check interval has elapsed. Returns true only on the call that
+// detects convergence.
+bool convergence_update(Convergence *convergence, const float *texture_data_gl, uint32_t width, uint32_t height,
+                        float current_time);
+
+#endif // SRC_CONVERGENCE_H_
@@ -0,0 +1,516 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "chaos.h"
+#include "custom.h"
+
+#define CUSTOM_LANES ATTRACTOR_MAX_ORBITS
+// Loop over the lanes for the interpreter. Left alone, GCC unrolls such short loops completely before the vectorizer
+// sees them, and the unrolled code calls the scalar sinf and cosf once per lane instead of their libmvec versions.
+#define FOR_EACH_LANE _Pragma("GCC unroll 1") for (uint32_t l = 0; l < CUSTOM_LANES; l++)
+// Steps an orbit takes after starting over before it is drawn, so it is on the attractor first
+#define CUSTOM_FUSE 20
+// Same test as the flows, see FLOW_DIVERGED_EXPONENT. It also catches the NaNs of a formula leaving its domain.
+#define CUSTOM_DIVERGED_EXPONENT (127 + 20)
+// Like the frame of the maps, see measure_map_frame, with every lane measuring an orbit of its own
+#define CUSTOM_FRAME_BURN_IN    1024
+#define CUSTOM_FRAME_ITERATIONS 2048
+#define CUSTOM_FRAME_MARGIN     0.05f
+#define CUSTOM_FRAME_FALLBACK   2.0f
+// Seeds the orbits the frame is measured from, so every worker measures the same frame
+#define CUSTOM_FRAME_SEED 0x9e3779b9u
+
+// One row per register, one column per orbit
+typedef float CustomRegisters[EXPRESSION_MAX_REGISTERS][CUSTOM_LANES];
+
+typedef struct {
+    uint32_t rng[CUSTOM_LANES];
+    uint32_t fuse[CUSTOM_LANES]; // Steps left before the orbit is drawn
+} CustomLanes;
+
+// Private copy of the shared formula, and its program compiled for the parameters of the attractor
+typedef struct {
+    Expression        expression;
+    uint32_t          generation;
+    ExpressionProgram program;
+    float             program_parameters[EXPRESSION_NUM_PARAMETERS];
+    bool              program_valid;
+} CustomKernel;
+
+static pthread_mutex_t formula_lock = PTHREAD_MUTEX_INITIALIZER;
+static Expression      formula;
+static uint32_t        formula_generation; // Bumped by every new formula. 0 until the default one is parsed.
+
+static inline uint32_t has_diverged(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    return ((bits >> 23) & 0xff) >= CUSTOM_DIVERGED_EXPONENT;
+}
+
+// xorshift32 per lane, which vectorizes where pcg32's 64 bit multiply would not
+static inline uint32_t next_random(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+
+    return x;
+}
+
+// Uniform in [0, 1), from the top 24 bits
+static inline float to_unit(uint32_t bits) { return (bits >> 8) * (1.0f / (1 << 24)); }
+
+// Called with formula_lock held
+static void load_default_formula(void) {
+    if (formula_generation > 0) {
+        return;
+    }
+
+    char error[128];
+    if (!expression_parse(CUSTOM_DEFAULT_FORMULA, &formula, error, sizeof(error))) {
+        fprintf(stderr, "default custom formula: %s\n", error);
+        abort();
+    }
+    formula_generation = 1;
+}
+
+void custom_set_expression(const Expression *expression) {
+    pthread_mutex_lock(&formula_lock);
+    formula            = *expression;
+    formula_generation = formula_generation > 0 ? formula_generation + 1 : 2;
+    pthread_mutex_unlock(&formula_lock);
+}
+
+void custom_get_expression(Expression *expression) {
+    pthread_mutex_lock(&formula_lock);
+    load_default_formula();
+    *expression = formula;
+    pthread_mutex_unlock(&formula_lock);
+}
+
+// Picks up a new formula, which invalidates the frame and the orbits since they belong to the old one, and compiles
+// the program again when the parameters changed
+static CustomKernel *update_kernel(Attractor *attractor) {
+    CustomKernel *kernel = attractor->kernel_data;
+
+    if (kernel == NULL) {
+        kernel                 = calloc(1, sizeof(CustomKernel));
+        attractor->kernel_data = kernel;
+    }
+
+    pthread_mutex_lock(&formula_lock);
+    load_default_formula();
+    if (kernel->generation != formula_generation) {
+        kernel->expression     = formula;
+        kernel->generation     = formula_generation;
+        kernel->program_valid  = false;
+        attractor->frame_valid = false;
+        invalidate_orbit(attractor);
+    }
+    pthread_mutex_unlock(&formula_lock);
+
+    size_t parameters_size = EXPRESSION_NUM_PARAMETERS * sizeof(float);
+
+    if (!kernel->program_valid || memcmp(kernel->program_parameters, attractor->parameters, parameters_size) != 0) {
+        expression_compile(&kernel->expression, attractor->parameters, &kernel->program);
+        memcpy(kernel->program_parameters, attractor->parameters, parameters_size);
+        kernel->program_valid = true;
+    }
+
+    return kernel;
+}
+
+static void load_constants(const ExpressionProgram *program, CustomRegisters registers) {
+    for (uint32_t i = 0; i < program->num_constants; i++) {
+        float *target = registers[program->constant_registers[i]];
+
+        for (uint32_t l = 0; l < CUSTOM_LANES; l++) {
+            target[l] = program->constant_values[i];
+        }
+    }
+}
+
+// The interpreter. Every instruction is a loop over the lanes, which the compiler turns into a few vector operations,
+// libmvec calls for the transcendental functions, so the dispatch is paid once per instruction for all the orbits
+// rather than once per orbit. Registers are written once, so target never aliases a or b.
+static void run_program(const ExpressionProgram *program, CustomRegisters registers) {
+    for (uint32_t i = 0; i < program->length; i++) {
+        const ExpressionInstruction *instruction = &program->code[i];
+
+        float *restrict       target = registers[instruction->target];
+        const float *restrict a      = registers[instruction->a];
+        const float *restrict b      = registers[instruction->b];
+
+        switch (instruction->op) {
+            case EXPRESSION_OP_ADD:
+                FOR_EACH_LANE target[l] = a[l] + b[l];
+                break;
+            case EXPRESSION_OP_SUB:
+                FOR_EACH_LANE target[l] = a[l] - b[l];
+                break;
+            case EXPRESSION_OP_MUL:
+                FOR_EACH_LANE target[l] = a[l] * b[l];
+                break;
+            case EXPRESSION_OP_DIV:
+                FOR_EACH_LANE target[l] = a[l] / b[l];
+                break;
+            case EXPRESSION_OP_POW:
+                FOR_EACH_LANE target[l] = powf(a[l], b[l]);
+                break;
+            case EXPRESSION_OP_MIN:
+                FOR_EACH_LANE target[l] = fminf(a[l], b[l]);
+                break;
+            case EXPRESSION_OP_MAX:
+                FOR_EACH_LANE target[l] = fmaxf(a[l], b[l]);
+                break;
+            case EXPRESSION_OP_ATAN2:
+                FOR_EACH_LANE target[l] = atan2f(a[l], b[l]);
+                break;
+            case EXPRESSION_OP_NEG:
+                FOR_EACH_LANE target[l] = -a[l];
+                break;
+            case EXPRESSION_OP_ABS:
+                FOR_EACH_LANE target[l] = fabsf(a[l]);
+                break;
+            case EXPRESSION_OP_SIGN:
+                FOR_EACH_LANE target[l] = (float)(a[l] > 0) - (float)(a[l] < 0);
+                break;
+            case EXPRESSION_OP_FLOOR:
+                FOR_EACH_LANE target[l] = floorf(a[l]);
+                break;
+            case EXPRESSION_OP_SQRT:
+                FOR_EACH_LANE target[l] = sqrtf(a[l]);
+                break;
+            case EXPRESSION_OP_EXP:
+                FOR_EACH_LANE target[l] = expf(a[l]);
+                break;
+            case EXPRESSION_OP_LOG:
+                FOR_EACH_LANE target[l] = logf(a[l]);
+                break;
+            case EXPRESSION_OP_SIN:
+                FOR_EACH_LANE target[l] = sinf(a[l]);
+                break;
+            case EXPRESSION_OP_COS:
+                FOR_EACH_LANE target[l] = cosf(a[l]);
+                break;
+            case EXPRESSION_OP_TAN:
+                FOR_EACH_LANE target[l] = tanf(a[l]);
+                break;
+            case EXPRESSION_OP_ATAN:
+                FOR_EACH_LANE target[l] = atanf(a[l]);
+                break;
+            case EXPRESSION_OP_TANH:
+                FOR_EACH_LANE target[l] = tanhf(a[l]);
+                break;
+            default: break;
+        }
+    }
+}
+
+// Moves the orbits to the image the program left in its outputs. Orbits that diverged start over from a random point.
+static void custom_step(const ExpressionProgram *program, CustomRegisters registers, CustomLanes *lanes) {
+    run_program(program, registers);
+
+    const float *next_x = registers[program->outputs[EXPRESSION_REGISTER_X]];
+    const float *next_y = registers[program->outputs[EXPRESSION_REGISTER_Y]];
+    float       *x      = registers[EXPRESSION_REGISTER_X];
+    float       *y      = registers[EXPRESSION_REGISTER_Y];
+
+    for (uint32_t l = 0; l < CUSTOM_LANES; l++) {
+        float    image_x   = next_x[l];
+        float    image_y   = next_y[l];
+        uint32_t diverged  = has_diverged(image_x) | has_diverged(image_y);
+        float    restart_x = to_unit(next_random(&lanes->rng[l])) * 2 - 1;
+        float    restart_y = to_unit(next_random(&lanes->rng[l])) * 2 - 1;
+
+        x[l]           = diverged ? restart_x : image_x;
+        y[l]           = diverged ? restart_y : image_y;
+        lanes->fuse[l] = diverged ? CUSTOM_FUSE : (lanes->fuse[l] > 0 ? lanes->fuse[l] - 1 : 0);
+    }
+}
+
+static void seed_lanes(CustomLanes *lanes, CustomRegisters registers, uint32_t seed) {
+    for (uint32_t l = 0; l < CUSTOM_LANES; l++) {
+        lanes->rng[l] = (seed + l * 0x6d2b79f5u) | 1;
+        next_random(&lanes->rng[l]);
+
+        registers[EXPRESSION_REGISTER_X][l] = to_unit(next_random(&lanes->rng[l])) * 2 - 1;
+        registers[EXPRESSION_REGISTER_Y][l] = to_unit(next_random(&lanes->rng[l])) * 2 - 1;
+        lanes->fuse[l]                      = CUSTOM_FUSE;
+    }
+}
+
+// Measured like the frame of the maps, see measure_map_frame, from one orbit per lane. Orbits that diverge or collapse
+// are left out instead of restarted.
+static void measure_custom_frame(Attractor *attractor, const ExpressionProgram *program) {
+    CustomRegisters registers;
+    CustomLanes     lanes;
+    float           lane_min[2][CUSTOM_LANES], lane_max[2][CUSTOM_LANES];
+    uint32_t        bounded[CUSTOM_LANES];
+
+    load_constants(program, registers);
+    seed_lanes(&lanes, registers, CUSTOM_FRAME_SEED);
+
+    const float *next_x = registers[program->outputs[EXPRESSION_REGISTER_X]];
+    const float *next_y = registers[program->outputs[EXPRESSION_REGISTER_Y]];
+    float       *x      = registers[EXPRESSION_REGISTER_X];
+    float       *y      = registers[EXPRESSION_REGISTER_Y];
+
+    for (uint32_t l = 0; l < CUSTOM_LANES; l++) {
+        bounded[l] = 1;
+    }
+
+    for (uint32_t i = 0; i < CUSTOM_FRAME_BURN_IN + CUSTOM_FRAME_ITERATIONS; i++) {
+        run_program(program, registers);
+
+        for (uint32_t l = 0; l < CUSTOM_LANES; l++) {
+            float image_x = next_x[l];
+            float image_y = next_y[l];
+
+            bounded[l] &= !(has_diverged(image_x) | has_diverged(image_y));
+            x[l] = bounded[l] ? image_x : 0;
+            y[l] = bounded[l] ? image_y : 0;
+        }
+
+        if (i == CUSTOM_FRAME_BURN_IN) {
+            for (uint32_t l = 0; l < CUSTOM_LANES; l++) {
+                lane_min[0][l] = lane_max[0][l] = x[l];
+                lane_min[1][l] = lane_max[1][l] = y[l];
+            }
+        } else if (i > CUSTOM_FRAME_BURN_IN) {
+            for (uint32_t l = 0; l < CUSTOM_LANES; l++) {
+                lane_min[0][l] = fminf(lane_min[0][l], x[l]);
+                lane_max[0][l] = fmaxf(lane_max[0][l], x[l]);
+                lane_min[1][l] = fminf(lane_min[1][l], y[l]);
+                lane_max[1][l] = fmaxf(lane_max[1][l], y[l]);
+            }
+        }
+    }
+
+    float min[2] = {INFINITY, INFINITY};
+    float max[2] = {-INFINITY, -INFINITY};
+
+    for (uint32_t l = 0; l < CUSTOM_LANES; l++) {
+        // Orbits escaping to infinity would stretch the frame until the attractor is a single pixel, and so would a
+        // far away fixed point or cycle coexisting with the attractor
+        bool collapsed = lane_max[0][l] - lane_min[0][l] <= CHAOS_MIN_EXTENT &&
+                         lane_max[1][l] - lane_min[1][l] <= CHAOS_MIN_EXTENT;
+
+        if (!bounded[l] || collapsed) {
+            continue;
+        }
+
+        for (uint32_t d = 0; d < 2; d++) {
+            min[d] = fminf(min[d], lane_min[d][l]);
+            max[d] = fmaxf(max[d], lane_max[d][l]);
+        }
+    }
+
+    for (uint32_t d = 0; d < 2; d++) {
+        float extent = max[d] - min[d];
+
+        if (!(extent > CHAOS_MIN_EXTENT)) {
+            min[d] = -CUSTOM_FRAME_FALLBACK;
+            max[d] = CUSTOM_FRAME_FALLBACK;
+            extent = max[d] - min[d];
+        }
+
+        attractor->frame_min[d] = min[d] - extent * CUSTOM_FRAME_MARGIN;
+        attractor->frame_max[d] = max[d] + extent * CUSTOM_FRAME_MARGIN;
+    }
+
+    memcpy(attractor->frame_parameters, attractor->parameters, attractor->num_parameters * sizeof(float));
+    attractor->frame_valid = true;
+}
+
+static void update_custom_frame(Attractor *attractor, const ExpressionProgram *program) {
+    if (attractor->frame_valid &&
+        memcmp(attractor->frame_parameters, attractor->parameters, attractor->num_parameters * sizeof(float)) == 0) {
+        return;
+    }
+
+    measure_custom_frame(attractor, program);
+}
+
+void destroy_custom(Attractor *attractor) {
+    free(attractor->kernel_data);
+    attractor->kernel_data = NULL;
+}
+
+// Continues the orbits in orbit_lanes, one per lane, and counts every point on the density map like the flames do
+void iterate_custom(Attractor *attractor, uint32_t num_iterations) {
+    const CustomKernel      *kernel  = update_kernel(attractor);
+    const ExpressionProgram *program = &kernel->program;
+    CustomRegisters          registers;
+    CustomLanes              lanes;
+
+    update_custom_frame(attractor, program);
+    load_constants(program, registers);
+    seed_lanes(&lanes, registers, pcg32_random_r(&attractor->rng));
+
+    float *x = registers[EXPRESSION_REGISTER_X];
+    float *y = registers[EXPRESSION_REGISTER_Y];
+
+    if (attractor->orbit_valid) {
+        for (uint32_t l = 0; l < CUSTOM_LANES; l++) {
+            x[l]          = attractor->orbit_lanes[0][l];
+            y[l]          = attractor->orbit_lanes[1][l];
+            lanes.fuse[l] = 0;
+        }
+    }
+    attractor->orbit_valid = true;
+
+    for (uint32_t i = 0; i < attractor->burn_in; i++) {
+        custom_step(program, registers, &lanes);
+    }
+    attractor->burn_in = 0;
+
+    const uint32_t width   = get_attractor_map_width(attractor);
+    const uint32_t height  = get_attractor_map_height(attractor);
+    const float    min_x   = attractor->frame_min[0];
+    const float    min_y   = attractor->frame_min[1];
+    const float    scale_x = width / (attractor->frame_max[0] - min_x);
+    const float    scale_y = height / (attractor->frame_max[1] - min_y);
+    const uint32_t steps   = (num_iterations + CUSTOM_LANES - 1) / CUSTOM_LANES;
+
+    uint32_t *density_map = attractor->density_map;
+
+    for (uint32_t i = 0; i < steps; i++) {
+        uint32_t cell[CUSTOM_LANES], hit[CUSTOM_LANES];
+
+        // The last step may have more lanes than samples left, the extra lanes advance but do not deposit
+        uint32_t remaining = num_iterations - i * CUSTOM_LANES;
+
+        custom_step(program, registers, &lanes);
+
+        for (uint32_t l = 0; l < CUSTOM_LANES; l++) {
+            float pixel_x = (x[l] - min_x) * scale_x;
+            float pixel_y = (y[l] - min_y) * scale_y;
+
+            uint32_t inside = (lanes.fuse[l] == 0) & (pixel_x >= 0) & (pixel_x < width) & (pixel_y >= 0) &
+                              (pixel_y < height);
+            uint32_t column = inside ? (uint32_t)pixel_x : 0;
+            uint32_t row    = inside ? (uint32_t)pixel_y : 0;
+
+            cell[l] = column + row * width;
+            hit[l]  = inside & (l < remaining);
+        }
+
+        for (uint32_t l = 0; l < CUSTOM_LANES; l++) {
+            density_map[cell[l]] += hit[l];
+        }
+    }
+
+    for (uint32_t l = 0; l < CUSTOM_LANES; l++) {
+        attractor->orbit_lanes[0][l] = x[l];
+        attractor->orbit_lanes[1][l] = y[l];
+    }
+}
+
+// Lane 0 carries the orbit and the other lanes its shadow, so the shadow orbit needed for the Lyapunov exponent comes
+// with the same run of the interpreter
+void probe_custom(Attractor *attractor, uint32_t num_iterations, ChaosProbe *probe) {
+    const CustomKernel      *kernel  = update_kernel(attractor);
+    const ExpressionProgram *program = &kernel->program;
+    CustomRegisters          registers;
+
+    float state[2] = {attractor_random(attractor) * 2 - 1, attractor_random(attractor) * 2 - 1};
+    float shadow[2];
+
+    CycleDetector     cycle;
+    LyapunovEstimator lyapunov;
+    cycle_detector_init(&cycle, state, 2);
+    lyapunov_init(&lyapunov, state, shadow, 2);
+    chaos_probe_init(probe);
+
+    load_constants(program, registers);
+
+    const float *next_x = registers[program->outputs[EXPRESSION_REGISTER_X]];
+    const float *next_y = registers[program->outputs[EXPRESSION_REGISTER_Y]];
+
+    for (uint32_t i = 0; i < num_iterations; i++) {
+        for (uint32_t l = 0; l < CUSTOM_LANES; l++) {
+            registers[EXPRESSION_REGISTER_X][l] = l == 0 ? state[0] : shadow[0];
+            registers[EXPRESSION_REGISTER_Y][l] = l == 0 ? state[1] : shadow[1];
+        }
+
+        run_program(program, registers);
+
+        state[0]  = next_x[0];
+        state[1]  = next_y[0];
+        shadow[0] = next_x[1];
+        shadow[1] = next_y[1];
+
+        if (chaos_probe_update(probe, &cycle, state)) {
+            break;
+        }
+
+        lyapunov_update(&lyapunov, state, shadow, i >= CHAOS_PROBE_WARMUP);
+    }
+
+    chaos_probe_finish(probe, &lyapunov);
+}
+
+// Compiles the current formula on every call, since there is no attractor to keep the program in. That takes far
+// less than the iterations it is called for.
+void advance_custom(const float *parameters, float *state, uint32_t num_iterations, float *points) {
+    Expression        expression;
+    ExpressionProgram program;
+    CustomRegisters   registers;
+
+    custom_get_expression(&expression);
+    expression_compile(&expression, parameters, &program);
+    load_constants(&program, registers);
+
+    const float *next_x = registers[program.outputs[EXPRESSION_REGISTER_X]];
+    const float *next_y = registers[program.outputs[EXPRESSION_REGISTER_Y]];
+
+    for (uint32_t l = 0; l < CUSTOM_LANES; l++) {
+        registers[EXPRESSION_REGISTER_X][l] = state[0];
+        registers[EXPRESSION_REGISTER_Y][l] = state[1];
+    }
+
+    for (uint32_t i = 0; i < num_iterations; i++) {
+        run_program(&program, registers);
+
+        float x = next_x[0];
+        float y = next_y[0];
+
+        for (uint32_t l = 0; l < CUSTOM_LANES; l++) {
+            registers[EXPRESSION_REGISTER_X][l] = x;
+            registers[EXPRESSION_REGISTER_Y][l] = y;
+        }
+
+        if (points != NULL) {
+            points[i * ATTRACTOR_ORBIT_DIMENSIONS + 0] = x;
+            points[i * ATTRACTOR_ORBIT_DIMENSIONS + 1] = y;
+            points[i * ATTRACTOR_ORBIT_DIMENSIONS + 2] = 0;
+        }
+    }
+
+    state[0] = registers[EXPRESSION_REGISTER_X][0];
+    state[1] = registers[EXPRESSION_REGISTER_Y][0];
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef SRC_CUSTOM_H_
+#define SRC_CUSTOM_H_
+
+#include <stdint.h>
+
+#include "attractor.h"
+#include "expression.h"
+
+// The formula custom attractors start with, which draws the same attractors as Clifford
+#define CUSTOM_DEFAULT_FORMULA "x' = sin(a*y) + c*cos(a*x)\ny' = sin(b*x) + d*cos(b*y)\n"
+
+// The formula is shared by every custom attractor, in every thread. Each attractor picks up a new one on its next
+// call, and starts its orbits over.
+void custom_set_expression(const Expression *expression);
+void custom_get_expression(Expression *expression);
+
+void destroy_custom(Attractor *attractor);
+void iterate_custom(Attractor *attractor, uint32_t num_iterations);
+void probe_custom(Attractor *attractor, uint32_t num_iterations, ChaosProbe *probe);
+void advance_custom(const float *parameters, float *state, uint32_t num_iterations, float *points);
+
+#endif // SRC_CUSTOM_H_
@@ -0,0 +1,433 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+// Built with the SIMD flags. Every lane runs the same branch free step, and lanes that are done only stop changing,
+// so the loops over lanes vectorize, with gathers for the reference orbit of perturbed pixels.
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "escape_time.h"
+
+#define ESCAPE_TIME_BAILOUT_SQUARED (ESCAPE_BAILOUT * ESCAPE_BAILOUT)
+
+// Counts a pixel whose orbit escaped to z after steps steps, or 0 if it did not. The smooth count
+// steps + 1 - log2(ln|z| / ln(bailout)) is continuous across the bands of the plain count.
+static uint32_t get_smooth_count(uint32_t steps, double x, double y) {
+    double magnitude = x * x + y * y;
+
+    if (!(magnitude > ESCAPE_TIME_BAILOUT_SQUARED)) {
+        return 0;
+    }
+
+    double smooth = steps + 1 - log2(0.5 * log(magnitude) / log(ESCAPE_BAILOUT));
+
+    return 1 + (uint32_t)(fmax(smooth, 0) * ESCAPE_TIME_COUNT_SCALE);
+}
+
+// Iterates ESCAPE_TIME_DIRECT_LANES pixels in single precision. The pixel is the starting point of Julia sets, and c
+// for the Mandelbrot set, which starts from 0.
+static void iterate_direct(const EscapeRender *render, const float *pixel_x, const float *pixel_y, uint32_t *counts) {
+    float    x[ESCAPE_TIME_DIRECT_LANES];
+    float    y[ESCAPE_TIME_DIRECT_LANES];
+    float    c_x[ESCAPE_TIME_DIRECT_LANES];
+    float    c_y[ESCAPE_TIME_DIRECT_LANES];
+    uint32_t steps[ESCAPE_TIME_DIRECT_LANES];
+
+    const float    bailout        = ESCAPE_TIME_BAILOUT_SQUARED;
+    const uint32_t max_iterations = render->max_iterations;
+
+    for (uint32_t l = 0; l < ESCAPE_TIME_DIRECT_LANES; l++) {
+        x[l]     = render->julia ? pixel_x[l] : 0;
+        y[l]     = render->julia ? pixel_y[l] : 0;
+        c_x[l]   = render->julia ? render->julia_c[0] : pixel_x[l];
+        c_y[l]   = render->julia ? render->julia_c[1] : pixel_y[l];
+        steps[l] = 0;
+    }
+
+    for (uint32_t i = 0; i < max_iterations; i += ESCAPE_TIME_BLOCK) {
+        for (uint32_t b = 0; b < ESCAPE_TIME_BLOCK; b++) {
+            for (uint32_t l = 0; l < ESCAPE_TIME_DIRECT_LANES; l++) {
+                float xx     = x[l] * x[l];
+                float yy     = y[l] * y[l];
+                bool  active = (xx + yy <= bailout) & (steps[l] < max_iterations);
+                float next_x = xx - yy + c_x[l];
+                float next_y = 2 * x[l] * y[l] + c_y[l];
+
+                x[l] = active ? next_x : x[l];
+                y[l] = active ? next_y : y[l];
+                steps[l] += active;
+            }
+        }
+
+        bool any_active = false;
+
+        for (uint32_t l = 0; l < ESCAPE_TIME_DIRECT_LANES; l++) {
+            any_active |= (x[l] * x[l] + y[l] * y[l] <= bailout) & (steps[l] < max_iterations);
+        }
+
+        if (!any_active) {
+            break;
+        }
+    }
+
+    for (uint32_t l = 0; l < ESCAPE_TIME_DIRECT_LANES; l++) {
+        counts[l] = get_smooth_count(steps[l], x[l], y[l]);
+    }
+}
+
+// Iterates ESCAPE_TIME_PERTURBED_LANES pixels offset from the center of the view as differences delta from the
+// reference orbit Z, with delta -> 2 Z delta + delta^2 + offset for the Mandelbrot set, and without the offset for
+// Julia sets. They start where the series approximation leaves off. A pixel that comes closer to the origin than its
+// delta is, or that reaches the end of the reference, is rebased: the same point becomes a difference from the start
+// of the reference instead, so delta never dwarfs the pixel it stands for.
+static void iterate_perturbed(const EscapeRender *render, const double *offset_x, const double *offset_y,
+                              uint32_t *counts) {
+    double   delta_x[ESCAPE_TIME_PERTURBED_LANES];
+    double   delta_y[ESCAPE_TIME_PERTURBED_LANES];
+    double   c_x[ESCAPE_TIME_PERTURBED_LANES];
+    double   c_y[ESCAPE_TIME_PERTURBED_LANES];
+    uint32_t index[ESCAPE_TIME_PERTURBED_LANES]; // Of the reference point the pixel is next to
+    uint32_t steps[ESCAPE_TIME_PERTURBED_LANES];
+    uint32_t active[ESCAPE_TIME_PERTURBED_LANES]; // Took the last step. As wide as the index, or the step stays scalar.
+
+    const EscapeReference *reference      = &render->reference;
+    const EscapeSeries    *series         = &reference->series;
+    const double          *reference_x    = reference->x;
+    const double          *reference_y    = reference->y;
+    const double           start_x        = reference->x[0];
+    const double           start_y        = reference->y[0];
+    const uint32_t         last           = reference->length - 1;
+    const uint32_t         max_iterations = render->max_iterations;
+    const double           bailout        = ESCAPE_TIME_BAILOUT_SQUARED;
+
+    for (uint32_t l = 0; l < ESCAPE_TIME_PERTURBED_LANES; l++) {
+        double d_x  = offset_x[l];
+        double d_y  = offset_y[l];
+        double d2_x = d_x * d_x - d_y * d_y;
+        double d2_y = 2 * d_x * d_y;
+        double d3_x = d2_x * d_x - d2_y * d_y;
+        double d3_y = d2_x * d_y + d2_y * d_x;
+
+        delta_x[l] = series->a[0] * d_x - series->a[1] * d_y + series->b[0] * d2_x - series->b[1] * d2_y +
+                     series->c[0] * d3_x - series->c[1] * d3_y;
+        delta_y[l] = series->a[0] * d_y + series->a[1] * d_x + series->b[0] * d2_y + series->b[1] * d2_x +
+                     series->c[0] * d3_y + series->c[1] * d3_x;
+        c_x[l]     = render->julia ? 0 : d_x;
+        c_y[l]     = render->julia ? 0 : d_y;
+        index[l]   = reference->skip;
+        steps[l]   = reference->skip;
+    }
+
+    for (uint32_t i = reference->skip; i < max_iterations; i += ESCAPE_TIME_BLOCK) {
+        for (uint32_t b = 0; b < ESCAPE_TIME_BLOCK; b++) {
+            for (uint32_t l = 0; l < ESCAPE_TIME_PERTURBED_LANES; l++) {
+                double z_x       = reference_x[index[l]];
+                double z_y       = reference_y[index[l]];
+                double x         = z_x + delta_x[l];
+                double y         = z_y + delta_y[l];
+                double magnitude = x * x + y * y;
+                bool   going     = (magnitude <= bailout) & (steps[l] < max_iterations);
+                bool   rebase    = (magnitude < delta_x[l] * delta_x[l] + delta_y[l] * delta_y[l]) | (index[l] == last);
+
+                double   d_x  = rebase ? x - start_x : delta_x[l];
+                double   d_y  = rebase ? y - start_y : delta_y[l];
+                double   r_x  = rebase ? start_x : z_x;
+                double   r_y  = rebase ? start_y : z_y;
+                uint32_t base = rebase ? 0 : index[l];
+
+                double next_x = 2 * (r_x * d_x - r_y * d_y) + d_x * d_x - d_y * d_y + c_x[l];
+                double next_y = 2 * (r_x * d_y + r_y * d_x) + 2 * d_x * d_y + c_y[l];
+
+                delta_x[l] = going ? next_x : delta_x[l];
+                delta_y[l] = going ? next_y : delta_y[l];
+                index[l]   = going ? base + 1 : index[l];
+                steps[l] += going;
+                active[l] = going;
+            }
+        }
+
+        // Lanes that took the last step may have escaped with it, and find out at the start of the next block.
+        // Checking here would take gathers of its own, which keep the step from vectorizing.
+        bool any_active = false;
+
+        for (uint32_t l = 0; l < ESCAPE_TIME_PERTURBED_LANES; l++) {
+            any_active |= active[l];
+        }
+
+        if (!any_active) {
+            break;
+        }
+    }
+
+    for (uint32_t l = 0; l < ESCAPE_TIME_PERTURBED_LANES; l++) {
+        counts[l] = get_smooth_count(steps[l], reference_x[index[l]] + delta_x[l], reference_y[index[l]] + delta_y[l]);
+    }
+}
+
+static void render_tile(EscapeRender *render, uint32_t tile) {
+    uint32_t counts[ESCAPE_TIME_DIRECT_LANES];
+    uint32_t tile_x = (tile % render->tiles_per_row) * ESCAPE_TIME_TILE_SIZE;
+    uint32_t tile_y = (tile / render->tiles_per_row) * ESCAPE_TIME_TILE_SIZE;
+    uint32_t lanes  = render->perturbed ? ESCAPE_TIME_PERTURBED_LANES : ESCAPE_TIME_DIRECT_LANES;
+
+    for (uint32_t y = tile_y; y < tile_y + ESCAPE_TIME_TILE_SIZE && y < render->height; y++) {
+        uint32_t *row      = render->counts + y * render->width;
+        double    offset_y = (y + 0.5 - render->height * 0.5) * render->spacing;
+
+        for (uint32_t x = tile_x; x < tile_x + ESCAPE_TIME_TILE_SIZE && x < render->width; x += lanes) {
+            if (render->perturbed) {
+                double offsets_x[ESCAPE_TIME_PERTURBED_LANES];
+                double offsets_y[ESCAPE_TIME_PERTURBED_LANES];
+
+                for (uint32_t l = 0; l < ESCAPE_TIME_PERTURBED_LANES; l++) {
+                    offsets_x[l] = (x + l + 0.5 - render->width * 0.5) * render->spacing;
+                    offsets_y[l] = offset_y;
+                }
+
+                iterate_perturbed(render, offsets_x, offsets_y, counts);
+            } else {
+                float pixels_x[ESCAPE_TIME_DIRECT_LANES];
+                float pixels_y[ESCAPE_TIME_DIRECT_LANES];
+
+                for (uint32_t l = 0; l < ESCAPE_TIME_DIRECT_LANES; l++) {
+                    pixels_x[l] = render->center[0] + (x + l + 0.5 - render->width * 0.5) * render->spacing;
+                    pixels_y[l] = render->center[1] + offset_y;
+                }
+
+                iterate_direct(render, pixels_x, pixels_y, counts);
+            }
+
+            // Lanes past the edge of the map were iterated all the same, and are dropped here
+            for (uint32_t l = 0; l < lanes && x + l < render->width; l++) {
+                __atomic_store_n(&row[x + l], counts[l], __ATOMIC_RELAXED);
+            }
+        }
+    }
+}
+
+static int compare_keys(const void *a, const void *b) {
+    uint64_t key_a = *(const uint64_t *)a;
+    uint64_t key_b = *(const uint64_t *)b;
+
+    return (key_a > key_b) - (key_a < key_b);
+}
+
+// Orders the tiles by their distance from the center of the map, which is where the eye goes first
+static void sort_tiles(EscapeRender *render) {
+    uint32_t  tiles_per_column = render->num_tiles / render->tiles_per_row;
+    uint64_t *keys             = malloc(render->num_tiles * sizeof(uint64_t));
+
+    for (uint32_t i = 0; i < render->num_tiles; i++) {
+        // Twice the distance from the center in tiles, so it stays an integer
+        int64_t  dx       = 2 * (int64_t)(i % render->tiles_per_row) + 1 - render->tiles_per_row;
+        int64_t  dy       = 2 * (int64_t)(i / render->tiles_per_row) + 1 - tiles_per_column;
+        uint64_t distance = dx * dx + dy * dy;
+
+        keys[i] = distance << 32 | i;
+    }
+
+    qsort(keys, render->num_tiles, sizeof(uint64_t), compare_keys);
+
+    for (uint32_t i = 0; i < render->num_tiles; i++) {
+        render->order[i] = (uint32_t)keys[i];
+    }
+
+    free(keys);
+}
+
+// The workers must not be running ticks of the render. The reference orbit of deep views is iterated here, before the
+// first tick.
+void escape_render_start(EscapeRender *render, const EscapeView *view, const Attractor *attractor) {
+    render->julia          = attractor->type == ATTRACTOR_TYPE_JULIA;
+    render->julia_c[0]     = render->julia ? attractor->parameters[JULIA_C_X] : 0;
+    render->julia_c[1]     = render->julia ? attractor->parameters[JULIA_C_Y] : 0;
+    render->max_iterations = (uint32_t)attractor->parameters[attractor->num_parameters - 1];
+    render->spacing        = view->spacing * attractor->downsample;
+    render->perturbed      = render->spacing < ESCAPE_TIME_DIRECT_MIN_SPACING;
+    render->width          = get_attractor_map_width(attractor);
+    render->height         = get_attractor_map_height(attractor);
+
+    escape_view_get_center(view, &render->center[0], &render->center[1]);
+
+    if (render->perturbed) {
+        double extent[2] = {render->width * 0.5 * render->spacing, render->height * 0.5 * render->spacing};
+
+        escape_reference_compute(&render->reference, view, render->julia ? render->julia_c : NULL,
+                                 render->max_iterations, render->spacing, extent);
+    }
+
+    uint32_t num_pixels = render->width * render->height;
+
+    if (render->pixel_capacity < num_pixels) {
+        render->pixel_capacity = num_pixels;
+        render->counts         = realloc(render->counts, num_pixels * sizeof(uint32_t));
+    }
+
+    for (uint32_t i = 0; i < num_pixels; i++) {
+        render->counts[i] = ESCAPE_TIME_PENDING;
+    }
+
+    uint32_t tiles_per_column = (render->height + ESCAPE_TIME_TILE_SIZE - 1) / ESCAPE_TIME_TILE_SIZE;
+
+    render->tiles_per_row = (render->width + ESCAPE_TIME_TILE_SIZE - 1) / ESCAPE_TIME_TILE_SIZE;
+    render->num_tiles     = render->tiles_per_row * tiles_per_column;
+
+    if (render->tile_capacity < render->num_tiles) {
+        render->tile_capacity = render->num_tiles;
+        render->order         = realloc(render->order, render->num_tiles * sizeof(uint32_t));
+    }
+
+    sort_tiles(render);
+
+    render->next      = 0;
+    render->completed = 0;
+}
+
+void escape_render_tick(void *data) {
+    EscapeRender *render = data;
+    uint32_t      next   = __atomic_fetch_add(&render->next, 1, __ATOMIC_RELAXED);
+
+    if (next >= render->num_tiles) {
+        // Nothing left to claim, wait for the view to change
+        struct timespec ts = {0, 1000000};
+        nanosleep(&ts, NULL);
+        return;
+    }
+
+    render_tile(render, render->order[next]);
+
+    __atomic_fetch_add(&render->completed, 1, __ATOMIC_RELEASE);
+}
+
+bool escape_render_is_done(EscapeRender *render) {
+    return __atomic_load_n(&render->completed, __ATOMIC_ACQUIRE) == render->num_tiles;
+}
+
+// Writes the pixels rendered so far into a density map of the size of the render, and leaves the others empty. Counts
+// are taken from the lowest one in the image, so zooming in keeps the colors spread over the orbits actually seen.
+void escape_render_resolve(EscapeRender *render, uint32_t *density_map) {
+    uint32_t num_pixels = render->width * render->height;
+    uint32_t lowest     = ESCAPE_TIME_PENDING;
+
+    for (uint32_t i = 0; i < num_pixels; i++) {
+        uint32_t count = __atomic_load_n(&render->counts[i], __ATOMIC_RELAXED);
+
+        if (count != 0 && count < lowest) {
+            lowest = count;
+        }
+    }
+
+    for (uint32_t i = 0; i < num_pixels; i++) {
+        uint32_t count = __atomic_load_n(&render->counts[i], __ATOMIC_RELAXED);
+        bool     empty = count == 0 || count == ESCAPE_TIME_PENDING;
+
+        density_map[i] = empty ? 0 : count - lowest + (uint32_t)ESCAPE_TIME_COUNT_SCALE;
+    }
+}
+
+void escape_render_destroy(EscapeRender *render) {
+    escape_reference_destroy(&render->reference);
+    free(render->counts);
+    free(render->order);
+    render->counts         = NULL;
+    render->order          = NULL;
+    render->pixel_capacity = 0;
+    render->tile_capacity  = 0;
+    render->num_tiles      = 0;
+}
+
+// Whether the last render of the attractor is of the same image
+static bool is_render_current(const EscapeRender *render, const EscapeView *view, const Attractor *attractor) {
+    bool julia = attractor->type == ATTRACTOR_TYPE_JULIA;
+
+    return render->counts != NULL && render->julia == julia &&
+           (!julia || (render->julia_c[0] == attractor->parameters[JULIA_C_X] &&
+                       render->julia_c[1] == attractor->parameters[JULIA_C_Y])) &&
+           render->max_iterations == (uint32_t)attractor->parameters[attractor->num_parameters - 1] &&
+           render->spacing == view->spacing * attractor->downsample &&
+           render->width == get_attractor_map_width(attractor) && render->height == get_attractor_map_height(attractor);
+}
+
+// Renders the whole set into the density map at once, for thumbnails, searches and parameter maps. The number of
+// iterations is ignored, since the image is complete either way. The render is kept, so the same parameters only
+// resolve it again.
+void iterate_escape_time(Attractor *attractor, uint32_t num_iterations) {
+    EscapeRender *render = attractor->kernel_data;
+    EscapeView    view;
+
+    if (render == NULL) {
+        render                 = calloc(1, sizeof(EscapeRender));
+        attractor->kernel_data = render;
+    }
+
+    escape_view_reset(&view, attractor->type == ATTRACTOR_TYPE_JULIA, attractor->height);
+
+    if (!is_render_current(render, &view, attractor)) {
+        escape_render_start(render, &view, attractor);
+
+        for (uint32_t i = 0; i < render->num_tiles; i++) {
+            render_tile(render, i);
+        }
+
+        render->completed = render->num_tiles;
+    }
+
+    escape_render_resolve(render, attractor->density_map);
+}
+
+// Julia sets are connected for c in the Mandelbrot set, and dust for c far from it. Values of c inside or just outside
+// the set give the detailed ones, so c is drawn until its own orbit lasts a while.
+void randomize_julia(Attractor *attractor) {
+    float min[2], max[2];
+
+    get_attractor_parameter_range(attractor, JULIA_C_X, &min[0], &max[0]);
+    get_attractor_parameter_range(attractor, JULIA_C_Y, &min[1], &max[1]);
+
+    for (;;) {
+        float    c_x   = min[0] + attractor_random(attractor) * (max[0] - min[0]);
+        float    c_y   = min[1] + attractor_random(attractor) * (max[1] - min[1]);
+        float    x     = 0;
+        float    y     = 0;
+        uint32_t steps = 0;
+
+        for (; steps < ESCAPE_TIME_RANDOM_MIN_STEPS && x * x + y * y <= 4; steps++) {
+            float next_x = x * x - y * y + c_x;
+
+            y = 2 * x * y + c_y;
+            x = next_x;
+        }
+
+        if (steps == ESCAPE_TIME_RANDOM_MIN_STEPS) {
+            attractor->parameters[JULIA_C_X] = c_x;
+            attractor->parameters[JULIA_C_Y] = c_y;
+            return;
+        }
+    }
+}
+
+void destroy_escape_time(Attractor *attractor) {
+    if (attractor->kernel_data != NULL) {
+        escape_render_destroy(attractor->kernel_data);
+        free(attractor->kernel_data);
+        attractor->kernel_data = NULL;
+    }
+}
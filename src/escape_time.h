@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef SRC_ESCAPE_TIME_H_
+#define SRC_ESCAPE_TIME_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "attractor.h"
+#include "escape_view.h"
+
+// Work is handed out in tiles of this many pixels per side, from the center of the image out
+#define ESCAPE_TIME_TILE_SIZE 16
+// Pixels iterated side by side, one per SIMD lane, in single precision and as double precision differences from the
+// reference orbit
+#define ESCAPE_TIME_DIRECT_LANES    16
+#define ESCAPE_TIME_PERTURBED_LANES 16
+// Views with pixels closer than this are perturbed, since single precision can no longer tell them apart
+#define ESCAPE_TIME_DIRECT_MIN_SPACING 1e-5
+// Smooth iteration counts are fixed point, in steps of 1 / ESCAPE_TIME_COUNT_SCALE
+#define ESCAPE_TIME_COUNT_SCALE 256.0f
+// Count of the pixels not rendered yet
+#define ESCAPE_TIME_PENDING UINT32_MAX
+// Random values of c for Julia sets are kept once their own orbit lasts this many steps, see randomize_julia
+#define ESCAPE_TIME_RANDOM_MIN_STEPS 24
+// Steps every lane takes between checks for whether any of them is still going
+#define ESCAPE_TIME_BLOCK 8
+
+// Parameters of the Julia sets. The Mandelbrot set only has the iterations.
+typedef enum {
+    JULIA_C_X,
+    JULIA_C_Y,
+    JULIA_ITERATIONS,
+    JULIA_NUM_PARAMETERS,
+} JuliaParameter;
+
+// One image of the Mandelbrot set or of a Julia set, rendered by any number of workers. Shallow views iterate every
+// pixel in single precision. Deeper ones iterate the center of the view once at double double precision, and every
+// other pixel as a double precision difference from it, starting from the step the series approximation of the view
+// reaches. A pixel whose orbit comes closer to the origin than to the reference orbit, or outlives it, is rebased
+// onto the start of the reference, which takes care of the glitches perturbation is known for.
+typedef struct {
+    bool     julia;
+    float    julia_c[2];
+    uint32_t max_iterations;
+
+    bool            perturbed;
+    double          center[2]; // Rounded, for the single precision pixels
+    double          spacing;   // Between the pixels rendered, which are fewer than in the view while previewing
+    EscapeReference reference;
+
+    // Smooth iteration count of every pixel, written by the workers as they go and read by escape_render_resolve.
+    // Pixels inside the set count 0.
+    uint32_t *counts;
+    uint32_t  width;
+    uint32_t  height;
+    uint32_t  pixel_capacity;
+
+    uint32_t *order; // Tiles, nearest to the center first
+    uint32_t  tiles_per_row;
+    uint32_t  num_tiles;
+    uint32_t  tile_capacity;
+    uint32_t  next;      // Next tile to claim, as a position in order
+    uint32_t  completed; // Tiles done
+} EscapeRender;
+
+void escape_render_start(EscapeRender *render, const EscapeView *view, const Attractor *attractor);
+void escape_render_tick(void *data);
+bool escape_render_is_done(EscapeRender *render);
+void escape_render_resolve(EscapeRender *render, uint32_t *density_map);
+void escape_render_destroy(EscapeRender *render);
+
+void iterate_escape_time(Attractor *attractor, uint32_t num_iterations);
+void randomize_julia(Attractor *attractor);
+void destroy_escape_time(Attractor *attractor);
+
+#endif // SRC_ESCAPE_TIME_H_
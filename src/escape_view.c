@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "escape_view.h"
+
+// The corners of the view, which the series approximation is checked against
+#define ESCAPE_PROBES 4
+
+// Exact sum of two doubles, as the rounded sum and its error
+static DoubleDouble two_sum(double a, double b) {
+    double s = a + b;
+    double v = s - a;
+
+    return (DoubleDouble){s, (a - (s - v)) + (b - v)};
+}
+
+// Same, when |a| >= |b|
+static DoubleDouble quick_two_sum(double a, double b) {
+    double s = a + b;
+
+    return (DoubleDouble){s, b - (s - a)};
+}
+
+static DoubleDouble two_product(double a, double b) {
+    double p = a * b;
+
+    return (DoubleDouble){p, fma(a, b, -p)};
+}
+
+static DoubleDouble dd_add(DoubleDouble a, DoubleDouble b) {
+    DoubleDouble s = two_sum(a.hi, b.hi);
+    DoubleDouble t = two_sum(a.lo, b.lo);
+
+    s    = quick_two_sum(s.hi, s.lo + t.hi);
+    return quick_two_sum(s.hi, s.lo + t.lo);
+}
+
+static DoubleDouble dd_negate(DoubleDouble a) { return (DoubleDouble){-a.hi, -a.lo}; }
+
+static DoubleDouble dd_multiply(DoubleDouble a, DoubleDouble b) {
+    DoubleDouble p = two_product(a.hi, b.hi);
+
+    return quick_two_sum(p.hi, p.lo + (a.hi * b.lo + a.lo * b.hi));
+}
+
+DoubleDouble dd_from_double(double value) { return (DoubleDouble){value, 0}; }
+
+DoubleDouble dd_add_double(DoubleDouble a, double b) {
+    DoubleDouble s = two_sum(a.hi, b);
+
+    return quick_two_sum(s.hi, s.lo + a.lo);
+}
+
+double dd_to_double(DoubleDouble a) { return a.hi + a.lo; }
+
+// The whole Mandelbrot set, or the whole of a Julia set, across the height of a map of height pixels
+void escape_view_reset(EscapeView *view, bool julia, uint32_t height) {
+    view->center[0] = dd_from_double(julia ? 0.0 : -0.5);
+    view->center[1] = dd_from_double(0.0);
+    view->spacing   = (julia ? 3.2 : 2.8) / height;
+}
+
+// Moves the center by a distance on the plane
+void escape_view_pan(EscapeView *view, double delta_x, double delta_y) {
+    view->center[0] = dd_add_double(view->center[0], delta_x);
+    view->center[1] = dd_add_double(view->center[1], delta_y);
+}
+
+// Scales the distance between pixels by factor, keeping the point offset pixels away from the center in place
+void escape_view_zoom(EscapeView *view, double factor, double offset_x, double offset_y) {
+    double spacing = fmin(fmax(view->spacing * factor, ESCAPE_VIEW_MIN_SPACING), ESCAPE_VIEW_MAX_SPACING);
+
+    escape_view_pan(view, offset_x * (view->spacing - spacing), offset_y * (view->spacing - spacing));
+    view->spacing = spacing;
+}
+
+void escape_view_get_center(const EscapeView *view, double *x, double *y) {
+    *x = dd_to_double(view->center[0]);
+    *y = dd_to_double(view->center[1]);
+}
+
+// Advances the coefficients of delta_n = a d + b d^2 + c d^3 by one step taken next to the reference point z, where d
+// is the offset of the pixel, in c for the Mandelbrot set and in the starting point for Julia sets. Only the
+// Mandelbrot set adds the offset at every step.
+static void advance_series(EscapeSeries *series, const double *z, bool julia) {
+    const double *a = series->a, *b = series->b, *c = series->c;
+    EscapeSeries  next;
+
+    next.a[0] = 2 * (z[0] * a[0] - z[1] * a[1]) + (julia ? 0 : 1);
+    next.a[1] = 2 * (z[0] * a[1] + z[1] * a[0]);
+    next.b[0] = 2 * (z[0] * b[0] - z[1] * b[1]) + a[0] * a[0] - a[1] * a[1];
+    next.b[1] = 2 * (z[0] * b[1] + z[1] * b[0]) + 2 * a[0] * a[1];
+    next.c[0] = 2 * (z[0] * c[0] - z[1] * c[1]) + 2 * (a[0] * b[0] - a[1] * b[1]);
+    next.c[1] = 2 * (z[0] * c[1] + z[1] * c[0]) + 2 * (a[0] * b[1] + a[1] * b[0]);
+
+    *series = next;
+}
+
+// Whether the series still predicts the probe, whose offset is d and whose difference from the reference was
+// iterated to delta, to within ESCAPE_SERIES_TOLERANCE of the distance between its neighbouring pixels there
+static bool check_series(const EscapeSeries *series, const double *d, const double *delta, double spacing) {
+    const double *a = series->a, *b = series->b, *c = series->c;
+
+    double d2[2]     = {d[0] * d[0] - d[1] * d[1], 2 * d[0] * d[1]};
+    double d3[2]     = {d2[0] * d[0] - d2[1] * d[1], d2[0] * d[1] + d2[1] * d[0]};
+    double bd[2]     = {b[0] * d[0] - b[1] * d[1], b[0] * d[1] + b[1] * d[0]};
+    double cd2[2]    = {c[0] * d2[0] - c[1] * d2[1], c[0] * d2[1] + c[1] * d2[0]};
+    double guess[2]  = {a[0] * d[0] - a[1] * d[1] + b[0] * d2[0] - b[1] * d2[1] + c[0] * d3[0] - c[1] * d3[1],
+                        a[0] * d[1] + a[1] * d[0] + b[0] * d2[1] + b[1] * d2[0] + c[0] * d3[1] + c[1] * d3[0]};
+    double slope[2]  = {a[0] + 2 * bd[0] + 3 * cd2[0], a[1] + 2 * bd[1] + 3 * cd2[1]};
+    double error     = hypot(guess[0] - delta[0], guess[1] - delta[1]);
+    double tolerance = ESCAPE_SERIES_TOLERANCE * hypot(slope[0], slope[1]) * spacing;
+
+    return isfinite(error) && error <= tolerance;
+}
+
+// Iterates the center of the view, z -> z^2 + c with c the center for the Mandelbrot set or julia_c from the center
+// otherwise, until it escapes or max_iterations. The series approximation is carried along, checked against the
+// corners of the view, extent away from the center, which are iterated as differences from the reference like any
+// pixel. Steps are skipped for as long as it predicts all of them.
+void escape_reference_compute(EscapeReference *reference, const EscapeView *view, const float *julia_c,
+                              uint32_t max_iterations, double spacing, const double *extent) {
+    bool julia = julia_c != NULL;
+
+    if (reference->capacity < max_iterations + 1) {
+        reference->capacity = max_iterations + 1;
+        reference->x        = realloc(reference->x, reference->capacity * sizeof(double));
+        reference->y        = realloc(reference->y, reference->capacity * sizeof(double));
+    }
+
+    DoubleDouble c[2] = {view->center[0], view->center[1]};
+    DoubleDouble z[2] = {view->center[0], view->center[1]};
+
+    if (julia) {
+        c[0] = dd_from_double(julia_c[0]);
+        c[1] = dd_from_double(julia_c[1]);
+    } else {
+        z[0] = dd_from_double(0);
+        z[1] = dd_from_double(0);
+    }
+
+    EscapeSeries series = {{julia ? 1 : 0, 0}, {0, 0}, {0, 0}};
+    double       probe_offset[ESCAPE_PROBES][2];
+    double       probe_delta[ESCAPE_PROBES][2];
+    bool         valid = true;
+
+    for (uint32_t i = 0; i < ESCAPE_PROBES; i++) {
+        probe_offset[i][0] = i & 1 ? extent[0] : -extent[0];
+        probe_offset[i][1] = i & 2 ? extent[1] : -extent[1];
+        probe_delta[i][0]  = julia ? probe_offset[i][0] : 0;
+        probe_delta[i][1]  = julia ? probe_offset[i][1] : 0;
+    }
+
+    reference->skip   = 0;
+    reference->series = series;
+    reference->length = 0;
+
+    for (uint32_t n = 0; n <= max_iterations; n++) {
+        double point[2] = {dd_to_double(z[0]), dd_to_double(z[1])};
+
+        reference->x[n] = point[0];
+        reference->y[n] = point[1];
+        reference->length++;
+
+        if (point[0] * point[0] + point[1] * point[1] > ESCAPE_BAILOUT * ESCAPE_BAILOUT) {
+            break;
+        }
+
+        // The series for step n + 1 is usable since that point gets stored, the loop only stopping at escapes, which
+        // come after storing. Pixels still need a step left to take from it.
+        if (valid && n + 1 < max_iterations) {
+            advance_series(&series, point, julia);
+
+            for (uint32_t i = 0; i < ESCAPE_PROBES; i++) {
+                double *delta  = probe_delta[i];
+                double  next_x = 2 * (point[0] * delta[0] - point[1] * delta[1]) + delta[0] * delta[0] -
+                                delta[1] * delta[1] + (julia ? 0 : probe_offset[i][0]);
+                double  next_y = 2 * (point[0] * delta[1] + point[1] * delta[0]) + 2 * delta[0] * delta[1] +
+                                (julia ? 0 : probe_offset[i][1]);
+
+                delta[0] = next_x;
+                delta[1] = next_y;
+                valid    = valid && check_series(&series, probe_offset[i], delta, spacing);
+            }
+
+            if (valid) {
+                reference->skip   = n + 1;
+                reference->series = series;
+            }
+        }
+
+        DoubleDouble x2 = dd_multiply(z[0], z[0]);
+        DoubleDouble y2 = dd_multiply(z[1], z[1]);
+        DoubleDouble xy = dd_multiply(z[0], z[1]);
+
+        z[0] = dd_add(dd_add(x2, dd_negate(y2)), c[0]);
+        z[1] = dd_add(dd_add(xy, xy), c[1]);
+    }
+}
+
+void escape_reference_destroy(EscapeReference *reference) {
+    free(reference->x);
+    free(reference->y);
+    reference->x        = NULL;
+    reference->y        = NULL;
+    reference->capacity = 0;
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef SRC_ESCAPE_VIEW_H_
+#define SRC_ESCAPE_VIEW_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Not built with the SIMD flags: -ffast-math would reassociate the error free sums double double arithmetic is made
+// of, and throw the low halves away
+
+// Orbits are followed until they are this far from the origin, well past 2, which keeps the smooth iteration count
+// accurate
+#define ESCAPE_BAILOUT 256.0
+// Limits on the distance between pixels. Double double arithmetic runs out of digits past the smallest.
+#define ESCAPE_VIEW_MIN_SPACING 1e-28
+#define ESCAPE_VIEW_MAX_SPACING 0.1
+// Largest error of the series approximation, as a fraction of the distance between neighbouring pixels at the same
+// step. Steps are only skipped while the corners of the view stay under it. Orbits near the set amplify any error over
+// thousands of steps, so it is far below what would show at the step itself.
+#define ESCAPE_SERIES_TOLERANCE 1e-6
+
+// A number as the unevaluated sum of two doubles, for about 106 bits of mantissa
+typedef struct {
+    double hi;
+    double lo;
+} DoubleDouble;
+
+// Where the escape time renderers look. Deep zooms need more precision for the center than a double has, while the
+// distance between pixels only needs its exponent range.
+typedef struct {
+    DoubleDouble center[2];
+    double       spacing; // Distance between neighbouring pixels of a full resolution map, on the plane
+} EscapeView;
+
+// Coefficients of the series approximation, see escape_reference_compute
+typedef struct {
+    double a[2];
+    double b[2];
+    double c[2];
+} EscapeSeries;
+
+// The orbit of the center of the view at double double precision, rounded to doubles. Other pixels are iterated as
+// small differences from it. length counts the points stored, and the series approximation of the view lets every
+// pixel start at step skip.
+typedef struct {
+    double  *x;
+    double  *y;
+    uint32_t length;
+    uint32_t capacity;
+
+    uint32_t     skip;
+    EscapeSeries series;
+} EscapeReference;
+
+DoubleDouble dd_from_double(double value);
+DoubleDouble dd_add_double(DoubleDouble a, double b);
+double       dd_to_double(DoubleDouble a);
+
+void escape_view_reset(EscapeView *view, bool julia, uint32_t height);
+void escape_view_pan(EscapeView *view, double delta_x, double delta_y);
+void escape_view_zoom(EscapeView *view, double factor, double offset_x, double offset_y);
+void escape_view_get_center(const EscapeView *view, double *x, double *y);
+
+void escape_reference_compute(EscapeReference *reference, const EscapeView *view, const float *julia_c,
+                              uint32_t max_iterations, double spacing, const double *extent);
+void escape_reference_destroy(EscapeReference *reference);
+
+#endif // SRC_ESCAPE_VIEW_H_
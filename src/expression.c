@@ -0,0 +1,586 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <ctype.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "expression.h"
+
+#define NO_NODE UINT8_MAX
+
+typedef struct {
+    const char  *name;
+    ExpressionOp op;
+    uint32_t     arity;
+} ExpressionFunction;
+
+static const ExpressionFunction functions[] = {
+    {"abs", EXPRESSION_OP_ABS, 1},     {"sign", EXPRESSION_OP_SIGN, 1},   {"floor", EXPRESSION_OP_FLOOR, 1},
+    {"sqrt", EXPRESSION_OP_SQRT, 1},   {"exp", EXPRESSION_OP_EXP, 1},     {"log", EXPRESSION_OP_LOG, 1},
+    {"sin", EXPRESSION_OP_SIN, 1},     {"cos", EXPRESSION_OP_COS, 1},     {"tan", EXPRESSION_OP_TAN, 1},
+    {"atan", EXPRESSION_OP_ATAN, 1},   {"tanh", EXPRESSION_OP_TANH, 1},   {"pow", EXPRESSION_OP_POW, 2},
+    {"min", EXPRESSION_OP_MIN, 2},     {"max", EXPRESSION_OP_MAX, 2},     {"atan2", EXPRESSION_OP_ATAN2, 2},
+};
+
+typedef struct {
+    const char *source;
+    const char *cursor;
+    Expression *expression;
+    char       *error;
+    size_t      error_size;
+    bool        failed;
+} Parser;
+
+static bool is_binary_op(ExpressionOp op) { return op >= EXPRESSION_OP_ADD && op <= EXPRESSION_OP_ATAN2; }
+
+static bool is_commutative_op(ExpressionOp op) {
+    return op == EXPRESSION_OP_ADD || op == EXPRESSION_OP_MUL || op == EXPRESSION_OP_MIN || op == EXPRESSION_OP_MAX;
+}
+
+// The scalar meaning of every operation, used for folding. The interpreter in custom.c must agree with it.
+static float apply_op(ExpressionOp op, float a, float b) {
+    switch (op) {
+        case EXPRESSION_OP_ADD: return a + b;
+        case EXPRESSION_OP_SUB: return a - b;
+        case EXPRESSION_OP_MUL: return a * b;
+        case EXPRESSION_OP_DIV: return a / b;
+        case EXPRESSION_OP_POW: return powf(a, b);
+        case EXPRESSION_OP_MIN: return fminf(a, b);
+        case EXPRESSION_OP_MAX: return fmaxf(a, b);
+        case EXPRESSION_OP_ATAN2: return atan2f(a, b);
+        case EXPRESSION_OP_NEG: return -a;
+        case EXPRESSION_OP_ABS: return fabsf(a);
+        case EXPRESSION_OP_SIGN: return (a > 0) - (a < 0);
+        case EXPRESSION_OP_FLOOR: return floorf(a);
+        case EXPRESSION_OP_SQRT: return sqrtf(a);
+        case EXPRESSION_OP_EXP: return expf(a);
+        case EXPRESSION_OP_LOG: return logf(a);
+        case EXPRESSION_OP_SIN: return sinf(a);
+        case EXPRESSION_OP_COS: return cosf(a);
+        case EXPRESSION_OP_TAN: return tanf(a);
+        case EXPRESSION_OP_ATAN: return atanf(a);
+        case EXPRESSION_OP_TANH: return tanhf(a);
+        default: return NAN;
+    }
+}
+
+// Reports the first error only, with the line and column it was found at
+static void parse_error(Parser *parser, const char *format, ...) {
+    if (parser->failed) {
+        return;
+    }
+    parser->failed = true;
+
+    uint32_t line   = 1;
+    uint32_t column = 1;
+    for (const char *c = parser->source; c < parser->cursor; c++) {
+        column = *c == '\n' ? 1 : column + 1;
+        line += *c == '\n';
+    }
+
+    int     length = snprintf(parser->error, parser->error_size, "line %u, column %u: ", line, column);
+    va_list arguments;
+    va_start(arguments, format);
+    if (length >= 0 && (size_t)length < parser->error_size) {
+        vsnprintf(parser->error + length, parser->error_size - length, format, arguments);
+    }
+    va_end(arguments);
+}
+
+// Newlines end statements, so only spaces and tabs are skipped
+static void skip_spaces(Parser *parser) {
+    while (*parser->cursor == ' ' || *parser->cursor == '\t' || *parser->cursor == '\r') {
+        parser->cursor++;
+    }
+}
+
+static bool accept(Parser *parser, char c) {
+    skip_spaces(parser);
+
+    if (*parser->cursor != c) {
+        return false;
+    }
+
+    parser->cursor++;
+    return true;
+}
+
+static void expect(Parser *parser, char c) {
+    if (!accept(parser, c)) {
+        parse_error(parser, "expected '%c'", c);
+    }
+}
+
+static uint32_t read_name(Parser *parser, char *name, uint32_t size) {
+    uint32_t length = 0;
+
+    skip_spaces(parser);
+    while (isalnum((unsigned char)*parser->cursor) || *parser->cursor == '_') {
+        if (length + 1 < size) {
+            name[length++] = *parser->cursor;
+        }
+        parser->cursor++;
+    }
+    name[length] = '\0';
+
+    return length;
+}
+
+static uint8_t add_node(Parser *parser, ExpressionOp op, uint8_t left, uint8_t right, float value) {
+    Expression *expression = parser->expression;
+
+    if (expression->num_nodes == EXPRESSION_MAX_NODES) {
+        parse_error(parser, "formula too long, at most %u terms", EXPRESSION_MAX_NODES);
+        return NO_NODE;
+    }
+
+    ExpressionNode *node = &expression->nodes[expression->num_nodes];
+    node->op             = op;
+    node->left           = left;
+    node->right          = right;
+    node->value          = value;
+
+    return expression->num_nodes++;
+}
+
+static bool is_constant_node(const Parser *parser, uint8_t index) {
+    return parser->expression->nodes[index].op == EXPRESSION_OP_CONSTANT;
+}
+
+// Applies op to already parsed children. Operations on constants are folded, and since children are parsed right
+// before their parent, the constants being folded are the last nodes and their slots are reused.
+static uint8_t add_operation(Parser *parser, ExpressionOp op, uint8_t left, uint8_t right) {
+    if (parser->failed) {
+        return NO_NODE;
+    }
+
+    Expression *expression = parser->expression;
+    bool        binary     = is_binary_op(op);
+    uint32_t    children   = binary ? 2 : 1;
+
+    if (is_constant_node(parser, left) && (!binary || is_constant_node(parser, right)) &&
+        expression->num_nodes - children == left) {
+        float value = apply_op(op, expression->nodes[left].value, binary ? expression->nodes[right].value : 0);
+
+        expression->num_nodes -= children;
+        return add_node(parser, EXPRESSION_OP_CONSTANT, NO_NODE, NO_NODE, value);
+    }
+
+    return add_node(parser, op, left, binary ? right : NO_NODE, 0);
+}
+
+static uint8_t parse_sum(Parser *parser);
+static uint8_t parse_unary(Parser *parser);
+
+static uint8_t parse_call(Parser *parser, const ExpressionFunction *function) {
+    expect(parser, '(');
+    uint8_t left  = parse_sum(parser);
+    uint8_t right = NO_NODE;
+
+    if (function->arity == 2) {
+        expect(parser, ',');
+        right = parse_sum(parser);
+    }
+    expect(parser, ')');
+
+    return add_operation(parser, function->op, left, right);
+}
+
+static uint8_t parse_primary(Parser *parser) {
+    skip_spaces(parser);
+
+    if (parser->failed) {
+        return NO_NODE;
+    }
+
+    if (accept(parser, '(')) {
+        uint8_t node = parse_sum(parser);
+        expect(parser, ')');
+        return node;
+    }
+
+    if (isdigit((unsigned char)*parser->cursor) || *parser->cursor == '.') {
+        char  *end;
+        double value = strtod(parser->cursor, &end);
+
+        if (end == parser->cursor) {
+            parse_error(parser, "expected a number");
+            return NO_NODE;
+        }
+        parser->cursor = end;
+
+        return add_node(parser, EXPRESSION_OP_CONSTANT, NO_NODE, NO_NODE, value);
+    }
+
+    const char *start = parser->cursor;
+    char        name[16];
+
+    if (read_name(parser, name, sizeof(name)) == 0) {
+        parse_error(parser, *parser->cursor == '\0' || *parser->cursor == '\n' ? "unexpected end of the statement"
+                                                                                : "unexpected '%c'",
+                    *parser->cursor);
+        return NO_NODE;
+    }
+
+    if (strcmp(name, "x") == 0) {
+        return add_node(parser, EXPRESSION_OP_X, NO_NODE, NO_NODE, 0);
+    }
+    if (strcmp(name, "y") == 0) {
+        return add_node(parser, EXPRESSION_OP_Y, NO_NODE, NO_NODE, 0);
+    }
+    if (strcmp(name, "pi") == 0) {
+        return add_node(parser, EXPRESSION_OP_CONSTANT, NO_NODE, NO_NODE, 3.14159265f);
+    }
+    if (name[1] == '\0' && name[0] >= 'a' && name[0] < 'a' + EXPRESSION_NUM_PARAMETERS) {
+        return add_node(parser, EXPRESSION_OP_PARAMETER, NO_NODE, NO_NODE, name[0] - 'a');
+    }
+
+    for (uint32_t i = 0; i < sizeof(functions) / sizeof(functions[0]); i++) {
+        if (strcmp(name, functions[i].name) == 0) {
+            return parse_call(parser, &functions[i]);
+        }
+    }
+
+    parser->cursor = start;
+    parse_error(parser, "unknown name '%s'", name);
+    return NO_NODE;
+}
+
+// Right associative and tighter than unary minus, so -x^2 is -(x^2) and 2^-x is 2^(-x)
+static uint8_t parse_power(Parser *parser) {
+    uint8_t base = parse_primary(parser);
+
+    if (accept(parser, '^')) {
+        return add_operation(parser, EXPRESSION_OP_POW, base, parse_unary(parser));
+    }
+
+    return base;
+}
+
+static uint8_t parse_unary(Parser *parser) {
+    if (accept(parser, '-')) {
+        return add_operation(parser, EXPRESSION_OP_NEG, parse_unary(parser), NO_NODE);
+    }
+    if (accept(parser, '+')) {
+        return parse_unary(parser);
+    }
+
+    return parse_power(parser);
+}
+
+static uint8_t parse_product(Parser *parser) {
+    uint8_t node = parse_unary(parser);
+
+    while (!parser->failed) {
+        if (accept(parser, '*')) {
+            node = add_operation(parser, EXPRESSION_OP_MUL, node, parse_unary(parser));
+        } else if (accept(parser, '/')) {
+            node = add_operation(parser, EXPRESSION_OP_DIV, node, parse_unary(parser));
+        } else {
+            break;
+        }
+    }
+
+    return node;
+}
+
+static uint8_t parse_sum(Parser *parser) {
+    uint8_t node = parse_product(parser);
+
+    while (!parser->failed) {
+        if (accept(parser, '+')) {
+            node = add_operation(parser, EXPRESSION_OP_ADD, node, parse_product(parser));
+        } else if (accept(parser, '-')) {
+            node = add_operation(parser, EXPRESSION_OP_SUB, node, parse_product(parser));
+        } else {
+            break;
+        }
+    }
+
+    return node;
+}
+
+static bool is_statement_end(char c) { return c == '\0' || c == '\n' || c == ';' || c == '#'; }
+
+// Parses "x' = ...", "y' = ..." or "a = ..."
+static void parse_statement(Parser *parser, bool *has_root) {
+    Expression *expression = parser->expression;
+    const char *start      = parser->cursor;
+    char        name[16];
+
+    read_name(parser, name, sizeof(name));
+
+    bool is_x      = strcmp(name, "x") == 0;
+    bool is_y      = strcmp(name, "y") == 0;
+    bool is_target = (is_x || is_y) && accept(parser, '\'');
+    bool is_param  = name[1] == '\0' && name[0] >= 'a' && name[0] < 'a' + EXPRESSION_NUM_PARAMETERS;
+
+    if (!is_target && !is_param) {
+        parser->cursor = start;
+        parse_error(parser, "expected x' = ..., y' = ... or a parameter from a to %c = ...",
+                    'a' + EXPRESSION_NUM_PARAMETERS - 1);
+        return;
+    }
+
+    expect(parser, '=');
+    uint8_t node = parse_sum(parser);
+
+    skip_spaces(parser);
+    if (!is_statement_end(*parser->cursor)) {
+        parse_error(parser, "unexpected '%c'", *parser->cursor);
+    }
+    if (parser->failed) {
+        return;
+    }
+
+    if (is_target) {
+        uint32_t root = is_x ? EXPRESSION_REGISTER_X : EXPRESSION_REGISTER_Y;
+
+        if (has_root[root]) {
+            parser->cursor = start;
+            parse_error(parser, "%s' is given twice", name);
+        }
+        expression->roots[root] = node;
+        has_root[root]          = true;
+        return;
+    }
+
+    if (!is_constant_node(parser, node)) {
+        parser->cursor = start;
+        parse_error(parser, "%s must be a number", name);
+        return;
+    }
+
+    expression->parameters[name[0] - 'a']    = expression->nodes[node].value;
+    expression->has_parameter[name[0] - 'a'] = true;
+    expression->num_nodes--;
+}
+
+// Returns false and describes the first mistake in error when the source is not a valid formula, in which case
+// expression is left in an unspecified state
+bool expression_parse(const char *source, Expression *expression, char *error, size_t error_size) {
+    Parser parser = {.expression = expression, .error = error, .error_size = error_size};
+
+    bool has_root[EXPRESSION_NUM_REGISTERS] = {false, false};
+
+    memset(expression, 0, sizeof(Expression));
+
+    if (strlen(source) >= EXPRESSION_MAX_SOURCE) {
+        snprintf(error, error_size, "formula too long, at most %u characters", EXPRESSION_MAX_SOURCE - 1);
+        return false;
+    }
+    strcpy(expression->source, source);
+    parser.source = expression->source;
+    parser.cursor = expression->source;
+
+    while (!parser.failed && *parser.cursor != '\0') {
+        skip_spaces(&parser);
+
+        if (*parser.cursor == '#') {
+            parser.cursor += strcspn(parser.cursor, "\n");
+        } else if (!is_statement_end(*parser.cursor)) {
+            parse_statement(&parser, has_root);
+        }
+
+        if (*parser.cursor == '#') {
+            parser.cursor += strcspn(parser.cursor, "\n");
+        }
+        if (*parser.cursor == '\n' || *parser.cursor == ';') {
+            parser.cursor++;
+        }
+    }
+
+    for (uint32_t i = 0; i < EXPRESSION_NUM_REGISTERS && !parser.failed; i++) {
+        if (!has_root[i]) {
+            parse_error(&parser, "missing the equation for %c'", i == EXPRESSION_REGISTER_X ? 'x' : 'y');
+        }
+    }
+
+    return !parser.failed;
+}
+
+typedef struct {
+    bool    is_constant;
+    float   value;
+    uint8_t reg;
+} Operand;
+
+typedef struct {
+    const Expression  *expression;
+    const float       *parameters;
+    ExpressionProgram *program;
+} Compiler;
+
+static Operand constant_operand(float value) { return (Operand){.is_constant = true, .value = value}; }
+
+static Operand register_operand(uint8_t reg) { return (Operand){.is_constant = false, .reg = reg}; }
+
+static bool is_constant_operand(Operand operand, float value) {
+    return operand.is_constant && operand.value == value;
+}
+
+// Constants only take a register once they are used by an instruction, and equal constants share it
+static uint8_t load_operand(Compiler *compiler, Operand operand) {
+    ExpressionProgram *program = compiler->program;
+
+    if (!operand.is_constant) {
+        return operand.reg;
+    }
+
+    for (uint32_t i = 0; i < program->num_constants; i++) {
+        if (memcmp(&program->constant_values[i], &operand.value, sizeof(float)) == 0) {
+            return program->constant_registers[i];
+        }
+    }
+
+    program->constant_registers[program->num_constants] = program->num_registers;
+    program->constant_values[program->num_constants]    = operand.value;
+    program->num_constants++;
+
+    return program->num_registers++;
+}
+
+// Instructions repeating an earlier one reuse its result instead, which is safe since registers are never written
+// twice
+static Operand emit(Compiler *compiler, ExpressionOp op, Operand left, Operand right) {
+    ExpressionProgram *program = compiler->program;
+    uint8_t            a       = load_operand(compiler, left);
+    uint8_t            b       = is_binary_op(op) ? load_operand(compiler, right) : a;
+
+    if (is_commutative_op(op) && b < a) {
+        uint8_t swap = a;
+        a            = b;
+        b            = swap;
+    }
+
+    for (uint32_t i = 0; i < program->length; i++) {
+        const ExpressionInstruction *instruction = &program->code[i];
+
+        if (instruction->op == op && instruction->a == a && instruction->b == b) {
+            return register_operand(instruction->target);
+        }
+    }
+
+    ExpressionInstruction *instruction = &program->code[program->length++];
+    instruction->op                    = op;
+    instruction->target                = program->num_registers++;
+    instruction->a                     = a;
+    instruction->b                     = b;
+
+    return register_operand(instruction->target);
+}
+
+// Rewrites the operations a constant operand makes cheaper. Powers by small integers and halves are the common case,
+// x^2 in particular, and turn into multiplications and square roots instead of a call to pow.
+static Operand emit_simplified(Compiler *compiler, ExpressionOp op, Operand left, Operand right) {
+    switch (op) {
+        case EXPRESSION_OP_ADD:
+            if (is_constant_operand(left, 0)) {
+                return right;
+            }
+            if (is_constant_operand(right, 0)) {
+                return left;
+            }
+            break;
+        case EXPRESSION_OP_SUB:
+            if (is_constant_operand(right, 0)) {
+                return left;
+            }
+            break;
+        case EXPRESSION_OP_MUL:
+            if (is_constant_operand(left, 1)) {
+                return right;
+            }
+            if (is_constant_operand(right, 1)) {
+                return left;
+            }
+            break;
+        case EXPRESSION_OP_DIV:
+            if (right.is_constant) {
+                return emit_simplified(compiler, EXPRESSION_OP_MUL, left, constant_operand(1 / right.value));
+            }
+            break;
+        case EXPRESSION_OP_POW:
+            if (is_constant_operand(right, 0)) {
+                return constant_operand(1);
+            }
+            if (is_constant_operand(right, 1)) {
+                return left;
+            }
+            if (is_constant_operand(right, 2)) {
+                return emit(compiler, EXPRESSION_OP_MUL, left, left);
+            }
+            if (is_constant_operand(right, 3)) {
+                return emit(compiler, EXPRESSION_OP_MUL, emit(compiler, EXPRESSION_OP_MUL, left, left), left);
+            }
+            if (is_constant_operand(right, 4)) {
+                Operand square = emit(compiler, EXPRESSION_OP_MUL, left, left);
+                return emit(compiler, EXPRESSION_OP_MUL, square, square);
+            }
+            if (is_constant_operand(right, 0.5f)) {
+                return emit(compiler, EXPRESSION_OP_SQRT, left, left);
+            }
+            if (is_constant_operand(right, -1)) {
+                return emit(compiler, EXPRESSION_OP_DIV, constant_operand(1), left);
+            }
+            break;
+        default: break;
+    }
+
+    return emit(compiler, op, left, right);
+}
+
+static Operand compile_node(Compiler *compiler, uint8_t index) {
+    const ExpressionNode *node = &compiler->expression->nodes[index];
+
+    switch (node->op) {
+        case EXPRESSION_OP_CONSTANT: return constant_operand(node->value);
+        case EXPRESSION_OP_X: return register_operand(EXPRESSION_REGISTER_X);
+        case EXPRESSION_OP_Y: return register_operand(EXPRESSION_REGISTER_Y);
+        case EXPRESSION_OP_PARAMETER: return constant_operand(compiler->parameters[(uint32_t)node->value]);
+        default: break;
+    }
+
+    bool    binary = is_binary_op(node->op);
+    Operand left   = compile_node(compiler, node->left);
+    Operand right  = binary ? compile_node(compiler, node->right) : left;
+
+    if (left.is_constant && right.is_constant) {
+        return constant_operand(apply_op(node->op, left.value, right.value));
+    }
+
+    return emit_simplified(compiler, node->op, left, right);
+}
+
+// Compiles the expression for the given parameters. They are constants as far as the program is concerned, so
+// everything depending on them alone is folded, and the program has to be compiled again when they change.
+void expression_compile(const Expression *expression, const float *parameters, ExpressionProgram *program) {
+    Compiler compiler = {.expression = expression, .parameters = parameters, .program = program};
+
+    program->length        = 0;
+    program->num_constants = 0;
+    program->num_registers = EXPRESSION_NUM_REGISTERS;
+
+    for (uint32_t i = 0; i < EXPRESSION_NUM_REGISTERS; i++) {
+        program->outputs[i] = load_operand(&compiler, compile_node(&compiler, expression->roots[i]));
+    }
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef SRC_EXPRESSION_H_
+#define SRC_EXPRESSION_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Registers holding the point the map is applied to. The program reads them and leaves the image in the output
+// registers, so both formulas see the same x and y.
+#define EXPRESSION_REGISTER_X    0
+#define EXPRESSION_REGISTER_Y    1
+#define EXPRESSION_NUM_REGISTERS 2
+
+// Parameters a formula can use, named a to f
+#define EXPRESSION_NUM_PARAMETERS 6
+#define EXPRESSION_MAX_SOURCE     1024
+#define EXPRESSION_MAX_NODES      64
+// Every node compiles to at most two instructions and one constant, see expression_compile, so these always suffice
+#define EXPRESSION_MAX_INSTRUCTIONS (2 * EXPRESSION_MAX_NODES)
+#define EXPRESSION_MAX_REGISTERS    (EXPRESSION_NUM_REGISTERS + 3 * EXPRESSION_MAX_NODES)
+
+typedef enum {
+    // Leaves
+    EXPRESSION_OP_CONSTANT,
+    EXPRESSION_OP_X,
+    EXPRESSION_OP_Y,
+    EXPRESSION_OP_PARAMETER,
+    // Binary
+    EXPRESSION_OP_ADD,
+    EXPRESSION_OP_SUB,
+    EXPRESSION_OP_MUL,
+    EXPRESSION_OP_DIV,
+    EXPRESSION_OP_POW,
+    EXPRESSION_OP_MIN,
+    EXPRESSION_OP_MAX,
+    EXPRESSION_OP_ATAN2,
+    // Unary
+    EXPRESSION_OP_NEG,
+    EXPRESSION_OP_ABS,
+    EXPRESSION_OP_SIGN,
+    EXPRESSION_OP_FLOOR,
+    EXPRESSION_OP_SQRT,
+    EXPRESSION_OP_EXP,
+    EXPRESSION_OP_LOG,
+    EXPRESSION_OP_SIN,
+    EXPRESSION_OP_COS,
+    EXPRESSION_OP_TAN,
+    EXPRESSION_OP_ATAN,
+    EXPRESSION_OP_TANH,
+    EXPRESSION_OP_COUNT,
+} ExpressionOp;
+
+// Children are indices of earlier nodes. Constants keep their value, and parameters their index, in value.
+typedef struct {
+    uint8_t op;
+    uint8_t left;
+    uint8_t right;
+    float   value;
+} ExpressionNode;
+
+// A parsed formula, made of the equations for x' and y' and optional values for the parameters, like
+//
+//   # Clifford
+//   x' = sin(a*y) + c*cos(a*x)
+//   y' = sin(b*x) + d*cos(b*y)
+//   a = -1.4
+//
+// one statement per line or separated by semicolons. Expressions are made of x, y, the parameters a to f, numbers,
+// pi, + - * / ^ and the functions listed in expression.c. Subexpressions without x, y or parameters are folded while
+// parsing.
+typedef struct {
+    char           source[EXPRESSION_MAX_SOURCE];
+    ExpressionNode nodes[EXPRESSION_MAX_NODES];
+    uint32_t       num_nodes;
+    uint8_t        roots[EXPRESSION_NUM_REGISTERS]; // Nodes computing x' and y'
+    float          parameters[EXPRESSION_NUM_PARAMETERS];
+    bool           has_parameter[EXPRESSION_NUM_PARAMETERS]; // Set for the parameters given a value by the source
+} Expression;
+
+// Three address code over registers holding one float per lane. Operands of unary instructions are in a.
+typedef struct {
+    uint8_t op;
+    uint8_t target;
+    uint8_t a;
+    uint8_t b;
+} ExpressionInstruction;
+
+// An expression compiled for one set of parameters. The constants are written to their registers once, before the
+// program runs, and every instruction writes a register of its own, so no instruction reads what it writes.
+typedef struct {
+    ExpressionInstruction code[EXPRESSION_MAX_INSTRUCTIONS];
+    uint32_t              length;
+    uint32_t              num_registers;
+    uint8_t               constant_registers[EXPRESSION_MAX_REGISTERS];
+    float                 constant_values[EXPRESSION_MAX_REGISTERS];
+    uint32_t              num_constants;
+    uint8_t               outputs[EXPRESSION_NUM_REGISTERS]; // Registers holding x' and y' once the program ran
+} ExpressionProgram;
+
+bool expression_parse(const char *source, Expression *expression, char *error, size_t error_size);
+void expression_compile(const Expression *expression, const float *parameters, ExpressionProgram *program);
+
+#endif // SRC_EXPRESSION_H_
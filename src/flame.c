@@ -0,0 +1,529 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+// Fractal flames: iterated function systems of weighted affine transforms, each bent by one of the classic
+// variations, rendered by the chaos game. Built with the SIMD flags. ATTRACTOR_MAX_ORBITS orbits play the game side by
+// side, each picking its own transform every step, so every step evaluates the affine parts of all lanes at once and
+// then each variation in use over all lanes, keeping the result only in the lanes that picked it. With at most
+// FLAME_MAX_TRANSFORMS variations in use that wastes little, and every loop over lanes stays branch free.
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "chaos.h"
+#include "flame.h"
+
+#define FLAME_LANES ATTRACTOR_MAX_ORBITS
+// Steps an orbit takes after starting over before it is drawn, so it is on the attractor first
+#define FLAME_FUSE 20
+// Samples the frame is measured from, and the fraction of them left outside of it on each side. A few points are
+// thrown far out by the variations dividing by the radius, and would otherwise shrink the attractor to a dot.
+#define FLAME_FRAME_SAMPLES  16384
+#define FLAME_FRAME_OUTLIERS 0.005f
+// Fraction of the measured extent added on every side of the frame
+#define FLAME_FRAME_MARGIN 0.05f
+// Frame used when the orbit collapses
+#define FLAME_FRAME_FALLBACK 2.0f
+// Same test as the flows, see FLOW_DIVERGED_EXPONENT
+#define FLAME_DIVERGED_EXPONENT (127 + 20)
+// Squared radius below which the variations dividing by it see this instead, so they stay finite under -ffast-math
+#define FLAME_MIN_RADIUS2 1e-12f
+#define FLAME_PALETTE_SIZE 256
+// Seeds the orbits the frame is measured from, so every worker measures the same frame
+#define FLAME_FRAME_SEED 0x9e3779b9u
+
+// The parameters unpacked for the lanes. A draw r in [0, 1) picks the transform numbered by how many thresholds are
+// at or below r, which skips transforms weighted 0.
+typedef struct {
+    float    threshold[FLAME_MAX_TRANSFORMS - 1];
+    float    color[FLAME_MAX_TRANSFORMS];
+    float    a[FLAME_MAX_TRANSFORMS], b[FLAME_MAX_TRANSFORMS], c[FLAME_MAX_TRANSFORMS];
+    float    d[FLAME_MAX_TRANSFORMS], e[FLAME_MAX_TRANSFORMS], f[FLAME_MAX_TRANSFORMS];
+    float    blend[FLAME_MAX_TRANSFORMS];
+    uint32_t variation[FLAME_MAX_TRANSFORMS];
+
+    // Variations of the transforms that can be picked, each once
+    uint32_t used[FLAME_MAX_TRANSFORMS];
+    uint32_t num_used;
+} FlameTransforms;
+
+// Orbits of all the lanes, and their random streams
+typedef struct {
+    float    x[FLAME_LANES];
+    float    y[FLAME_LANES];
+    float    color[FLAME_LANES];
+    uint32_t rng[FLAME_LANES];
+    uint32_t fuse[FLAME_LANES]; // Steps left before the orbit is drawn
+} FlameLanes;
+
+static const struct {
+    float position;
+    float rgb[3];
+} flame_palette_stops[] = {
+    {0.00f, {20, 24, 82}},   {0.25f, {38, 126, 196}}, {0.50f, {236, 232, 206}},
+    {0.75f, {244, 148, 36}}, {1.00f, {158, 22, 44}},
+};
+
+static inline uint32_t has_diverged(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    return ((bits >> 23) & 0xff) >= FLAME_DIVERGED_EXPONENT;
+}
+
+// xorshift32 per lane, which vectorizes where pcg32's 64 bit multiply would not
+static inline uint32_t next_random(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+
+    return x;
+}
+
+// Uniform in [0, 1) from the top 24 bits
+static inline float to_unit(uint32_t bits) { return (bits >> 8) * (1.0f / (1 << 24)); }
+
+static void load_transforms(const float *parameters, FlameTransforms *transforms) {
+    float weight[FLAME_MAX_TRANSFORMS];
+    float total = 0;
+
+    for (uint32_t t = 0; t < FLAME_MAX_TRANSFORMS; t++) {
+        weight[t] = fmaxf(parameters[t * FLAME_TRANSFORM_PARAMETERS + FLAME_WEIGHT], 0);
+        total += weight[t];
+    }
+
+    // With every transform off, all of them are picked evenly rather than none
+    if (!(total > 0)) {
+        for (uint32_t t = 0; t < FLAME_MAX_TRANSFORMS; t++) {
+            weight[t] = 1;
+        }
+        total = FLAME_MAX_TRANSFORMS;
+    }
+
+    float cumulative     = 0;
+    transforms->num_used = 0;
+
+    for (uint32_t t = 0; t < FLAME_MAX_TRANSFORMS; t++) {
+        const float *p         = parameters + t * FLAME_TRANSFORM_PARAMETERS;
+        float        variation = fminf(fmaxf(p[FLAME_VARIATION], 0), FLAME_VARIATION_COUNT - 1);
+
+        cumulative += weight[t];
+
+        if (t < FLAME_MAX_TRANSFORMS - 1) {
+            transforms->threshold[t] = cumulative / total;
+        }
+
+        transforms->color[t]     = fminf(fmaxf(p[FLAME_COLOR], 0), 1);
+        transforms->a[t]         = p[FLAME_A];
+        transforms->b[t]         = p[FLAME_B];
+        transforms->c[t]         = p[FLAME_C];
+        transforms->d[t]         = p[FLAME_D];
+        transforms->e[t]         = p[FLAME_E];
+        transforms->f[t]         = p[FLAME_F];
+        transforms->blend[t]     = fminf(fmaxf(p[FLAME_BLEND], 0), 1);
+        transforms->variation[t] = (uint32_t)variation;
+
+        if (weight[t] <= 0) {
+            continue;
+        }
+
+        bool seen = false;
+        for (uint32_t u = 0; u < transforms->num_used; u++) {
+            seen |= transforms->used[u] == transforms->variation[t];
+        }
+
+        if (!seen) {
+            transforms->used[transforms->num_used++] = transforms->variation[t];
+        }
+    }
+}
+
+// Applies one variation to every lane. theta is measured from the y axis, atan2(x, y), as in the flame paper.
+static inline void evaluate_variation(uint32_t variation, const float *x, const float *y, const float *r2,
+                                      const float *r, const float *theta, const uint32_t *rng, float *out_x,
+                                      float *out_y) {
+    const float pi = 3.14159265f;
+
+    switch (variation) {
+        case FLAME_VARIATION_SINUSOIDAL:
+            for (uint32_t l = 0; l < FLAME_LANES; l++) {
+                out_x[l] = sinf(x[l]);
+                out_y[l] = sinf(y[l]);
+            }
+            break;
+        case FLAME_VARIATION_SPHERICAL:
+            for (uint32_t l = 0; l < FLAME_LANES; l++) {
+                out_x[l] = x[l] / r2[l];
+                out_y[l] = y[l] / r2[l];
+            }
+            break;
+        case FLAME_VARIATION_SWIRL:
+            for (uint32_t l = 0; l < FLAME_LANES; l++) {
+                float s  = sinf(r2[l]);
+                float c  = cosf(r2[l]);
+                out_x[l] = x[l] * s - y[l] * c;
+                out_y[l] = x[l] * c + y[l] * s;
+            }
+            break;
+        case FLAME_VARIATION_HORSESHOE:
+            for (uint32_t l = 0; l < FLAME_LANES; l++) {
+                out_x[l] = (x[l] - y[l]) * (x[l] + y[l]) / r[l];
+                out_y[l] = 2 * x[l] * y[l] / r[l];
+            }
+            break;
+        case FLAME_VARIATION_POLAR:
+            for (uint32_t l = 0; l < FLAME_LANES; l++) {
+                out_x[l] = theta[l] / pi;
+                out_y[l] = r[l] - 1;
+            }
+            break;
+        case FLAME_VARIATION_HANDKERCHIEF:
+            for (uint32_t l = 0; l < FLAME_LANES; l++) {
+                out_x[l] = r[l] * sinf(theta[l] + r[l]);
+                out_y[l] = r[l] * cosf(theta[l] - r[l]);
+            }
+            break;
+        case FLAME_VARIATION_HEART:
+            for (uint32_t l = 0; l < FLAME_LANES; l++) {
+                out_x[l] = r[l] * sinf(theta[l] * r[l]);
+                out_y[l] = -r[l] * cosf(theta[l] * r[l]);
+            }
+            break;
+        case FLAME_VARIATION_DISC:
+            for (uint32_t l = 0; l < FLAME_LANES; l++) {
+                out_x[l] = theta[l] / pi * sinf(pi * r[l]);
+                out_y[l] = theta[l] / pi * cosf(pi * r[l]);
+            }
+            break;
+        case FLAME_VARIATION_SPIRAL:
+            for (uint32_t l = 0; l < FLAME_LANES; l++) {
+                out_x[l] = (cosf(theta[l]) + sinf(r[l])) / r[l];
+                out_y[l] = (sinf(theta[l]) - cosf(r[l])) / r[l];
+            }
+            break;
+        case FLAME_VARIATION_HYPERBOLIC:
+            for (uint32_t l = 0; l < FLAME_LANES; l++) {
+                out_x[l] = sinf(theta[l]) / r[l];
+                out_y[l] = r[l] * cosf(theta[l]);
+            }
+            break;
+        case FLAME_VARIATION_DIAMOND:
+            for (uint32_t l = 0; l < FLAME_LANES; l++) {
+                out_x[l] = sinf(theta[l]) * cosf(r[l]);
+                out_y[l] = cosf(theta[l]) * sinf(r[l]);
+            }
+            break;
+        case FLAME_VARIATION_JULIA:
+            // The random half turn is a sign flip, taken from a bit of the lane's last draw
+            for (uint32_t l = 0; l < FLAME_LANES; l++) {
+                float scale = sqrtf(r[l]) * ((rng[l] & 0x80) ? -1.0f : 1.0f);
+                out_x[l]    = scale * cosf(theta[l] * 0.5f);
+                out_y[l]    = scale * sinf(theta[l] * 0.5f);
+            }
+            break;
+        default:
+            for (uint32_t l = 0; l < FLAME_LANES; l++) {
+                out_x[l] = x[l];
+                out_y[l] = y[l];
+            }
+            break;
+    }
+}
+
+// One step of the chaos game on every lane. Orbits that diverge start over from a random point, and are not drawn
+// until their fuse burns out.
+static inline void flame_step(const FlameTransforms *transforms, FlameLanes *lanes) {
+    uint32_t pick[FLAME_LANES];
+    float    x[FLAME_LANES], y[FLAME_LANES], r2[FLAME_LANES], r[FLAME_LANES], theta[FLAME_LANES];
+    float    next_x[FLAME_LANES], next_y[FLAME_LANES];
+
+    for (uint32_t l = 0; l < FLAME_LANES; l++) {
+        float    draw = to_unit(next_random(&lanes->rng[l]));
+        uint32_t t    = 0;
+
+        for (uint32_t i = 0; i < FLAME_MAX_TRANSFORMS - 1; i++) {
+            t += draw >= transforms->threshold[i];
+        }
+
+        pick[l]  = t;
+        x[l]     = transforms->a[t] * lanes->x[l] + transforms->b[t] * lanes->y[l] + transforms->c[t];
+        y[l]     = transforms->d[t] * lanes->x[l] + transforms->e[t] * lanes->y[l] + transforms->f[t];
+        r2[l]    = fmaxf(x[l] * x[l] + y[l] * y[l], FLAME_MIN_RADIUS2);
+        r[l]     = sqrtf(r2[l]);
+        theta[l] = atan2f(x[l], y[l]);
+
+        float straight = 1 - transforms->blend[t];
+        next_x[l]      = straight * x[l];
+        next_y[l]      = straight * y[l];
+
+        lanes->color[l] = (lanes->color[l] + transforms->color[t]) * 0.5f;
+    }
+
+    for (uint32_t u = 0; u < transforms->num_used; u++) {
+        uint32_t variation = transforms->used[u];
+        float    bent_x[FLAME_LANES], bent_y[FLAME_LANES];
+
+        evaluate_variation(variation, x, y, r2, r, theta, lanes->rng, bent_x, bent_y);
+
+        for (uint32_t l = 0; l < FLAME_LANES; l++) {
+            float weight = transforms->variation[pick[l]] == variation ? transforms->blend[pick[l]] : 0;
+            next_x[l] += weight * bent_x[l];
+            next_y[l] += weight * bent_y[l];
+        }
+    }
+
+    for (uint32_t l = 0; l < FLAME_LANES; l++) {
+        uint32_t diverged  = has_diverged(next_x[l]) | has_diverged(next_y[l]);
+        float    restart_x = to_unit(next_random(&lanes->rng[l])) * 2 - 1;
+        float    restart_y = to_unit(next_random(&lanes->rng[l])) * 2 - 1;
+
+        lanes->x[l]    = diverged ? restart_x : next_x[l];
+        lanes->y[l]    = diverged ? restart_y : next_y[l];
+        lanes->fuse[l] = diverged ? FLAME_FUSE : (lanes->fuse[l] > 0 ? lanes->fuse[l] - 1 : 0);
+    }
+}
+
+static void seed_lanes(FlameLanes *lanes, uint32_t seed) {
+    for (uint32_t l = 0; l < FLAME_LANES; l++) {
+        lanes->rng[l] = (seed + l * 0x6d2b79f5u) | 1;
+        next_random(&lanes->rng[l]);
+
+        lanes->x[l]     = to_unit(next_random(&lanes->rng[l])) * 2 - 1;
+        lanes->y[l]     = to_unit(next_random(&lanes->rng[l])) * 2 - 1;
+        lanes->color[l] = to_unit(next_random(&lanes->rng[l]));
+        lanes->fuse[l]  = FLAME_FUSE;
+    }
+}
+
+static int compare_floats(const void *a, const void *b) {
+    float x = *(const float *)a;
+    float y = *(const float *)b;
+
+    return (x > y) - (x < y);
+}
+
+// Frames the bulk of the samples of a few orbits, widened to the aspect of the image so flames are not stretched
+static void measure_flame_frame(Attractor *attractor, const FlameTransforms *transforms) {
+    float     *samples[2] = {malloc(FLAME_FRAME_SAMPLES * sizeof(float)), malloc(FLAME_FRAME_SAMPLES * sizeof(float))};
+    uint32_t   count      = 0;
+    FlameLanes lanes;
+
+    seed_lanes(&lanes, FLAME_FRAME_SEED);
+
+    while (count + FLAME_LANES <= FLAME_FRAME_SAMPLES) {
+        flame_step(transforms, &lanes);
+
+        for (uint32_t l = 0; l < FLAME_LANES; l++) {
+            if (lanes.fuse[l] == 0) {
+                samples[0][count] = lanes.x[l];
+                samples[1][count] = lanes.y[l];
+                count++;
+            }
+        }
+    }
+
+    float center[2], half_extent[2];
+
+    for (uint32_t d = 0; d < 2; d++) {
+        qsort(samples[d], count, sizeof(float), compare_floats);
+
+        uint32_t skip   = count * FLAME_FRAME_OUTLIERS;
+        float    min    = samples[d][skip];
+        float    max    = samples[d][count - 1 - skip];
+        float    extent = max - min;
+
+        if (!(extent > CHAOS_MIN_EXTENT)) {
+            min    = -FLAME_FRAME_FALLBACK;
+            max    = FLAME_FRAME_FALLBACK;
+            extent = max - min;
+        }
+
+        center[d]      = (min + max) * 0.5f;
+        half_extent[d] = extent * (0.5f + FLAME_FRAME_MARGIN);
+    }
+
+    float aspect   = (float)attractor->width / attractor->height;
+    half_extent[0] = fmaxf(half_extent[0], half_extent[1] * aspect);
+    half_extent[1] = fmaxf(half_extent[1], half_extent[0] / aspect);
+
+    for (uint32_t d = 0; d < 2; d++) {
+        attractor->frame_min[d] = center[d] - half_extent[d];
+        attractor->frame_max[d] = center[d] + half_extent[d];
+    }
+
+    free(samples[0]);
+    free(samples[1]);
+
+    memcpy(attractor->frame_parameters, attractor->parameters, attractor->num_parameters * sizeof(float));
+    attractor->frame_valid = true;
+}
+
+static void update_flame_frame(Attractor *attractor, const FlameTransforms *transforms) {
+    if (attractor->frame_valid &&
+        memcmp(attractor->frame_parameters, attractor->parameters, attractor->num_parameters * sizeof(float)) == 0) {
+        return;
+    }
+
+    measure_flame_frame(attractor, transforms);
+}
+
+static void build_palette(uint32_t palette[3][FLAME_PALETTE_SIZE]) {
+    uint32_t stop = 0;
+
+    for (uint32_t i = 0; i < FLAME_PALETTE_SIZE; i++) {
+        float position = (float)i / (FLAME_PALETTE_SIZE - 1);
+
+        while (flame_palette_stops[stop + 1].position < position) {
+            stop++;
+        }
+
+        float from = flame_palette_stops[stop].position;
+        float to   = flame_palette_stops[stop + 1].position;
+        float t    = (position - from) / (to - from);
+
+        for (uint32_t c = 0; c < 3; c++) {
+            float low  = flame_palette_stops[stop].rgb[c];
+            float high = flame_palette_stops[stop + 1].rgb[c];
+
+            palette[c][i] = (uint32_t)(low + (high - low) * t + 0.5f);
+        }
+    }
+}
+
+// Continues the orbits in orbit_lanes, whose three rows hold x, y and the color of each lane. The random streams of the
+// lanes are drawn from the attractor's, so deterministic renders stay deterministic. Every sample adds one to the
+// density map and its palette color to the color map.
+void iterate_flame(Attractor *attractor, uint32_t num_iterations) {
+    FlameTransforms transforms;
+    FlameLanes      lanes;
+    uint32_t        palette[3][FLAME_PALETTE_SIZE];
+
+    load_transforms(attractor->parameters, &transforms);
+    update_flame_frame(attractor, &transforms);
+    build_palette(palette);
+
+    seed_lanes(&lanes, pcg32_random_r(&attractor->rng));
+
+    if (attractor->orbit_valid) {
+        for (uint32_t l = 0; l < FLAME_LANES; l++) {
+            lanes.x[l]     = attractor->orbit_lanes[0][l];
+            lanes.y[l]     = attractor->orbit_lanes[1][l];
+            lanes.color[l] = attractor->orbit_lanes[2][l];
+            lanes.fuse[l]  = 0;
+        }
+    }
+    attractor->orbit_valid = true;
+
+    for (uint32_t i = 0; i < attractor->burn_in; i++) {
+        flame_step(&transforms, &lanes);
+    }
+    attractor->burn_in = 0;
+
+    const uint32_t width   = get_attractor_map_width(attractor);
+    const uint32_t height  = get_attractor_map_height(attractor);
+    const float    min_x   = attractor->frame_min[0];
+    const float    min_y   = attractor->frame_min[1];
+    const float    scale_x = width / (attractor->frame_max[0] - min_x);
+    const float    scale_y = height / (attractor->frame_max[1] - min_y);
+    const uint32_t steps   = (num_iterations + FLAME_LANES - 1) / FLAME_LANES;
+
+    uint32_t *density_map = attractor->density_map;
+    uint64_t *color_map   = attractor->color_map;
+
+    for (uint32_t i = 0; i < steps; i++) {
+        uint32_t cell[FLAME_LANES], hit[FLAME_LANES], shade[FLAME_LANES];
+
+        // The last step may have more lanes than samples left, the extra lanes advance but do not deposit
+        uint32_t remaining = num_iterations - i * FLAME_LANES;
+
+        flame_step(&transforms, &lanes);
+
+        for (uint32_t l = 0; l < FLAME_LANES; l++) {
+            float pixel_x = (lanes.x[l] - min_x) * scale_x;
+            float pixel_y = (lanes.y[l] - min_y) * scale_y;
+
+            uint32_t inside = (lanes.fuse[l] == 0) & (pixel_x >= 0) & (pixel_x < width) & (pixel_y >= 0) &
+                              (pixel_y < height);
+            uint32_t column = inside ? (uint32_t)pixel_x : 0;
+            uint32_t row    = inside ? (uint32_t)pixel_y : 0;
+
+            cell[l]  = column + row * width;
+            hit[l]   = inside & (l < remaining);
+            shade[l] = (uint32_t)(lanes.color[l] * (FLAME_PALETTE_SIZE - 1));
+        }
+
+        for (uint32_t l = 0; l < FLAME_LANES; l++) {
+            density_map[cell[l]] += hit[l];
+            color_map[cell[l] * 3 + 0] += hit[l] * palette[0][shade[l]];
+            color_map[cell[l] * 3 + 1] += hit[l] * palette[1][shade[l]];
+            color_map[cell[l] * 3 + 2] += hit[l] * palette[2][shade[l]];
+        }
+    }
+
+    for (uint32_t l = 0; l < FLAME_LANES; l++) {
+        attractor->orbit_lanes[0][l] = lanes.x[l];
+        attractor->orbit_lanes[1][l] = lanes.y[l];
+        attractor->orbit_lanes[2][l] = lanes.color[l];
+    }
+}
+
+// A random IFS is never periodic and its orbits have no meaningful Lyapunov exponent, since nearby points are pulled
+// together by the contracting transforms while the random picks keep the orbit moving. So the probe only rejects
+// transforms that throw the orbit out or collapse it to a cycle, and leaves the rest to the occupancy check of
+// randomize_candidate.
+void probe_flame(Attractor *attractor, uint32_t num_iterations, ChaosProbe *probe) {
+    FlameTransforms   transforms;
+    FlameLanes        lanes;
+    CycleDetector     cycle;
+    LyapunovEstimator lyapunov;
+    float             shadow[2];
+
+    load_transforms(attractor->parameters, &transforms);
+    seed_lanes(&lanes, pcg32_random_r(&attractor->rng));
+
+    float state[2] = {lanes.x[0], lanes.y[0]};
+
+    cycle_detector_init(&cycle, state, 2);
+    lyapunov_init(&lyapunov, state, shadow, 2);
+    chaos_probe_init(probe);
+
+    for (uint32_t i = 0; i < num_iterations; i++) {
+        flame_step(&transforms, &lanes);
+
+        // The fuse only goes back up when the orbit diverged and started over
+        if (lanes.fuse[0] == FLAME_FUSE) {
+            probe->classification = ORBIT_DIVERGENT;
+            break;
+        }
+
+        state[0] = lanes.x[0];
+        state[1] = lanes.y[0];
+
+        if (chaos_probe_update(probe, &cycle, state)) {
+            break;
+        }
+    }
+
+    // Never updated, so the probe has no exponent
+    chaos_probe_finish(probe, &lyapunov);
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef SRC_FLAME_H_
+#define SRC_FLAME_H_
+
+#include <stdint.h>
+
+#include "attractor.h"
+
+#define FLAME_MAX_TRANSFORMS       4
+#define FLAME_TRANSFORM_PARAMETERS 10
+#define FLAME_NUM_PARAMETERS       (FLAME_MAX_TRANSFORMS * FLAME_TRANSFORM_PARAMETERS)
+
+// Parameters of each transform, FLAME_TRANSFORM_PARAMETERS apart. The affine part takes (x, y) to
+// (a x + b y + c, d x + e y + f), the variation then bends it, and blend mixes the bent point with the straight one.
+typedef enum {
+    FLAME_WEIGHT, // Relative odds of the transform being picked. Transforms weighted 0 are off.
+    FLAME_COLOR,  // Palette position the color of the orbit moves halfway towards
+    FLAME_A,
+    FLAME_B,
+    FLAME_C,
+    FLAME_D,
+    FLAME_E,
+    FLAME_F,
+    FLAME_VARIATION, // FlameVariation, truncated
+    FLAME_BLEND,
+} FlameParameter;
+
+// The classic variations, numbered like in the original flame algorithm paper
+typedef enum {
+    FLAME_VARIATION_LINEAR,
+    FLAME_VARIATION_SINUSOIDAL,
+    FLAME_VARIATION_SPHERICAL,
+    FLAME_VARIATION_SWIRL,
+    FLAME_VARIATION_HORSESHOE,
+    FLAME_VARIATION_POLAR,
+    FLAME_VARIATION_HANDKERCHIEF,
+    FLAME_VARIATION_HEART,
+    FLAME_VARIATION_DISC,
+    FLAME_VARIATION_SPIRAL,
+    FLAME_VARIATION_HYPERBOLIC,
+    FLAME_VARIATION_DIAMOND,
+    FLAME_VARIATION_JULIA,
+    FLAME_VARIATION_COUNT,
+} FlameVariation;
+
+void iterate_flame(Attractor *attractor, uint32_t num_iterations);
+void probe_flame(Attractor *attractor, uint32_t num_iterations, ChaosProbe *probe);
+
+#endif // SRC_FLAME_H_
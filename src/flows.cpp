@@ -0,0 +1,480 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+// Kernels of the continuous time attractors, generated from one template per kernel and instantiated for every flow
+// in FOR_EACH_FLOW. Built with the SIMD flags, since each RK4 step costs several times a map step and the renders
+// only keep up by advancing ATTRACTOR_MAX_ORBITS orbits at once, one per SIMD lane.
+
+#include <math.h>
+#include <string.h>
+
+#include "chaos.h"
+#include "flows.hpp"
+#include "flows_c.h"
+
+// Steps each fixed start runs before and while measuring the frame
+#define FLOW_FRAME_BURN_IN 2048
+#define FLOW_FRAME_STEPS   16384
+// Fraction of the measured extent added on every side of the frame
+#define FLOW_FRAME_MARGIN 0.05f
+// Frame used when no start settles on something worth drawing
+#define FLOW_FRAME_FALLBACK 2.0f
+// A float whose biased exponent reaches this is at least 2^20, about CHAOS_DIVERGENCE_LIMIT. Infinities and NaNs have
+// the largest exponent, so they are caught as well, which -ffast-math does not promise of isfinite.
+#define FLOW_DIVERGED_EXPONENT (127 + 20)
+// Steps between checks for orbits resting on a fixed point
+#define FLOW_REST_CHECK 64
+// Most steps advance spends looking for the next maximum of the section coordinate, so orbits resting on a fixed
+// point still come back
+#define FLOW_SECTION_MAX_STEPS 1024
+
+static inline uint32_t has_diverged(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    return ((bits >> 23) & 0xff) >= FLOW_DIVERGED_EXPONENT;
+}
+
+// Like measure_map_frame, but over all three coordinates, so a camera can frame the orbit as well as the plane
+template <typename Flow>
+static void measure_flow_frame(Attractor *attractor, const Flow &flow) {
+    static const float starts[][3] = {
+        {0.1f, 0.1f, 0.1f}, {-0.5f, 0.3f, 0.2f}, {0.7f, -0.2f, -0.4f}, {-0.2f, -0.6f, 0.5f}};
+
+    float min[3] = {INFINITY, INFINITY, INFINITY};
+    float max[3] = {-INFINITY, -INFINITY, -INFINITY};
+
+    for (uint32_t s = 0; s < sizeof(starts) / sizeof(starts[0]); s++) {
+        float state[3] = {starts[s][0], starts[s][1], starts[s][2]};
+
+        for (uint32_t i = 0; i < FLOW_FRAME_BURN_IN; i++) {
+            rk4_step(flow, Flow::time_step, state[0], state[1], state[2]);
+        }
+
+        float start_min[3] = {state[0], state[1], state[2]};
+        float start_max[3] = {state[0], state[1], state[2]};
+        bool  bounded      = true;
+
+        for (uint32_t i = 0; i < FLOW_FRAME_STEPS && bounded; i++) {
+            rk4_step(flow, Flow::time_step, state[0], state[1], state[2]);
+
+            bounded = !(has_diverged(state[0]) | has_diverged(state[1]) | has_diverged(state[2]));
+
+            for (uint32_t d = 0; d < 3; d++) {
+                start_min[d] = fminf(start_min[d], state[d]);
+                start_max[d] = fmaxf(start_max[d], state[d]);
+            }
+        }
+
+        bool collapsed = start_max[0] - start_min[0] <= CHAOS_MIN_EXTENT &&
+                         start_max[1] - start_min[1] <= CHAOS_MIN_EXTENT &&
+                         start_max[2] - start_min[2] <= CHAOS_MIN_EXTENT;
+
+        if (!bounded || collapsed) {
+            continue;
+        }
+
+        for (uint32_t d = 0; d < 3; d++) {
+            min[d] = fminf(min[d], start_min[d]);
+            max[d] = fmaxf(max[d], start_max[d]);
+        }
+    }
+
+    for (uint32_t d = 0; d < 3; d++) {
+        float extent = max[d] - min[d];
+
+        if (!(extent > CHAOS_MIN_EXTENT)) {
+            min[d] = -FLOW_FRAME_FALLBACK;
+            max[d] = FLOW_FRAME_FALLBACK;
+            extent = max[d] - min[d];
+        }
+
+        attractor->frame_min[d] = min[d] - extent * FLOW_FRAME_MARGIN;
+        attractor->frame_max[d] = max[d] + extent * FLOW_FRAME_MARGIN;
+    }
+
+    memcpy(attractor->frame_parameters, attractor->parameters, attractor->num_parameters * sizeof(float));
+    attractor->frame_valid = true;
+}
+
+template <typename Flow>
+static void update_flow_frame(Attractor *attractor, const Flow &flow) {
+    if (attractor->frame_valid &&
+        memcmp(attractor->frame_parameters, attractor->parameters, attractor->num_parameters * sizeof(float)) == 0) {
+        return;
+    }
+
+    measure_flow_frame(attractor, flow);
+}
+
+// Normalized space of the camera and the volume: centered on the frame, and scaled so its longest side spans [-1, 1]
+static void get_normalization(const Attractor *attractor, float *center, float *scale) {
+    float half_extent = 0;
+
+    for (uint32_t d = 0; d < 3; d++) {
+        center[d]   = (attractor->frame_min[d] + attractor->frame_max[d]) * 0.5f;
+        half_extent = fmaxf(half_extent, (attractor->frame_max[d] - attractor->frame_min[d]) * 0.5f);
+    }
+
+    *scale = 1 / half_extent;
+}
+
+// Projections from a point of the flow to a pixel of the density map. They only compute where the point lands,
+// MapBinning takes care of points off the map.
+
+// Two of the coordinates, framed by the measured bounds
+template <typename Flow>
+struct PlaneProjection {
+    float min_x, min_y, scale_x, scale_y;
+
+    PlaneProjection(const Attractor *attractor, uint32_t width, uint32_t height) {
+        min_x   = attractor->frame_min[Flow::axis_x];
+        min_y   = attractor->frame_min[Flow::axis_y];
+        scale_x = width / (attractor->frame_max[Flow::axis_x] - min_x);
+        scale_y = height / (attractor->frame_max[Flow::axis_y] - min_y);
+    }
+
+    uint32_t operator()(float x, float y, float z, float &pixel_x, float &pixel_y) const {
+        const float point[3] = {x, y, z};
+
+        pixel_x = (point[Flow::axis_x] - min_x) * scale_x;
+        pixel_y = (point[Flow::axis_y] - min_y) * scale_y;
+
+        return 1;
+    }
+};
+
+// Through the attractor's camera. The normalization into the camera's space is folded into the matrix, and only the
+// rows of clip space x, y and w are kept, since there is no depth to test. Points behind the camera or outside the
+// sides of the view are culled in clip space, before the divide.
+struct CameraProjection {
+    float x_row[4], y_row[4], w_row[4];
+    float half_width, half_height;
+
+    CameraProjection(const Attractor *attractor, uint32_t width, uint32_t height) {
+        const float *m = attractor->view_projection;
+
+        float center[3], scale;
+        get_normalization(attractor, center, &scale);
+
+        float *rows[3]  = {x_row, y_row, w_row};
+        int    index[3] = {0, 1, 3};
+
+        // Column major: the element on row r and column c is m[c * 4 + r]
+        for (uint32_t i = 0; i < 3; i++) {
+            int r = index[i];
+
+            rows[i][0] = m[0 * 4 + r] * scale;
+            rows[i][1] = m[1 * 4 + r] * scale;
+            rows[i][2] = m[2 * 4 + r] * scale;
+            rows[i][3] = m[3 * 4 + r] - (rows[i][0] * center[0] + rows[i][1] * center[1] + rows[i][2] * center[2]);
+        }
+
+        half_width  = width * 0.5f;
+        half_height = height * 0.5f;
+    }
+
+    uint32_t operator()(float x, float y, float z, float &pixel_x, float &pixel_y) const {
+        float clip_x = x_row[0] * x + x_row[1] * y + x_row[2] * z + x_row[3];
+        float clip_y = y_row[0] * x + y_row[1] * y + y_row[2] * z + y_row[3];
+        float clip_w = w_row[0] * x + w_row[1] * y + w_row[2] * z + w_row[3];
+
+        uint32_t visible = (clip_w > 0) & (fabsf(clip_x) < clip_w) & (fabsf(clip_y) < clip_w);
+        float    inverse = 1 / (visible ? clip_w : 1);
+
+        pixel_x = (clip_x * inverse + 1) * half_width;
+        pixel_y = (clip_y * inverse + 1) * half_height;
+
+        return visible;
+    }
+};
+
+// Where the kernel counts samples. locate returns whether a point lands anywhere and the cell it lands in, which is
+// always a valid cell, so locating is branch free and vectorizes along with the step. deposit counts a hit in a cell,
+// and finish runs once at the end of the call.
+
+// On the density map, through a projection
+template <typename Projection>
+struct MapBinning {
+    Projection projection;
+    uint32_t   width, height;
+    uint32_t  *density_map;
+
+    explicit MapBinning(Attractor *attractor)
+        : projection(attractor, get_attractor_map_width(attractor), get_attractor_map_height(attractor)) {
+        width       = get_attractor_map_width(attractor);
+        height      = get_attractor_map_height(attractor);
+        density_map = attractor->density_map;
+    }
+
+    uint32_t locate(float x, float y, float z, uint32_t &cell) const {
+        float    pixel_x, pixel_y;
+        uint32_t visible = projection(x, y, z, pixel_x, pixel_y);
+
+        uint32_t inside = visible & (pixel_x >= 0) & (pixel_x < width) & (pixel_y >= 0) & (pixel_y < height);
+        uint32_t column = inside ? (uint32_t)pixel_x : 0;
+        uint32_t row    = inside ? (uint32_t)pixel_y : 0;
+
+        cell = column + row * width;
+        return inside;
+    }
+
+    void deposit(uint32_t cell, uint32_t hit) { density_map[cell] += hit; }
+    void finish() {}
+};
+
+// In the attractor's volume, shared with the other workers. Misses are skipped rather than added as zeros, since
+// every add is an atomic.
+struct VolumeBinning {
+    Volume  *volume;
+    float    center[3];
+    float    scale;
+    uint32_t deposited;
+
+    explicit VolumeBinning(Attractor *attractor) {
+        volume    = attractor->volume;
+        deposited = 0;
+
+        get_normalization(attractor, center, &scale);
+
+        // From the normalized [-1, 1] to voxel coordinates
+        scale *= volume->resolution * 0.5f;
+    }
+
+    uint32_t locate(float x, float y, float z, uint32_t &cell) const {
+        const float resolution = volume->resolution;
+
+        float voxel_x = (x - center[0]) * scale + resolution * 0.5f;
+        float voxel_y = (y - center[1]) * scale + resolution * 0.5f;
+        float voxel_z = (z - center[2]) * scale + resolution * 0.5f;
+
+        uint32_t inside = (voxel_x >= 0) & (voxel_x < resolution) & (voxel_y >= 0) & (voxel_y < resolution) &
+                          (voxel_z >= 0) & (voxel_z < resolution);
+
+        cell = volume_get_voxel(volume->bricks, inside ? (uint32_t)voxel_x : 0, inside ? (uint32_t)voxel_y : 0,
+                                inside ? (uint32_t)voxel_z : 0);
+        return inside;
+    }
+
+    void deposit(uint32_t cell, uint32_t hit) {
+        if (hit) {
+            volume_deposit(volume, cell);
+            deposited++;
+        }
+    }
+
+    void finish() { volume_add_samples(volume, deposited); }
+};
+
+// Advances the ATTRACTOR_MAX_ORBITS orbits in orbit_lanes side by side, so every RK4 stage is a few vector
+// instructions for all of them, and bins each step of each orbit with Binning. The burn in counts steps of every
+// orbit rather than samples, since a flow needs that many steps to forget where it started.
+//
+// Orbits that diverge or come to rest on a fixed point stop being binned, and start over from a random point on the
+// next call. The cold burn in that follows runs every lane, which costs the others nothing but time. Resting orbits
+// matter beyond the one bright pixel they would draw: on an invariant line like Aizawa's z axis the coordinates off the
+// line can decay into denormals, where float steps too coarse to grow back and every operation is many times slower.
+template <typename Flow, typename Binning>
+static void iterate_flow_lanes(Attractor *attractor, const Flow &flow, uint32_t num_iterations) {
+    float(*lanes)[ATTRACTOR_MAX_ORBITS] = attractor->orbit_lanes;
+
+    if (!attractor->orbit_valid) {
+        for (uint32_t d = 0; d < ATTRACTOR_ORBIT_DIMENSIONS; d++) {
+            for (uint32_t l = 0; l < ATTRACTOR_MAX_ORBITS; l++) {
+                lanes[d][l] = attractor_random(attractor) * 2 - 1;
+            }
+        }
+        attractor->orbit_valid = true;
+    }
+
+    float    state[ATTRACTOR_ORBIT_DIMENSIONS][ATTRACTOR_MAX_ORBITS];
+    float    checkpoint[ATTRACTOR_ORBIT_DIMENSIONS][ATTRACTOR_MAX_ORBITS];
+    uint32_t alive[ATTRACTOR_MAX_ORBITS];
+    uint32_t cell[ATTRACTOR_MAX_ORBITS];
+    uint32_t hit[ATTRACTOR_MAX_ORBITS];
+
+    memcpy(state, lanes, sizeof(state));
+
+    for (uint32_t i = 0; i < attractor->burn_in; i++) {
+        for (uint32_t l = 0; l < ATTRACTOR_MAX_ORBITS; l++) {
+            rk4_step(flow, Flow::time_step, state[0][l], state[1][l], state[2][l]);
+        }
+    }
+    attractor->burn_in = 0;
+
+    memcpy(checkpoint, state, sizeof(checkpoint));
+
+    for (uint32_t l = 0; l < ATTRACTOR_MAX_ORBITS; l++) {
+        alive[l] = 1;
+    }
+
+    Binning        binning(attractor);
+    const uint32_t steps = (num_iterations + ATTRACTOR_MAX_ORBITS - 1) / ATTRACTOR_MAX_ORBITS;
+
+    for (uint32_t i = 0; i < steps; i++) {
+        // The last step may have more lanes than samples left, the extra lanes advance but do not deposit
+        uint32_t remaining = num_iterations - i * ATTRACTOR_MAX_ORBITS;
+
+        for (uint32_t l = 0; l < ATTRACTOR_MAX_ORBITS; l++) {
+            rk4_step(flow, Flow::time_step, state[0][l], state[1][l], state[2][l]);
+
+            // Dead orbits are parked at the origin, so they neither overflow the pixel conversion nor slow down the
+            // vector sinf with huge arguments
+            alive[l] &= !(has_diverged(state[0][l]) | has_diverged(state[1][l]) | has_diverged(state[2][l]));
+            state[0][l] = alive[l] ? state[0][l] : 0;
+            state[1][l] = alive[l] ? state[1][l] : 0;
+            state[2][l] = alive[l] ? state[2][l] : 0;
+
+            hit[l] = alive[l] & (l < remaining) & binning.locate(state[0][l], state[1][l], state[2][l], cell[l]);
+        }
+
+        for (uint32_t l = 0; l < ATTRACTOR_MAX_ORBITS; l++) {
+            binning.deposit(cell[l], hit[l]);
+        }
+
+        if ((i + 1) % FLOW_REST_CHECK == 0) {
+            for (uint32_t l = 0; l < ATTRACTOR_MAX_ORBITS; l++) {
+                float moved = fmaxf(fabsf(state[0][l] - checkpoint[0][l]), fabsf(state[1][l] - checkpoint[1][l]));
+                moved       = fmaxf(moved, fabsf(state[2][l] - checkpoint[2][l]));
+
+                alive[l] &= moved > CHAOS_CYCLE_TOLERANCE;
+                checkpoint[0][l] = state[0][l];
+                checkpoint[1][l] = state[1][l];
+                checkpoint[2][l] = state[2][l];
+            }
+        }
+    }
+
+    binning.finish();
+    memcpy(lanes, state, sizeof(state));
+
+    for (uint32_t l = 0; l < ATTRACTOR_MAX_ORBITS; l++) {
+        if (alive[l]) {
+            continue;
+        }
+
+        for (uint32_t d = 0; d < ATTRACTOR_ORBIT_DIMENSIONS; d++) {
+            lanes[d][l] = attractor_random(attractor) * 2 - 1;
+        }
+        attractor->burn_in = ATTRACTOR_COLD_BURN_IN;
+    }
+}
+
+template <typename Flow>
+static void iterate_flow(Attractor *attractor, uint32_t num_iterations) {
+    Flow flow(attractor->parameters);
+
+    update_flow_frame(attractor, flow);
+
+    if (attractor->volume != NULL) {
+        iterate_flow_lanes<Flow, VolumeBinning>(attractor, flow, num_iterations);
+    } else if (attractor->camera_enabled) {
+        iterate_flow_lanes<Flow, MapBinning<CameraProjection> >(attractor, flow, num_iterations);
+    } else {
+        iterate_flow_lanes<Flow, MapBinning<PlaneProjection<Flow> > >(attractor, flow, num_iterations);
+    }
+}
+
+// A sampled flow is a smear, so for bifurcation diagrams each iteration runs the orbit to the next local maximum of
+// the flow's section coordinate and writes the point there, the way the Lorenz and Rossler maps are drawn
+template <typename Flow>
+static void advance_flow(const float *parameters, float *state, uint32_t num_iterations, float *points) {
+    Flow  flow(parameters);
+    float x = state[0];
+    float y = state[1];
+    float z = state[2];
+
+    for (uint32_t i = 0; i < num_iterations; i++) {
+        float last[3] = {x, y, z};
+        bool  rising  = false;
+
+        for (uint32_t s = 0; s < FLOW_SECTION_MAX_STEPS; s++) {
+            rk4_step(flow, Flow::time_step, x, y, z);
+
+            float current[3] = {x, y, z};
+
+            if (rising && current[Flow::section] < last[Flow::section]) {
+                break;
+            }
+
+            rising  = current[Flow::section] > last[Flow::section];
+            last[0] = x;
+            last[1] = y;
+            last[2] = z;
+        }
+
+        if (points != NULL) {
+            points[i * ATTRACTOR_ORBIT_DIMENSIONS + 0] = last[0];
+            points[i * ATTRACTOR_ORBIT_DIMENSIONS + 1] = last[1];
+            points[i * ATTRACTOR_ORBIT_DIMENSIONS + 2] = last[2];
+        }
+    }
+
+    state[0] = x;
+    state[1] = y;
+    state[2] = z;
+}
+
+// Each probe iteration is Flow::probe_steps RK4 steps, so the exponent comes out per sample rather than per step
+template <typename Flow>
+static void probe_flow(Attractor *attractor, uint32_t num_iterations, ChaosProbe *probe) {
+    Flow flow(attractor->parameters);
+
+    float state[3] = {attractor_random(attractor) * 2 - 1, attractor_random(attractor) * 2 - 1,
+                      attractor_random(attractor) * 2 - 1};
+    float shadow[3];
+
+    CycleDetector     cycle;
+    LyapunovEstimator lyapunov;
+    cycle_detector_init(&cycle, state, 3);
+    lyapunov_init(&lyapunov, state, shadow, 3);
+    chaos_probe_init(probe);
+
+    for (uint32_t i = 0; i < num_iterations; i++) {
+        for (uint32_t s = 0; s < Flow::probe_steps; s++) {
+            rk4_step(flow, Flow::time_step, state[0], state[1], state[2]);
+        }
+
+        if (chaos_probe_update(probe, &cycle, state)) {
+            break;
+        }
+
+        for (uint32_t s = 0; s < Flow::probe_steps; s++) {
+            rk4_step(flow, Flow::time_step, shadow[0], shadow[1], shadow[2]);
+        }
+
+        lyapunov_update(&lyapunov, state, shadow, i >= CHAOS_PROBE_WARMUP);
+    }
+
+    chaos_probe_finish(probe, &lyapunov);
+}
+
+#define DEFINE_FLOW_KERNELS(name, Flow)                                                                                \
+    void iterate_##name(Attractor *attractor, uint32_t num_iterations) {                                               \
+        iterate_flow<Flow>(attractor, num_iterations);                                                                 \
+    }                                                                                                                  \
+    void probe_##name(Attractor *attractor, uint32_t num_iterations, ChaosProbe *probe) {                              \
+        probe_flow<Flow>(attractor, num_iterations, probe);                                                            \
+    }                                                                                                                  \
+    void advance_##name(const float *parameters, float *state, uint32_t num_iterations, float *points) {               \
+        advance_flow<Flow>(parameters, state, num_iterations, points);                                                 \
+    }
+
+extern "C" {
+FOR_EACH_FLOW(DEFINE_FLOW_KERNELS)
+}
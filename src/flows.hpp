@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef SRC_FLOWS_HPP_
+#define SRC_FLOWS_HPP_
+
+#include <math.h>
+#include <stdint.h>
+
+// The continuous time attractors with template generated kernels, see FOR_EACH_FLOW in flows_c.h. Each one is a
+// function object like the maps in maps.hpp, but called with a point of the 3D flow to get its velocity there. It
+// must stay branch free, since the kernels run it across SIMD lanes.
+//
+// Besides the equations, each flow picks the two coordinates drawn on the density map, the coordinate whose local
+// maxima sample the orbit for bifurcation diagrams, its integration step, and the steps between the samples of a
+// probe, long enough for the Lyapunov exponent of a typical orbit to clear CHAOS_LYAPUNOV_THRESHOLD per sample.
+
+struct Lorenz {
+    static const uint32_t num_parameters = 3;
+    static const uint32_t axis_x         = 0;
+    static const uint32_t axis_y         = 2;
+    static const uint32_t section        = 2;
+    static const uint32_t probe_steps    = 10;
+
+    static constexpr float time_step = 0.005f;
+
+    float sigma, rho, beta;
+
+    Lorenz() = default;
+    explicit Lorenz(const float *p) : sigma(p[0]), rho(p[1]), beta(p[2]) {}
+
+    void operator()(float x, float y, float z, float &dx, float &dy, float &dz) const {
+        dx = sigma * (y - x);
+        dy = x * (rho - z) - y;
+        dz = x * y - beta * z;
+    }
+};
+
+struct Rossler {
+    static const uint32_t num_parameters = 3;
+    static const uint32_t axis_x         = 0;
+    static const uint32_t axis_y         = 1;
+    static const uint32_t section        = 0;
+    static const uint32_t probe_steps    = 50;
+
+    static constexpr float time_step = 0.02f;
+
+    float a, b, c;
+
+    Rossler() = default;
+    explicit Rossler(const float *p) : a(p[0]), b(p[1]), c(p[2]) {}
+
+    void operator()(float x, float y, float z, float &dx, float &dy, float &dz) const {
+        dx = -y - z;
+        dy = x + a * y;
+        dz = b + z * (x - c);
+    }
+};
+
+struct Aizawa {
+    static const uint32_t num_parameters = 6;
+    static const uint32_t axis_x         = 0;
+    static const uint32_t axis_y         = 2;
+    static const uint32_t section        = 2;
+    static const uint32_t probe_steps    = 50;
+
+    static constexpr float time_step = 0.01f;
+
+    float a, b, c, d, e, f;
+
+    Aizawa() = default;
+    explicit Aizawa(const float *p) : a(p[0]), b(p[1]), c(p[2]), d(p[3]), e(p[4]), f(p[5]) {}
+
+    void operator()(float x, float y, float z, float &dx, float &dy, float &dz) const {
+        dx = (z - b) * x - d * y;
+        dy = d * x + (z - b) * y;
+        dz = c + a * z - z * z * z * (1.0f / 3) - (x * x + y * y) * (1 + e * z) + f * z * x * x * x;
+    }
+};
+
+// Cyclically symmetric, with b as the damping. Its Lyapunov exponent is small, hence the long probe samples.
+struct Thomas {
+    static const uint32_t num_parameters = 1;
+    static const uint32_t axis_x         = 0;
+    static const uint32_t axis_y         = 1;
+    static const uint32_t section        = 2;
+    static const uint32_t probe_steps    = 20;
+
+    static constexpr float time_step = 0.05f;
+
+    float b;
+
+    Thomas() = default;
+    explicit Thomas(const float *p) : b(p[0]) {}
+
+    void operator()(float x, float y, float z, float &dx, float &dy, float &dz) const {
+        dx = sinf(y) - b * x;
+        dy = sinf(z) - b * y;
+        dz = sinf(x) - b * z;
+    }
+};
+
+struct Halvorsen {
+    static const uint32_t num_parameters = 1;
+    static const uint32_t axis_x         = 0;
+    static const uint32_t axis_y         = 1;
+    static const uint32_t section        = 2;
+    static const uint32_t probe_steps    = 10;
+
+    static constexpr float time_step = 0.005f;
+
+    float a;
+
+    Halvorsen() = default;
+    explicit Halvorsen(const float *p) : a(p[0]) {}
+
+    void operator()(float x, float y, float z, float &dx, float &dy, float &dz) const {
+        dx = -a * x - 4 * y - 4 * z - y * y;
+        dy = -a * y - 4 * z - 4 * x - z * z;
+        dz = -a * z - 4 * x - 4 * y - x * x;
+    }
+};
+
+// One classic fourth order Runge-Kutta step of length h. Fixed steps keep every lane in lockstep, and sample the orbit
+// at equal times, so the density map shows where the flow spends its time.
+template <typename Flow>
+static inline void rk4_step(const Flow &flow, float h, float &x, float &y, float &z) {
+    float k1x, k1y, k1z, k2x, k2y, k2z, k3x, k3y, k3z, k4x, k4y, k4z;
+    float half = h * 0.5f;
+
+    flow(x, y, z, k1x, k1y, k1z);
+    flow(x + half * k1x, y + half * k1y, z + half * k1z, k2x, k2y, k2z);
+    flow(x + half * k2x, y + half * k2y, z + half * k2z, k3x, k3y, k3z);
+    flow(x + h * k3x, y + h * k3y, z + h * k3z, k4x, k4y, k4z);
+
+    float sixth = h * (1.0f / 6);
+
+    x += sixth * (k1x + 2 * (k2x + k3x) + k4x);
+    y += sixth * (k1y + 2 * (k2y + k3y) + k4y);
+    z += sixth * (k1z + 2 * (k2z + k3z) + k4z);
+}
+
+#endif // SRC_FLOWS_HPP_
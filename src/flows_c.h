@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef SRC_FLOWS_C_H_
+#define SRC_FLOWS_C_H_
+
+#include <stdint.h>
+
+#include "attractor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Every continuous time attractor with kernels generated from the templates in flows.cpp, as (prefix of the C
+// functions, flow type in flows.hpp). Adding a flow here, to flows.hpp and to the registry in attractor.c is all it
+// takes.
+#define FOR_EACH_FLOW(X)                                                                                               \
+    X(lorenz, Lorenz)                                                                                                  \
+    X(rossler, Rossler)                                                                                                \
+    X(aizawa, Aizawa)                                                                                                  \
+    X(thomas, Thomas)                                                                                                  \
+    X(halvorsen, Halvorsen)
+
+#define DECLARE_FLOW_KERNELS(name, Flow)                                                                               \
+    void iterate_##name(Attractor *attractor, uint32_t num_iterations);                                                \
+    void probe_##name(Attractor *attractor, uint32_t num_iterations, ChaosProbe *probe);                               \
+    void advance_##name(const float *parameters, float *state, uint32_t num_iterations, float *points);
+
+FOR_EACH_FLOW(DECLARE_FLOW_KERNELS)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SRC_FLOWS_C_H_
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "attractor.h"
+#include "gallery.h"
+
+Gallery *gallery_init(AttractorType type, const Atlas *atlas) {
+    Gallery *gallery = malloc(sizeof(Gallery));
+
+    for (uint32_t i = 0; i < GALLERY_SIZE; i++) {
+        GalleryThumbnail *thumbnail = &gallery->thumbnails[i];
+
+        thumbnail->attractor = make_attractor(type, GALLERY_THUMBNAIL_WIDTH, GALLERY_THUMBNAIL_HEIGHT);
+        thumbnail->texture   = 0;
+        set_attractor_atlas(thumbnail->attractor, atlas);
+    }
+
+    gallery_restart(gallery);
+
+    return gallery;
+}
+
+// The GL textures are created by the GUI and live as long as the GL context
+void gallery_destroy(Gallery *gallery) {
+    for (uint32_t i = 0; i < GALLERY_SIZE; i++) {
+        destroy_attractor(gallery->thumbnails[i].attractor);
+    }
+
+    free(gallery);
+}
+
+// Discards all candidates. No worker may be running a gallery tick.
+void gallery_restart(Gallery *gallery) {
+    for (uint32_t i = 0; i < GALLERY_SIZE; i++) {
+        gallery->thumbnails[i].ready    = false;
+        gallery->thumbnails[i].uploaded = false;
+    }
+
+    gallery->next = 0;
+}
+
+// Finds and renders one thumbnail. The data is the Gallery.
+void gallery_tick(void *data) {
+    Gallery *gallery = data;
+    uint32_t index   = __atomic_fetch_add(&gallery->next, 1, __ATOMIC_RELAXED);
+
+    if (index >= GALLERY_SIZE) {
+        // Nothing left to claim, wait for the manager to clear the job
+        struct timespec ts = {0, 1000000};
+        nanosleep(&ts, NULL);
+        return;
+    }
+
+    GalleryThumbnail *thumbnail = &gallery->thumbnails[index];
+
+    while (!randomize_candidate(thumbnail->attractor)) {
+    }
+
+    clean_attractor(thumbnail->attractor);
+    iterate_attractor(thumbnail->attractor, GALLERY_THUMBNAIL_SAMPLES);
+
+    // Pairs with the acquire in gallery_is_ready, so the map is complete once the thumbnail shows as ready
+    __atomic_store_n(&thumbnail->ready, true, __ATOMIC_RELEASE);
+}
+
+bool gallery_is_ready(Gallery *gallery, uint32_t index) {
+    return __atomic_load_n(&gallery->thumbnails[index].ready, __ATOMIC_ACQUIRE);
+}
+
+// Whether any thumbnail was claimed since the last restart, so the gallery shows or is filling in candidates
+bool gallery_is_started(Gallery *gallery) { return __atomic_load_n(&gallery->next, __ATOMIC_RELAXED) > 0; }
+
+bool gallery_is_done(Gallery *gallery) {
+    for (uint32_t i = 0; i < GALLERY_SIZE; i++) {
+        if (!gallery_is_ready(gallery, i)) {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef SRC_GALLERY_H_
+#define SRC_GALLERY_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "attractor.h"
+
+#define GALLERY_SIZE             16
+#define GALLERY_COLUMNS          4
+#define GALLERY_THUMBNAIL_WIDTH  160
+#define GALLERY_THUMBNAIL_HEIGHT 90
+
+// About 20 samples per thumbnail pixel, enough to judge the shape of an attractor
+#define GALLERY_THUMBNAIL_SAMPLES 300000
+
+typedef struct {
+    Attractor *attractor; // Small map, owned by whichever worker claimed the thumbnail
+    bool       ready;     // Set once the worker is done, after which the attractor is read only
+
+    uint32_t texture;  // GL texture, 0 until first uploaded by the GUI
+    bool     uploaded; // The texture shows the current candidate
+} GalleryThumbnail;
+
+// A grid of random chaotic candidates, each found and rendered by a compute worker at thumbnail resolution with a
+// fixed sample budget. Workers claim whole thumbnails, so no two threads ever touch the same map.
+typedef struct {
+    GalleryThumbnail thumbnails[GALLERY_SIZE];
+    uint32_t         next; // Next thumbnail to claim
+} Gallery;
+
+Gallery *gallery_init(AttractorType type, const Atlas *atlas);
+void     gallery_destroy(Gallery *gallery);
+void     gallery_restart(Gallery *gallery);
+void     gallery_tick(void *data);
+bool     gallery_is_ready(Gallery *gallery, uint32_t index);
+bool     gallery_is_started(Gallery *gallery);
+bool     gallery_is_done(Gallery *gallery);
+
+#endif // SRC_GALLERY_H_
@@ -30,12 +30,16 @@
 
 #include <pcg_variants.h>
 
+#include "atlas.h"
 #include "attractor.h"
+#include "custom.h"
 #include "fps.h"
 #include "gui.h"
 #include "imgui_custom_c.h"
 #include "manager.h"
+#include "rendering.h"
 #include "settings.h"
+#include "sprott.h"
 
 // Forward declaration of sigmoid function
 extern float sigmoid_normalize(float x, float midpoint, float steepness);
@@ -46,6 +50,14 @@ struct ImPlotContext *plot_ctx;
 
 char buffer[1024];
 
+// The probe runs a few thousand iterations, so the Lyapunov exponent shown is only redone when the parameters change
+static float lyapunov          = NAN;
+static bool  lyapunov_outdated = true;
+
+// What was typed in the formula box, kept until it is applied, and why the last formula applied was rejected
+static char formula_source[EXPRESSION_MAX_SOURCE];
+static char formula_error[128];
+
 void gui_init() {
     ctx      = igCreateContext(NULL);
     io       = igGetIO();
@@ -80,19 +92,63 @@ void gui_render() {
 
     if (!manager->hide_ui) {
         gui_update_fps();
-        gui_update_clifford();
+        gui_update_attractor();
         gui_update_scaling();
+        gui_update_budget();
+        gui_update_gallery();
+        gui_update_parameter_map();
+        gui_update_bifurcation();
     }
 
     igRender();
     ImGui_ImplOpenGL3_RenderDrawData(igGetDrawData());
 }
 
-void gui_update_clifford() {
-    if (!igBegin("Clifford", NULL, 0))
+static void gui_update_formula() {
+    if (formula_source[0] == '\0') {
+        Expression expression;
+        custom_get_expression(&expression);
+        snprintf(formula_source, sizeof(formula_source), "%s", expression.source);
+    }
+
+    ImVec2 box_size = {0, 100};
+    igInputTextMultiline("Formula", formula_source, sizeof(formula_source), box_size, 0, NULL, NULL);
+
+    ImVec2 formula_button_size = {120, 0};
+    if (igButton("Apply Formula", formula_button_size)) {
+        Expression expression;
+
+        if (expression_parse(formula_source, &expression, formula_error, sizeof(formula_error))) {
+            formula_error[0] = '\0';
+            manager_set_formula(manager, &expression);
+            lyapunov_outdated = true;
+        }
+    }
+
+    if (formula_error[0] != '\0') {
+        ImVec4 error_color = {1.0f, 0.4f, 0.4f, 1.0f};
+        igTextColored(error_color, "%s", formula_error);
+    }
+}
+
+void gui_update_attractor() {
+    if (!igBegin("Attractor", NULL, 0))
         return igEnd();
 
-    Attractor *attractor = manager->attractor;
+    const char *type_names[ATTRACTOR_TYPE_COUNT];
+    for (int i = 0; i < ATTRACTOR_TYPE_COUNT; i++) {
+        type_names[i] = get_attractor_name(i);
+    }
+
+    int type = manager->attractor->type;
+    if (igCombo_Str_arr("Type", &type, type_names, ATTRACTOR_TYPE_COUNT, 0)) {
+        manager_set_attractor_type(manager, type);
+        lyapunov_outdated = true;
+    }
+
+    Attractor *attractor     = manager->attractor;
+    bool       param_changed = false;
+    bool       randomized    = false;
 
     if (attractor->num_parameters > 0) {
         memset(buffer, 0, sizeof(buffer));
@@ -103,27 +159,49 @@ void gui_update_clifford() {
         }
         igText(buffer);
 
+        if (is_sprott_type(attractor->type)) {
+            char code[SPROTT_MAX_CODE_LENGTH];
+            bool exact = sprott_encode(attractor->parameters, attractor->num_parameters, code);
+
+            igText(exact ? "Code: %s" : "Nearest code: %s", code);
+        }
+
         float *old_params = malloc(attractor->num_parameters * sizeof(float));
         for (uint32_t i = 0; i < attractor->num_parameters; i++) {
             old_params[i] = attractor->parameters[i];
         }
 
         char param_name[16];
-        bool param_changed = false;
+        bool dragging = false;
         for (uint32_t i = 0; i < attractor->num_parameters; i++) {
-            if (i < 26) {
+            const char *label = get_attractor_parameter_name(attractor, i);
+
+            if (label != NULL) {
+                snprintf(param_name, sizeof(param_name), "%s", label);
+            } else if (i < 26) {
                 snprintf(param_name, sizeof(param_name), "%c", 'a' + i);
             } else {
                 snprintf(param_name, sizeof(param_name), "param%u", i);
             }
 
-            igSliderFloat(param_name, &attractor->parameters[i], -2, 2, "%2.6f", 0);
+            float min, max;
+            get_attractor_parameter_range(attractor, i, &min, &max);
+
+            igSliderFloat(param_name, &attractor->parameters[i], min, max, "%2.6f", 0);
+            dragging |= igIsItemActive();
 
             if (old_params[i] != attractor->parameters[i]) {
                 param_changed = true;
             }
         }
 
+        // Render at low resolution while a slider is held or the camera is being dragged, and go back to full
+        // resolution once it is released
+        dragging |= manager->camera_dragging;
+        if (dragging != manager->preview_active) {
+            manager_set_preview(manager, dragging);
+        }
+
         if (param_changed) {
             manager_clean_attractor(manager);
             manager_propagate_attractor(manager);
@@ -131,11 +209,73 @@ void gui_update_clifford() {
 
         free(old_params);
 
+        const char *preview_resolutions[] = {"1/4", "1/8"};
+        int         preview_resolution    = manager->preview_downsample == 8;
+        if (igCombo_Str_arr("Drag preview", &preview_resolution, preview_resolutions, 2, 0)) {
+            manager->preview_downsample = preview_resolution ? 8 : 4;
+        }
+
+        if (is_attractor_escape_time(attractor->type)) {
+            igText("Drag the image to pan, scroll to zoom at the cursor");
+            igText("%.3e per pixel%s", manager->escape_view.spacing,
+                   manager->escape_render.perturbed ? ", perturbed" : "");
+
+            ImVec2 view_button_size = {120, 0};
+            if (igButton("Reset View", view_button_size)) {
+                manager_reset_camera(manager);
+            }
+        }
+
+        if (attractor->type == ATTRACTOR_TYPE_CUSTOM) {
+            gui_update_formula();
+        }
+
+        if (manager_has_camera(manager)) {
+            igText("Drag the image to orbit the camera, scroll to zoom");
+
+            ImVec2 camera_button_size = {120, 0};
+            if (igButton("Reset Camera", camera_button_size)) {
+                manager_reset_camera(manager);
+            }
+
+            bool volume_enabled = manager->volume_enabled;
+            if (igCheckbox("Volume", &volume_enabled)) {
+                manager_set_volume(manager, volume_enabled, manager->volume_resolution);
+            }
+
+            if (manager->volume_enabled) {
+                const char    *volume_resolutions[]      = {"128", "256", "512"};
+                const uint32_t volume_resolution_value[] = {128, 256, 512};
+                int            volume_resolution         = 0;
+                for (int i = 0; i < 3; i++) {
+                    if (volume_resolution_value[i] == manager->volume_resolution) {
+                        volume_resolution = i;
+                    }
+                }
+                if (igCombo_Str_arr("Volume resolution", &volume_resolution, volume_resolutions, 3, 0)) {
+                    manager_set_volume(manager, true, volume_resolution_value[volume_resolution]);
+                }
+
+                float absorption = manager->volume_absorption;
+                if (igSliderFloat("Absorption", &absorption, 0, VOLUME_RENDER_MAX_ABSORPTION, "%.2f", 0)) {
+                    manager_set_volume_absorption(manager, absorption);
+                }
+            }
+        }
+
         ImVec2 size = {100, 0};
         if (igButton("Randomize", size)) {
-            randomize_until_chaotic(attractor);
-            manager_propagate_attractor(manager);
+            randomized = true;
+            manager_next_random_attractor(manager);
             manager_clean_attractor(manager);
+            manager_propagate_attractor(manager);
+        }
+        igSameLine(0, -1);
+        igText("%u queued", candidate_queue_size(manager->candidates));
+
+        if (manager->atlas != NULL) {
+            igText("Atlas: %u interesting cells, score here %.2f", manager->atlas->header->num_interesting,
+                   atlas_get_score(manager->atlas, attractor->parameters));
         }
     } else {
         igText("Attractor has no parameters.");
@@ -147,6 +287,19 @@ void gui_update_clifford() {
     snprintf(buffer, sizeof(buffer), "Occupancy: %2.6f", get_occupancy(attractor));
     igText(buffer);
 
+    if (param_changed || randomized) {
+        lyapunov_outdated = true;
+    }
+    if (lyapunov_outdated) {
+        lyapunov          = get_lyapunov_exponent(attractor);
+        lyapunov_outdated = false;
+    }
+
+    if (isfinite(lyapunov)) {
+        snprintf(buffer, sizeof(buffer), "Lyapunov exponent: %2.6f", lyapunov);
+        igText(buffer);
+    }
+
     igSeparator();
 
     // Post-processing parameters
@@ -190,6 +343,240 @@ void gui_update_clifford() {
     return igEnd();
 }
 
+void gui_update_gallery() {
+    if (!igBegin("Gallery", NULL, 0))
+        return igEnd();
+
+    Gallery *gallery = manager->gallery;
+
+    ImVec2 button_size = {120, 0};
+    if (igButton("New Candidates", button_size)) {
+        manager_start_gallery(manager);
+    }
+
+    if (manager->job == MANAGER_JOB_GALLERY) {
+        igSameLine(0, -1);
+        igText("Rendering...");
+    }
+
+    ImVec2 thumbnail_size = {GALLERY_THUMBNAIL_WIDTH, GALLERY_THUMBNAIL_HEIGHT};
+    ImVec2 uv0            = {0, 0};
+    ImVec2 uv1            = {1, 1};
+    ImVec4 background     = {0, 0, 0, 1};
+    ImVec4 tint           = {1, 1, 1, 1};
+
+    for (uint32_t i = 0; i < GALLERY_SIZE; i++) {
+        GalleryThumbnail *thumbnail = &gallery->thumbnails[i];
+
+        if (i % GALLERY_COLUMNS != 0) {
+            igSameLine(0, -1);
+        }
+
+        // Keep the grid in place while the thumbnails fill in
+        if (!gallery_is_ready(gallery, i)) {
+            igDummy(thumbnail_size);
+            continue;
+        }
+
+        if (!thumbnail->uploaded) {
+            if (thumbnail->texture == 0) {
+                glGenTextures(1, &thumbnail->texture);
+            }
+
+            render_attractor_thumbnail(thumbnail->attractor, thumbnail->texture, manager->scaling_method,
+                                       manager->power_exponent, manager->sigmoid_midpoint,
+                                       manager->sigmoid_steepness);
+            thumbnail->uploaded = true;
+        }
+
+        igPushID_Int(i);
+        if (igImageButton("thumbnail", (ImTextureID)(intptr_t)thumbnail->texture, thumbnail_size, uv0, uv1,
+                          background, tint)) {
+            manager_promote_thumbnail(manager, i);
+            manager_clean_attractor(manager);
+            manager_propagate_attractor(manager);
+            lyapunov_outdated = true;
+        }
+        igPopID();
+    }
+
+    return igEnd();
+}
+
+void gui_update_parameter_map() {
+    if (!igBegin("Parameter Map", NULL, 0))
+        return igEnd();
+
+    ParameterMap *map = manager->parameter_map;
+
+    static uint32_t texture        = 0;
+    static float   *texture_data   = NULL;
+    static uint32_t shown_progress = UINT32_MAX; // Work items done when the texture was last updated
+    static int      metric         = PARAMETER_MAP_LYAPUNOV;
+    static bool     metric_changed = false;
+
+    // The view is kept here and handed to the manager on restart, since the workers read the map's own copy
+    static uint32_t axis[2] = {0, 1};
+    static float    min[2]  = {-2, -2};
+    static float    max[2]  = {2, 2};
+
+    bool restart = false;
+
+    const char *parameter_names[] = {"a", "b", "c", "d", "e", "f", "g", "h"};
+    int         num_names         = map->num_parameters < 8 ? map->num_parameters : 8;
+
+    // The attractor may have changed to one with fewer parameters
+    for (int i = 0; i < 2; i++) {
+        if (axis[i] >= num_names) {
+            axis[i] = num_names > i ? i : 0;
+        }
+    }
+
+    int axis_x = axis[0];
+    int axis_y = axis[1];
+
+    if (igCombo_Str_arr("X axis", &axis_x, parameter_names, num_names, 0)) {
+        axis[0] = axis_x;
+        restart = true;
+    }
+
+    if (igCombo_Str_arr("Y axis", &axis_y, parameter_names, num_names, 0)) {
+        axis[1] = axis_y;
+        restart = true;
+    }
+
+    const char *metrics[] = {"Lyapunov exponent", "Coverage"};
+    metric_changed        = igCombo_Str_arr("Color by", &metric, metrics, 2, 0);
+
+    ImVec2 button_size = {120, 0};
+    if (igButton("Render", button_size)) {
+        restart = true;
+    }
+
+    igSameLine(0, -1);
+    if (igButton("Reset View", button_size)) {
+        for (int i = 0; i < 2; i++) {
+            get_attractor_parameter_range(manager->attractor, axis[i], &min[i], &max[i]);
+        }
+        restart = true;
+    }
+
+    if (manager->job == MANAGER_JOB_PARAMETER_MAP) {
+        ImVec2 progress_size = {-1, 0};
+        igProgressBar(parameter_map_get_progress(map), progress_size, NULL);
+    }
+
+    snprintf(buffer, sizeof(buffer), "%c: %.3f to %.3f, %c: %.3f to %.3f", 'a' + axis[0], min[0], max[0],
+             'a' + axis[1], min[1], max[1]);
+    igText("%s", buffer);
+    igText("Left click loads the parameters, right click zooms in");
+
+    // Only rebuilt when a new work item finished, or the colors changed
+    uint32_t progress = __atomic_load_n(&map->completed, __ATOMIC_ACQUIRE);
+    if (progress != shown_progress || metric_changed) {
+        uint32_t size = PARAMETER_MAP_SIZE * PARAMETER_MAP_SIZE;
+
+        if (texture == 0) {
+            glGenTextures(1, &texture);
+            texture_data = malloc(size * 4 * sizeof(float));
+        }
+
+        for (uint32_t i = 0; i < size; i++) {
+            parameter_map_get_color(map, metric, i, texture_data + i * 4);
+        }
+
+        upload_gui_texture(texture, texture_data, PARAMETER_MAP_SIZE, PARAMETER_MAP_SIZE);
+        shown_progress = progress;
+    }
+
+    ImVec2 image_size = {2 * PARAMETER_MAP_SIZE, 2 * PARAMETER_MAP_SIZE};
+    ImVec2 uv0        = {0, 0};
+    ImVec2 uv1        = {1, 1};
+    ImVec4 tint       = {1, 1, 1, 1};
+    ImVec4 border     = {0, 0, 0, 0};
+    igImage((ImTextureID)(intptr_t)texture, image_size, uv0, uv1, tint, border);
+
+    bool picked = igIsItemClicked(0);
+    bool zoomed = igIsItemClicked(1);
+
+    if (picked || zoomed) {
+        ImVec2 mouse;
+        ImVec2 origin;
+        igGetMousePos(&mouse);
+        igGetItemRectMin(&origin);
+
+        float u = fminf(fmaxf((mouse.x - origin.x) / image_size.x, 0), 1);
+        float v = fminf(fmaxf((mouse.y - origin.y) / image_size.y, 0), 1);
+
+        if (picked) {
+            manager_pick_parameter_map(manager, u, v);
+            manager_clean_attractor(manager);
+            manager_propagate_attractor(manager);
+            lyapunov_outdated = true;
+        } else {
+            float center[2] = {min[0] + u * (max[0] - min[0]), max[1] - v * (max[1] - min[1])};
+
+            for (int i = 0; i < 2; i++) {
+                float half_range = (max[i] - min[i]) / 4;
+
+                min[i] = center[i] - half_range;
+                max[i] = center[i] + half_range;
+            }
+            restart = true;
+        }
+    }
+
+    if (restart) {
+        manager_start_parameter_map(manager, axis, min, max);
+    }
+
+    return igEnd();
+}
+
+void gui_update_bifurcation() {
+    if (!igBegin("Bifurcation Diagram", NULL, 0))
+        return igEnd();
+
+    static int   parameter  = 0;
+    static int   coordinate = 0;
+    static float min        = -2;
+    static float max        = 2;
+
+    const char *parameter_names[]  = {"a", "b", "c", "d", "e", "f", "g", "h"};
+    const char *coordinate_names[] = {"x", "y"};
+    int         num_names          = manager->attractor->num_parameters < 8 ? manager->attractor->num_parameters : 8;
+    bool        changed            = false;
+
+    // Switching the attractor type turns the diagram off, and may leave fewer parameters to sweep
+    bool enabled = manager->bifurcation_enabled;
+    if (parameter >= num_names) {
+        parameter = 0;
+    }
+
+    float range_min, range_max;
+    get_attractor_parameter_range(manager->attractor, parameter, &range_min, &range_max);
+
+    changed |= igCheckbox("Show bifurcation diagram", &enabled);
+    changed |= igCombo_Str_arr("Swept parameter", &parameter, parameter_names, num_names, 0);
+    changed |= igCombo_Str_arr("Plotted coordinate", &coordinate, coordinate_names, 2, 0);
+    changed |= igSliderFloat("From", &min, range_min, range_max, "%2.3f", 0);
+    changed |= igSliderFloat("To", &max, range_min, range_max, "%2.3f", 0);
+
+    if (changed && (enabled || manager->bifurcation_enabled)) {
+        manager_set_bifurcation(manager, enabled, parameter, coordinate, min, max);
+    }
+
+    if (manager->bifurcation_enabled) {
+        igText("%s from %.3f to %.3f", coordinate_names[coordinate], manager->bifurcation->low,
+               manager->bifurcation->high);
+    }
+
+    igTextWrapped("The swept parameter runs along x and every column plots the orbit for its value. The other "
+                  "parameters are the ones in the Attractor window.");
+
+    return igEnd();
+}
+
 void gui_update_scaling() {
     if (!igBegin("Scaling Settings", NULL, 0))
         return igEnd();
@@ -197,10 +584,11 @@ void gui_update_scaling() {
     bool update_needed = false;
 
     // Scaling method selection combo
-    const char *scaling_methods[] = {"Linear (Raw)", "Logarithmic", "Power/Gamma", "Sigmoid", "Square Root"};
+    const char *scaling_methods[] = {"Linear (Raw)", "Logarithmic", "Power/Gamma", "Sigmoid", "Square Root",
+                                   "Log Density"};
 
     int current_method = manager->scaling_method;
-    if (igCombo_Str_arr("Scaling Method", &current_method, scaling_methods, 5, 0)) {
+    if (igCombo_Str_arr("Scaling Method", &current_method, scaling_methods, 6, 0)) {
         manager->scaling_method = current_method;
         update_needed           = true;
     }
@@ -230,6 +618,9 @@ void gui_update_scaling() {
 
             case SQRT_SCALING: curve_y[i] = sqrtf(x); break;
 
+            // The real curve depends on the densest pixel, this one is drawn for a million hits
+            case LOG_DENSITY_SCALING: curve_y[i] = logf(1.0f + x * 1e6f) / logf(1.0f + 1e6f); break;
+
             default: curve_y[i] = x; break;
         }
     }
@@ -311,6 +702,11 @@ void gui_update_scaling() {
             igTextWrapped("Square root scaling is a good default that preserves more detail in lower values "
                           "while still maintaining a natural appearance.");
             break;
+
+        case LOG_DENSITY_SCALING:
+            igTextWrapped("Log density scaling takes the logarithm of the hit count itself, so pixels a million times "
+                          "fainter than the brightest one still show. The classic look for fractal flames.");
+            break;
     }
 
     igSeparator();
@@ -415,5 +811,116 @@ void gui_update_fps() {
         ImPlot_EndPlot();
     }
 
+    igSeparator();
+
+    PowerSettings *power            = &manager->power;
+    const char    *power_policies[] = {"Full speed in background", "Polite"};
+    int            current_policy   = power->policy;
+    if (igCombo_Str_arr("Power", &current_policy, power_policies, 2, 0)) {
+        power->policy = current_policy;
+    }
+
+    if (power->policy == POWER_POLICY_POLITE) {
+        igSliderFloat("Background fps", &power->background_frame_rate, 1.0f, 60.0f, "%.0f", 0);
+
+        int worker_cap = power->background_worker_cap;
+        if (igSliderInt("Background workers", &worker_cap, 0, manager->compute_count, "%d", 0)) {
+            power->background_worker_cap = worker_cap;
+        }
+    }
+
+    igEnd();
+}
+
+void gui_update_budget() {
+    if (!igBegin("Render Budget", NULL, 0))
+        return igEnd();
+
+    RenderBudget *budget = &manager->budget;
+
+    const char *budget_modes[] = {"Unlimited", "Samples", "Wall Time"};
+    int         current_mode   = budget->mode;
+    bool        budget_changed = false;
+
+    if (igCombo_Str_arr("Budget", &current_mode, budget_modes, 3, 0)) {
+        budget->mode   = current_mode;
+        budget_changed = true;
+    }
+
+    switch (budget->mode) {
+        case BUDGET_MODE_SAMPLES: {
+            float millions = budget->target_samples / 1e6f;
+            if (igInputFloat("Samples (M)", &millions, 100.0f, 1000.0f, "%.0f", 0)) {
+                budget->target_samples = millions > 0 ? millions * 1e6 : 0;
+                budget_changed         = true;
+            }
+        } break;
+
+        case BUDGET_MODE_TIME:
+            if (igInputFloat("Seconds", &budget->target_seconds, 10.0f, 60.0f, "%.1f", 0)) {
+                budget_changed = true;
+            }
+            break;
+
+        default: break;
+    }
+
+    if (budget_changed) {
+        manager_apply_budget(manager);
+    }
+
+    // Only the seed is exposed, as an int, which is plenty for picking reproducible renders by hand
+    bool deterministic = manager->deterministic;
+    int  seed          = manager->seed;
+    bool seed_changed  = false;
+
+    igCheckbox("Deterministic", &deterministic);
+    if (igIsItemHovered(0)) {
+        igSetTooltip("Same seed and sample budget give the exact same image on any number of threads");
+    }
+
+    if (deterministic) {
+        seed_changed = igInputInt("Seed", &seed, 1, 100, 0);
+    }
+
+    if (deterministic != manager->deterministic || seed_changed) {
+        manager_set_deterministic(manager, deterministic, seed);
+    }
+
+    budget_format_progress(budget, buffer, sizeof(buffer));
+
+    if (budget->mode != BUDGET_MODE_NONE) {
+        ImVec2 progress_size = {-1, 0};
+        igProgressBar(budget_get_progress(budget), progress_size, budget->done ? "Done" : NULL);
+    }
+
+    igTextWrapped("%s", buffer);
+
+    igSeparator();
+
+    Convergence *convergence = &manager->convergence;
+
+    if (igCheckbox("Stop when converged", &convergence->enabled) && !convergence->enabled) {
+        convergence_reset(convergence);
+    }
+    igSliderFloat("Threshold", &convergence->threshold, 0.0001f, 0.01f, "%.4f", 0);
+    if (igIsItemHovered(0)) {
+        igSetTooltip("Largest relative change of any image tile between two snapshots that still counts as stable");
+    }
+
+    if (convergence->converged) {
+        igText("Converged, compute is idle");
+    } else if (isfinite(convergence->change)) {
+        igText("Change: %.4f%% (%u/%u stable)", convergence->change * 100.0f, convergence->stable_checks,
+               convergence->required_checks);
+    } else {
+        igText("Change: -");
+    }
+
+    ImVec2 size = {120, 0};
+    if (igButton("Restart Render", size)) {
+        manager_clean_attractor(manager);
+    }
+
     igEnd();
 }
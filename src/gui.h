@@ -47,7 +47,11 @@ void gui_render();
 void gui_new_frame();
 
 void gui_update_fps();
-void gui_update_clifford();
+void gui_update_attractor();
 void gui_update_scaling();
+void gui_update_budget();
+void gui_update_gallery();
+void gui_update_parameter_map();
+void gui_update_bifurcation();
 
 #endif // SRC_GUI_H_
@@ -22,6 +22,7 @@
 
 #include <cglm/cglm.h>
 
+#include "gui.h"
 #include "input_handling.h"
 #include "manager.h"
 #include "settings.h"
@@ -62,6 +63,11 @@ void mouse_click_callback(GLFWwindow *window, int button, int action, int mods)
         } else if (action == GLFW_RELEASE) {
             left_mouse_pressed = 0;
         }
+
+        // Dragging on the image, and not on a window of the GUI, orbits the camera of 3D attractors and pans escape
+        // time fractals
+        manager->camera_dragging = left_mouse_pressed && !io->WantCaptureMouse &&
+                                   (manager_has_camera(manager) || is_attractor_escape_time(manager->attractor->type));
     }
 }
 
@@ -74,11 +80,30 @@ void mouse_callback(GLFWwindow *window, double xpos, double ypos) {
         lastY      = ypos;
         firstMouse = 0;
     }
+
+    if (manager->camera_dragging && is_attractor_escape_time(manager->attractor->type)) {
+        manager_pan_escape_view(manager, xpos - lastX, ypos - lastY);
+    } else if (manager->camera_dragging) {
+        manager_orbit_camera(manager, xpos - lastX, ypos - lastY);
+    }
+
+    lastX = xpos;
+    lastY = ypos;
 }
 
 void scroll_callback(GLFWwindow *window, double xoffset, double yoffset) {
     if (manager->freeze_movement)
         return;
+
+    if (io->WantCaptureMouse) {
+        return;
+    }
+
+    if (is_attractor_escape_time(manager->attractor->type)) {
+        manager_zoom_escape_view(manager, yoffset, lastX, lastY);
+    } else if (manager_has_camera(manager)) {
+        manager_zoom_camera(manager, yoffset);
+    }
 }
 
 void framebuffer_size_callback(GLFWwindow *window, int width, int height) {
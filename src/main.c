@@ -19,6 +19,8 @@
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
 #include <glad/glad.h>
 
@@ -33,18 +35,130 @@
 
 #include <entropy.h>
 
+#include "atlas.h"
 #include "attractor.h"
+#include "custom.h"
+#include "expression.h"
 #include "gui.h"
 #include "input_handling.h"
 #include "manager.h"
 #include "rendering.h"
 #include "settings.h"
 #include "shader_c.h"
+#include "sprott.h"
 #include "utils.h"
 
 GLFWwindow *window;
 
+typedef struct {
+    uint64_t    budget_samples;
+    float       budget_seconds;
+    uint32_t    threads;
+    bool        deterministic;
+    uint64_t    seed;
+    const char *atlas_path;
+    const char *code;
+    const char *formula_path;
+    Expression  formula;
+} Arguments;
+
+static void print_usage(const char *program) {
+    printf("usage: %s [--samples N] [--time SECONDS] [--threads N] [--deterministic SEED] [--atlas FILE] "
+           "[--code CODE] [--formula FILE]\n",
+           program);
+    printf("  --samples N           stop rendering after N samples (e.g. 2e9)\n");
+    printf("  --time SECONDS        stop rendering after SECONDS of wall time\n");
+    printf("  --threads N           number of compute threads (default 8)\n");
+    printf("  --deterministic SEED  render the same image for the same seed on any number of threads\n");
+    printf("  --atlas FILE          draw random parameters from an atlas built by the scanner (default: %s)\n",
+           ATLAS_DEFAULT_PATH);
+    printf("  --code CODE           start on the Sprott map with this 12 or 20 letter code, see the scanner\n");
+    printf("  --formula FILE        start on a custom attractor with the formula in FILE, see expression.h\n");
+}
+
+static bool load_formula(const char *path, Expression *expression) {
+    char  source[EXPRESSION_MAX_SOURCE];
+    char  error[128];
+    FILE *file = fopen(path, "r");
+
+    if (file == NULL) {
+        printf("could not open %s\n", path);
+        return false;
+    }
+
+    size_t length = fread(source, 1, sizeof(source), file);
+    fclose(file);
+
+    if (length == sizeof(source)) {
+        printf("%s: formula too long, at most %u characters\n", path, EXPRESSION_MAX_SOURCE - 1);
+        return false;
+    }
+    source[length] = '\0';
+
+    if (!expression_parse(source, expression, error, sizeof(error))) {
+        printf("%s: %s\n", path, error);
+        return false;
+    }
+
+    return true;
+}
+
+static bool parse_arguments(int argc, char *argv[], Arguments *arguments) {
+    memset(arguments, 0, sizeof(Arguments));
+
+    for (int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+
+        if (strcmp(argv[i], "--samples") == 0 && has_value) {
+            arguments->budget_samples = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--time") == 0 && has_value) {
+            arguments->budget_seconds = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--threads") == 0 && has_value) {
+            arguments->threads = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--deterministic") == 0 && has_value) {
+            arguments->deterministic = true;
+            arguments->seed          = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--atlas") == 0 && has_value) {
+            arguments->atlas_path = argv[++i];
+        } else if (strcmp(argv[i], "--code") == 0 && has_value) {
+            arguments->code = argv[++i];
+        } else if (strcmp(argv[i], "--formula") == 0 && has_value) {
+            arguments->formula_path = argv[++i];
+        } else {
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+
+    if (arguments->code != NULL) {
+        AttractorType type;
+        float         coefficients[ATTRACTOR_MAX_PARAMETERS];
+
+        if (!sprott_type_from_code(arguments->code, &type) ||
+            !sprott_decode(arguments->code, coefficients, strlen(arguments->code))) {
+            printf("%s is not a Sprott code\n", arguments->code);
+            return false;
+        }
+    }
+
+    if (arguments->code != NULL && arguments->formula_path != NULL) {
+        printf("--code and --formula pick different attractors, use only one\n");
+        return false;
+    }
+
+    if (arguments->formula_path != NULL && !load_formula(arguments->formula_path, &arguments->formula)) {
+        return false;
+    }
+
+    return true;
+}
+
 int main(int argc, char *argv[]) {
+    Arguments arguments;
+    if (!parse_arguments(argc, argv, &arguments)) {
+        return -1;
+    }
+
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
@@ -93,9 +207,50 @@ int main(int argc, char *argv[]) {
         gui_init();
         manager = init_manager();
 
-        manager->attractor =
-            make_attractor(ATTRACTOR_TYPE_CLIFFORD, (1.0f - manager->border_size_percent) * WINDOW_WIDTH,
-                           (1.0f - manager->border_size_percent) * WINDOW_HEIGHT);
+        if (arguments.budget_samples > 0) {
+            budget_set_samples(&manager->budget, arguments.budget_samples);
+        } else if (arguments.budget_seconds > 0) {
+            budget_set_time(&manager->budget, arguments.budget_seconds);
+        }
+
+        if (arguments.threads > 0) {
+            manager->compute_count = arguments.threads;
+        }
+
+        manager->deterministic = arguments.deterministic;
+        manager->seed          = arguments.seed;
+
+        AttractorType type = ATTRACTOR_TYPE_CLIFFORD;
+
+        if (arguments.code != NULL) {
+            sprott_type_from_code(arguments.code, &type);
+        }
+
+        if (arguments.formula_path != NULL) {
+            type = ATTRACTOR_TYPE_CUSTOM;
+            custom_set_expression(&arguments.formula);
+        }
+
+        manager->attractor = make_attractor(type, (1.0f - manager->border_size_percent) * WINDOW_WIDTH,
+                                            (1.0f - manager->border_size_percent) * WINDOW_HEIGHT);
+
+        if (arguments.code != NULL) {
+            sprott_decode(arguments.code, manager->attractor->parameters, manager->attractor->num_parameters);
+        }
+
+        if (arguments.formula_path != NULL) {
+            for (uint32_t i = 0; i < EXPRESSION_NUM_PARAMETERS; i++) {
+                if (arguments.formula.has_parameter[i]) {
+                    manager->attractor->parameters[i] = arguments.formula.parameters[i];
+                }
+            }
+        }
+
+        if (arguments.atlas_path != NULL) {
+            manager_load_atlas(manager, arguments.atlas_path);
+        } else if (access(ATLAS_DEFAULT_PATH, R_OK) == 0) {
+            manager_load_atlas(manager, ATLAS_DEFAULT_PATH);
+        }
     }
 
     // Shaders
@@ -138,10 +293,13 @@ int main(int argc, char *argv[]) {
 
     printf("starting render loop\n");
 
+    float last_progress_report = 0;
+
     while (!glfwWindowShouldClose(window)) {
         // Process input
         glfwPollEvents();
         process_input(window);
+        manager_update_camera(manager);
 
         // Timer
         Manager_tick_timer(manager);
@@ -150,7 +308,32 @@ int main(int argc, char *argv[]) {
             printf("fps: %f\n", 1.0f / manager->delta_time);
         }
 
-        manager_compute_iterate_until_timeout(manager, 1 / 60.0f);
+        power_update_window_state(&manager->power, window);
+
+        // The image can only change if the pool was running during this frame
+        bool was_idle = manager_is_idle(manager);
+
+        manager_compute_iterate_until_timeout(manager, power_get_frame_time(&manager->power));
+        manager_update_budget(manager);
+        manager_update_jobs(manager);
+
+        if (manager->budget.mode != BUDGET_MODE_NONE && !manager->budget.done &&
+            manager->current_time - last_progress_report >= 1.0f) {
+            char progress[256];
+            budget_format_progress(&manager->budget, progress, sizeof(progress));
+            printf("progress: %s\n", progress);
+            last_progress_report = manager->current_time;
+        }
+
+        // Keep merging so convergence still works, but skip the GPU entirely while nothing can be seen. A volume can
+        // still be seen from a new viewpoint once the pool is idle.
+        if (!was_idle || manager->volume_dirty) {
+            update_attractor_texture_data(manager);
+        }
+
+        if (!power_should_present(&manager->power)) {
+            continue;
+        }
 
         // Main pass
         glViewport(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
@@ -160,7 +343,7 @@ int main(int argc, char *argv[]) {
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        blit_attractor_to_texture(manager);
+        upload_attractor_texture(manager);
 
         Shader_use(shader);
 
@@ -194,6 +377,7 @@ int main(int argc, char *argv[]) {
     }
 
     manager_destroy_compute(manager);
+    atlas_close(manager->atlas);
     gui_terminate();
     glfwTerminate();
 
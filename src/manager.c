@@ -27,12 +27,17 @@
 #include <GLFW/glfw3.h>
 
 #include "attractor.h"
+#include "custom.h"
 #include "manager.h"
 #include "rendering.h"
+#include "search.h"
 #include "settings.h"
 
 Manager *manager;
 
+static void manager_apply_job(Manager *manager);
+static void manager_start_escape_render(Manager *manager);
+
 Manager *init_manager() {
     Manager *_manager = malloc(sizeof(Manager));
 
@@ -56,6 +61,17 @@ Manager *init_manager() {
 
     _manager->border_size_percent = 0.05f;
 
+    _manager->preview_downsample = 4;
+    _manager->preview_active     = false;
+
+    _manager->volume_resolution = VOLUME_DEFAULT_RESOLUTION;
+    _manager->volume_absorption = VOLUME_RENDER_DEFAULT_ABSORPTION;
+
+    camera_init(&_manager->camera);
+    budget_init(&_manager->budget);
+    convergence_init(&_manager->convergence, WINDOW_WIDTH, WINDOW_HEIGHT);
+    power_init(&_manager->power);
+
     _manager->texture_data = malloc(WINDOW_WIDTH * WINDOW_HEIGHT * 4 * sizeof(uint32_t));
     for (int i = 0; i < WINDOW_WIDTH; i++) {
         for (int j = 0; j < WINDOW_HEIGHT; j++) {
@@ -89,46 +105,175 @@ void Manager_tick_timer(Manager *manager) {
     manager->frame_count++;
 }
 
+// Rebuilds the merged map from scratch, so it only depends on what the workers accumulated and not on how many
+// frames it was merged for
 void merge_attractors_data(Manager *manager) {
+    clean_attractor(manager->attractor);
+
     for (int i = 0; i < manager->compute_count; i++) {
         Attractor *attractor = manager->computes[i]->attractor;
 
-        for (int j = 0; j < attractor->width * attractor->height; j++) {
+        uint32_t size = get_attractor_map_width(attractor) * get_attractor_map_height(attractor);
+
+        for (int j = 0; j < size; j++) {
             manager->attractor->density_map[j] += attractor->density_map[j];
         }
+
+        if (attractor->color_map != NULL) {
+            for (int j = 0; j < size * 3; j++) {
+                manager->attractor->color_map[j] += attractor->color_map[j];
+            }
+        }
     }
 }
 
-void blit_attractor_to_texture(Manager *manager) {
+// Ray marches the volume into the merged map, when the view changed or every MANAGER_VOLUME_REFRESH_INTERVAL while
+// samples come in. The march runs as a job on every worker, the power cap aside since it is what the user is looking
+// at, and nothing is deposited meanwhile. The workers are left paused.
+static void manager_march_volume(Manager *manager) {
+    float now = glfwGetTime();
+
+    if (!manager->volume_dirty && now - manager->volume_marched_time < MANAGER_VOLUME_REFRESH_INTERVAL) {
+        return;
+    }
+
+    manager_pause_compute(manager);
+    manager_wait_compute_idle(manager);
+
+    VolumeRender *render = &manager->volume_render;
+    volume_render_start(render, manager->volume, &manager->camera, manager->volume_absorption,
+                        manager->attractor->density_map, get_attractor_map_width(manager->attractor),
+                        get_attractor_map_height(manager->attractor));
+
+    for (int i = 0; i < manager->compute_count; i++) {
+        compute_set_job(manager->computes[i], volume_render_tick, render);
+        compute_resume(manager->computes[i]);
+    }
+
+    while (!volume_render_is_done(render)) {
+        struct timespec ts = {0, 100000};
+        nanosleep(&ts, NULL);
+    }
+
+    // Tiles are all done, but the workers may be sleeping in a tick that found none left
+    manager_pause_compute(manager);
+    manager_wait_compute_idle(manager);
+    manager_apply_job(manager);
+
+    manager->volume_dirty        = false;
+    manager->volume_marched_time = now;
+}
+
+// Brings the merged map up to date with whatever the workers accumulate into
+static void manager_gather_attractors_data(Manager *manager) {
+    if (is_attractor_escape_time(manager->attractor->type)) {
+        escape_render_resolve(&manager->escape_render, manager->attractor->density_map);
+    } else if (manager_uses_volume(manager)) {
+        manager_march_volume(manager);
+    } else {
+        merge_attractors_data(manager);
+    }
+}
+
+void update_attractor_texture_data(Manager *manager) {
     clean_texture_data(manager->texture_data, manager->texture_data_gl, WINDOW_WIDTH, WINDOW_HEIGHT);
 
-    merge_attractors_data(manager);
+    manager_gather_attractors_data(manager);
 
     copy_attractor_to_texture_data(manager->attractor, manager->texture_data, WINDOW_WIDTH, WINDOW_HEIGHT,
                                    manager->border_size_percent);
 
     normalize_texture_data(manager->texture_data, manager->texture_data_gl, WINDOW_WIDTH, WINDOW_HEIGHT,
                            manager->scaling_method, manager->power_exponent, manager->sigmoid_midpoint,
-                           manager->sigmoid_steepness);
+                           manager->sigmoid_steepness, manager->attractor->color_map != NULL);
+
+    // A deterministic render has to run to the end of its budget, so it never stops early. Escape time fractals are
+    // done once every tile is, see manager_is_idle. While a background job has the workers the image is frozen rather
+    // than converged, so it is not looked at.
+    if (!manager->deterministic && !is_attractor_escape_time(manager->attractor->type) &&
+        manager->job == MANAGER_JOB_NONE &&
+        convergence_update(&manager->convergence, manager->texture_data_gl, WINDOW_WIDTH, WINDOW_HEIGHT,
+                           glfwGetTime())) {
+        manager_pause_compute(manager);
+        printf("image converged after %.3e samples\n", (double)manager_get_total_samples(manager));
+    }
+
+    manager->texture_dirty = true;
+}
+
+void upload_attractor_texture(Manager *manager) {
+    if (!manager->texture_dirty || !power_should_present(&manager->power)) {
+        return;
+    }
 
     render_texture_to_gl(manager->texture_data_gl, WINDOW_WIDTH, WINDOW_HEIGHT);
+    manager->texture_dirty = false;
+}
+
+void blit_attractor_to_texture(Manager *manager) {
+    update_attractor_texture_data(manager);
+    upload_attractor_texture(manager);
+}
+
+// Points the workers of a 3D attractor at the camera or at the volume, and the others back at their plane. The workers
+// must be paused and idle.
+static void manager_apply_camera(Manager *manager) {
+    float   view_projection[16];
+    bool    enabled = is_attractor_3d(manager->attractor->type);
+    float   aspect  = (float)manager->attractor->width / manager->attractor->height;
+    Volume *volume  = manager_uses_volume(manager) ? manager->volume : NULL;
+
+    camera_get_view_projection(&manager->camera, aspect, view_projection);
+
+    for (int i = 0; i < manager->compute_count; i++) {
+        set_attractor_camera(manager->computes[i]->attractor, enabled ? view_projection : NULL);
+        set_attractor_volume(manager->computes[i]->attractor, volume);
+    }
 }
 
 void manager_init_compute(Manager *manager) {
     manager->computes = malloc(manager->compute_count * sizeof(Compute *));
 
     for (int i = 0; i < manager->compute_count; i++) {
-        Attractor *attractor =
-            make_attractor(ATTRACTOR_TYPE_CLIFFORD, (1.0f - manager->border_size_percent) * WINDOW_WIDTH,
-                           (1.0f - manager->border_size_percent) * WINDOW_HEIGHT);
+        Attractor *attractor = make_attractor(manager->attractor->type, manager->attractor->width,
+                                              manager->attractor->height);
+        set_attractor_downsample(attractor, manager->attractor->downsample);
         manager->computes[i] = compute_init(attractor);
     }
+
+    manager_apply_camera(manager);
+    escape_view_reset(&manager->escape_view, manager->attractor->type == ATTRACTOR_TYPE_JULIA,
+                      manager->attractor->height);
+
+    manager->candidates    = candidate_queue_init(manager->attractor->type, manager->atlas);
+    manager->job           = MANAGER_JOB_NONE;
+    manager->gallery       = gallery_init(manager->attractor->type, manager->atlas);
+    manager->parameter_map = parameter_map_init(manager->attractor->type, manager->compute_count);
+    manager->bifurcation   = bifurcation_init(manager->attractor->width);
+
+    manager_start_escape_render(manager);
+    manager_apply_job(manager);
+
+    manager_apply_budget(manager);
+    budget_reset(&manager->budget, glfwGetTime());
 }
 
 void manager_destroy_compute(Manager *manager) {
     for (int i = 0; i < manager->compute_count; i++) {
+        Attractor *attractor = manager->computes[i]->attractor;
+
         compute_destroy(manager->computes[i]);
+        destroy_attractor(attractor);
     }
+
+    free(manager->computes);
+    manager->computes = NULL;
+
+    candidate_queue_destroy(manager->candidates);
+    gallery_destroy(manager->gallery);
+    parameter_map_destroy(manager->parameter_map);
+    bifurcation_destroy(manager->bifurcation);
+    escape_render_destroy(&manager->escape_render);
 }
 
 void manager_pause_compute(Manager *manager) {
@@ -138,15 +283,31 @@ void manager_pause_compute(Manager *manager) {
 }
 
 void manager_resume_compute(Manager *manager) {
+    uint32_t worker_cap = power_get_worker_cap(&manager->power, manager->compute_count);
+
     for (int i = 0; i < manager->compute_count; i++) {
-        compute_resume(manager->computes[i]);
+        if (i < worker_cap) {
+            compute_resume(manager->computes[i]);
+        } else {
+            compute_pause(manager->computes[i]);
+        }
+    }
+}
+
+void manager_wait_compute_idle(Manager *manager) {
+    for (int i = 0; i < manager->compute_count; i++) {
+        compute_wait_idle(manager->computes[i]);
     }
 }
 
 void manager_compute_iterate_until_timeout(Manager *manager, float timeout) {
     float start_time = glfwGetTime();
 
-    manager_resume_compute(manager);
+    // Once idle the workers stay paused, but we still wait so the frame pacing is kept. Background jobs have nothing to
+    // do with the render, so they keep going either way.
+    if (!manager_is_idle(manager) || manager->job != MANAGER_JOB_NONE) {
+        manager_resume_compute(manager);
+    }
 
     while (glfwGetTime() - start_time < timeout) {
         // Sleep for 1ms
@@ -158,11 +319,32 @@ void manager_compute_iterate_until_timeout(Manager *manager, float timeout) {
 }
 
 void manager_clean_attractor(Manager *manager) {
+    // No tick can be in flight, or it would add samples from before the clean to the new render
+    manager_pause_compute(manager);
+    manager_wait_compute_idle(manager);
+
     clean_attractor(manager->attractor);
 
     for (int i = 0; i < manager->compute_count; i++) {
         compute_clean_attractor(manager->computes[i]);
     }
+
+    __atomic_store_n(&manager->schedule.next_block, 0, __ATOMIC_RELAXED);
+
+    if (manager->bifurcation_enabled) {
+        bifurcation_reset(manager->bifurcation, manager->attractor);
+    }
+
+    if (manager->volume != NULL) {
+        volume_clear(manager->volume);
+        manager->volume_dirty = true;
+    }
+
+    manager_start_escape_render(manager);
+
+    manager_apply_budget(manager);
+    budget_reset(&manager->budget, glfwGetTime());
+    convergence_reset(&manager->convergence);
 }
 
 void manager_reset_attractor(Manager *manager) {
@@ -173,10 +355,466 @@ void manager_reset_attractor(Manager *manager) {
     }
 }
 
+// Workers keep their orbits across parameter changes, see set_attractor_parameters. That writes to their attractors,
+// so the workers must be paused and idle, which manager_clean_attractor leaves them.
 void manager_propagate_attractor(Manager *manager) {
     for (int i = 0; i < manager->compute_count; i++) {
-        for (int j = 0; j < manager->attractor->num_parameters; j++) {
-            manager->computes[i]->attractor->parameters[j] = manager->attractor->parameters[j];
+        set_attractor_parameters(manager->computes[i]->attractor, manager->attractor->parameters);
+    }
+}
+
+// Points every worker at the current background job. The workers must be paused and idle.
+static void manager_apply_job(Manager *manager) {
+    for (int i = 0; i < manager->compute_count; i++) {
+        switch (manager->job) {
+            case MANAGER_JOB_GALLERY: compute_set_job(manager->computes[i], gallery_tick, manager->gallery); break;
+            case MANAGER_JOB_PARAMETER_MAP:
+                compute_set_job(manager->computes[i], parameter_map_tick, &manager->parameter_map->workers[i]);
+                break;
+            default:
+                if (is_attractor_escape_time(manager->attractor->type)) {
+                    compute_set_job(manager->computes[i], escape_render_tick, &manager->escape_render);
+                } else {
+                    compute_clear_job(manager->computes[i]);
+                }
+                break;
         }
     }
 }
+
+// Renders escape time fractals again from the current view and parameters. The workers must be paused and idle.
+static void manager_start_escape_render(Manager *manager) {
+    if (is_attractor_escape_time(manager->attractor->type)) {
+        escape_render_start(&manager->escape_render, &manager->escape_view, manager->attractor);
+    }
+}
+
+// Called once per frame. Gives the workers back to the render once the background job is done.
+void manager_update_jobs(Manager *manager) {
+    bool done = false;
+
+    switch (manager->job) {
+        case MANAGER_JOB_GALLERY: done = gallery_is_done(manager->gallery); break;
+        case MANAGER_JOB_PARAMETER_MAP: done = parameter_map_is_done(manager->parameter_map); break;
+        default: break;
+    }
+
+    if (!done) {
+        return;
+    }
+
+    manager_pause_compute(manager);
+    manager_wait_compute_idle(manager);
+
+    manager->job = MANAGER_JOB_NONE;
+    manager_apply_job(manager);
+
+    // The snapshots taken before the job no longer tell how far the render is from converging
+    convergence_reset(&manager->convergence);
+}
+
+// Runs randomize_until_chaotic on every worker at once and puts the first chaotic candidate found into the manager's
+// attractor. The power policy worker cap is ignored, since the user is waiting on the result. The render is left
+// paused, so the caller has to clean and then propagate the new parameters.
+void manager_randomize_until_chaotic(Manager *manager) {
+    manager_pause_compute(manager);
+    manager_wait_compute_idle(manager);
+
+    Search *search = search_init(manager->attractor->type, manager->compute_count, manager->atlas);
+
+    for (int i = 0; i < manager->compute_count; i++) {
+        compute_set_job(manager->computes[i], search_tick, &search->workers[i]);
+        compute_resume(manager->computes[i]);
+    }
+
+    search_join(search);
+
+    // The losers may still be finishing the candidate they were on
+    manager_pause_compute(manager);
+    manager_wait_compute_idle(manager);
+
+    // Hand the workers back to the background job it interrupted, if any
+    manager_apply_job(manager);
+
+    reset_attractor(manager->attractor);
+    memcpy(manager->attractor->parameters, search->parameters, search->num_parameters * sizeof(float));
+
+    search_destroy(search);
+}
+
+// Takes the next candidate from the background queue, and only searches on the spot when the queue ran dry. Like
+// manager_randomize_until_chaotic, the caller has to clean and then propagate the new parameters.
+void manager_next_random_attractor(Manager *manager) {
+    float *parameters = malloc(manager->attractor->num_parameters * sizeof(float));
+
+    if (candidate_queue_pop(manager->candidates, parameters)) {
+        reset_attractor(manager->attractor);
+        memcpy(manager->attractor->parameters, parameters, manager->attractor->num_parameters * sizeof(float));
+    } else {
+        manager_randomize_until_chaotic(manager);
+    }
+
+    free(parameters);
+}
+
+// Throws away the current thumbnails and has the workers fill the gallery with new candidates. The render is paused
+// until the gallery is done, which takes a few frames.
+void manager_start_gallery(Manager *manager) {
+    manager_pause_compute(manager);
+    manager_wait_compute_idle(manager);
+
+    gallery_restart(manager->gallery);
+
+    manager->job = MANAGER_JOB_GALLERY;
+    manager_apply_job(manager);
+}
+
+// Makes a thumbnail the main attractor. Like manager_randomize_until_chaotic, the caller has to clean and then
+// propagate the new parameters.
+void manager_promote_thumbnail(Manager *manager, uint32_t index) {
+    Attractor *thumbnail = manager->gallery->thumbnails[index].attractor;
+
+    reset_attractor(manager->attractor);
+    memcpy(manager->attractor->parameters, thumbnail->parameters, thumbnail->num_parameters * sizeof(float));
+}
+
+// Restarts the parameter map with a new view. The parameters that are not on an axis are taken from the current
+// attractor.
+void manager_start_parameter_map(Manager *manager, const uint32_t *axis, const float *min, const float *max) {
+    ParameterMap *map = manager->parameter_map;
+
+    manager_pause_compute(manager);
+    manager_wait_compute_idle(manager);
+
+    memcpy(map->parameters, manager->attractor->parameters, map->num_parameters * sizeof(float));
+
+    for (int i = 0; i < 2; i++) {
+        map->axis[i] = axis[i] < map->num_parameters ? axis[i] : 0;
+        map->min[i]  = min[i];
+        map->max[i]  = max[i];
+    }
+
+    parameter_map_restart(map);
+
+    manager->job = MANAGER_JOB_PARAMETER_MAP;
+    manager_apply_job(manager);
+}
+
+// Loads the parameters under a point of the map, in the same coordinates as parameter_map_get_parameters. Like
+// manager_randomize_until_chaotic, the caller has to clean and then propagate the new parameters.
+void manager_pick_parameter_map(Manager *manager, float u, float v) {
+    float parameters[ATTRACTOR_MAX_PARAMETERS];
+
+    parameter_map_get_parameters(manager->parameter_map, u, v, parameters);
+    memcpy(manager->attractor->parameters, parameters, manager->attractor->num_parameters * sizeof(float));
+}
+
+uint64_t manager_get_total_samples(Manager *manager) {
+    uint64_t samples = 0;
+
+    for (int i = 0; i < manager->compute_count; i++) {
+        samples += compute_get_samples(manager->computes[i]);
+    }
+
+    return samples;
+}
+
+// Refills the sample pool the workers draw from, or sets up the block schedule in deterministic mode. Must be called
+// whenever the budget changes or the render restarts.
+void manager_apply_budget(Manager *manager) {
+    uint64_t      *sample_pool = NULL;
+    BlockSchedule *schedule    = NULL;
+
+    if (manager->deterministic) {
+        manager->schedule.seed          = manager->seed;
+        manager->schedule.block_size    = COMPUTE_BLOCK_SIZE;
+        manager->schedule.total_samples = UINT64_MAX;
+
+        if (manager->budget.mode == BUDGET_MODE_SAMPLES) {
+            manager->schedule.total_samples = manager->budget.target_samples;
+        }
+
+        schedule = &manager->schedule;
+    } else if (manager->budget.mode == BUDGET_MODE_SAMPLES) {
+        uint64_t remaining = budget_get_remaining_samples(&manager->budget, manager_get_total_samples(manager));
+        __atomic_store_n(&manager->sample_pool, remaining, __ATOMIC_RELAXED);
+        sample_pool = &manager->sample_pool;
+    }
+
+    for (int i = 0; i < manager->compute_count; i++) {
+        compute_set_sample_pool(manager->computes[i], sample_pool);
+        compute_set_schedule(manager->computes[i], schedule);
+    }
+
+    manager->budget.done = false;
+}
+
+// Returns true on the frame the budget is reached
+bool manager_update_budget(Manager *manager) {
+    if (!budget_update(&manager->budget, manager_get_total_samples(manager), glfwGetTime())) {
+        return false;
+    }
+
+    manager_pause_compute(manager);
+
+    printf("render budget reached: %.3e samples in %.2fs\n", (double)manager->budget.samples,
+           manager->budget.elapsed);
+
+    if (manager->deterministic) {
+        manager_wait_compute_idle(manager);
+        manager->volume_dirty = true;
+        manager_gather_attractors_data(manager);
+        printf("density checksum: %016llx\n", (unsigned long long)get_density_checksum(manager->attractor));
+    }
+
+    return true;
+}
+
+// The pool is idle when there is nothing left to add to the image, either because the budget was spent or because
+// new samples no longer change it. Escape time fractals are idle once every pixel is rendered.
+bool manager_is_idle(Manager *manager) {
+    if (is_attractor_escape_time(manager->attractor->type)) {
+        return escape_render_is_done(&manager->escape_render);
+    }
+
+    return manager->budget.done || manager->convergence.converged;
+}
+
+// While previewing, every map accumulates at a fraction of the resolution, so the image fills in within a few
+// milliseconds. Switching in either direction restarts the render, unless it comes from a volume, which does not
+// depend on the resolution of the maps and is only marched again.
+void manager_set_preview(Manager *manager, bool enabled) {
+    uint32_t downsample = enabled ? manager->preview_downsample : 1;
+
+    manager->preview_active = enabled;
+
+    manager_pause_compute(manager);
+    manager_wait_compute_idle(manager);
+
+    set_attractor_downsample(manager->attractor, downsample);
+
+    for (int i = 0; i < manager->compute_count; i++) {
+        set_attractor_downsample(manager->computes[i]->attractor, downsample);
+    }
+
+    if (manager_uses_volume(manager)) {
+        manager->volume_dirty = true;
+        return;
+    }
+
+    manager_clean_attractor(manager);
+}
+
+// In deterministic mode the merged image only depends on the seed, the parameters and the number of samples, so
+// the same render gives a bit identical density map on any number of threads. Restarts the render.
+void manager_set_deterministic(Manager *manager, bool enabled, uint64_t seed) {
+    manager->deterministic = enabled;
+    manager->seed          = seed;
+
+    manager_clean_attractor(manager);
+}
+
+// Switches the workers between the attractor and its bifurcation diagram, sweeping parameter from min to max along x
+// and plotting coordinate along y. Restarts the render. Columns keep their orbits between blocks, so deterministic
+// renders of a diagram are not bit identical.
+void manager_set_bifurcation(Manager *manager, bool enabled, uint32_t parameter, uint32_t coordinate, float min,
+                             float max) {
+    manager_pause_compute(manager);
+    manager_wait_compute_idle(manager);
+
+    manager->bifurcation_enabled     = enabled;
+    manager->bifurcation->parameter  = parameter < manager->attractor->num_parameters ? parameter : 0;
+    manager->bifurcation->coordinate = coordinate < ATTRACTOR_ORBIT_DIMENSIONS ? coordinate : 0;
+    manager->bifurcation->min        = min;
+    manager->bifurcation->max        = max;
+
+    for (int i = 0; i < manager->compute_count; i++) {
+        compute_set_bifurcation(manager->computes[i], enabled ? manager->bifurcation : NULL);
+    }
+
+    manager_apply_camera(manager);
+    manager_clean_attractor(manager);
+}
+
+// Switches to another kind of attractor, with its default parameters. The workers and the background jobs are all
+// built for one type, so they are torn down and made again. The atlas stays loaded, and is used again once an
+// attractor of the type it was built for is back. Restarts the render.
+void manager_set_attractor_type(Manager *manager, AttractorType type) {
+    if (type >= ATTRACTOR_TYPE_COUNT || type == manager->attractor->type) {
+        return;
+    }
+
+    manager_pause_compute(manager);
+    manager_wait_compute_idle(manager);
+    manager_destroy_compute(manager);
+
+    Attractor *attractor = make_attractor(type, manager->attractor->width, manager->attractor->height);
+    set_attractor_downsample(attractor, manager->attractor->downsample);
+    set_attractor_atlas(attractor, manager->atlas);
+
+    destroy_attractor(manager->attractor);
+    manager->attractor           = attractor;
+    manager->bifurcation_enabled = false;
+
+    // Colored attractors, flames and the Buddhabrot, span too many densities for the other scalings
+    if (attractor->color_map != NULL) {
+        manager->scaling_method = LOG_DENSITY_SCALING;
+    }
+
+    manager_init_compute(manager);
+    manager_clean_attractor(manager);
+}
+
+// Installs the formula of the custom attractors. The parameter values it gives replace the current ones, and a custom
+// attractor on screen starts over with it. Candidates found under the old formula are thrown away, the queued ones
+// by starting the queue over and the thumbnails by refilling the gallery.
+void manager_set_formula(Manager *manager, const Expression *expression) {
+    custom_set_expression(expression);
+
+    if (manager->attractor->type != ATTRACTOR_TYPE_CUSTOM) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < EXPRESSION_NUM_PARAMETERS; i++) {
+        if (expression->has_parameter[i]) {
+            manager->attractor->parameters[i] = expression->parameters[i];
+        }
+    }
+
+    manager_clean_attractor(manager);
+    manager_propagate_attractor(manager);
+
+    candidate_queue_destroy(manager->candidates);
+    manager->candidates = candidate_queue_init(manager->attractor->type, manager->atlas);
+
+    if (gallery_is_started(manager->gallery)) {
+        manager_start_gallery(manager);
+    }
+}
+
+// Only 3D attractors are viewed through the camera, and not while their bifurcation diagram is shown
+bool manager_has_camera(Manager *manager) {
+    return is_attractor_3d(manager->attractor->type) && !manager->bifurcation_enabled;
+}
+
+void manager_orbit_camera(Manager *manager, float delta_x, float delta_y) {
+    camera_orbit(&manager->camera, delta_x, delta_y);
+    manager->camera_changed = true;
+}
+
+void manager_zoom_camera(Manager *manager, float steps) {
+    camera_zoom(&manager->camera, steps);
+    manager->camera_changed = true;
+}
+
+// Also takes escape time fractals back to the whole set
+void manager_reset_camera(Manager *manager) {
+    camera_init(&manager->camera);
+    escape_view_reset(&manager->escape_view, manager->attractor->type == ATTRACTOR_TYPE_JULIA,
+                      manager->attractor->height);
+    manager->camera_changed = true;
+}
+
+// Drags the view of escape time fractals by a distance in pixels of the window, y pointing down like the cursor
+void manager_pan_escape_view(Manager *manager, float delta_x, float delta_y) {
+    EscapeView *view = &manager->escape_view;
+
+    escape_view_pan(view, -delta_x * view->spacing, delta_y * view->spacing);
+    manager->camera_changed = true;
+}
+
+// Zooms escape time fractals in by steps of the scroll wheel, out for negative steps, keeping the point under the
+// cursor in place. The cursor is in pixels of the window, from its top left corner.
+void manager_zoom_escape_view(Manager *manager, float steps, float window_x, float window_y) {
+    float offset_x = window_x - WINDOW_WIDTH * manager->border_size_percent - manager->attractor->width * 0.5f;
+    float offset_y = WINDOW_HEIGHT - window_y - WINDOW_HEIGHT * manager->border_size_percent -
+                     manager->attractor->height * 0.5f;
+
+    escape_view_zoom(&manager->escape_view, pow(MANAGER_ESCAPE_ZOOM_STEP, -steps), offset_x, offset_y);
+    manager->camera_changed = true;
+}
+
+// Called once per frame, so a drag moving the camera many times between two frames only restarts the render once.
+// Only the maps are cleaned: the workers keep their orbits, which are still on the attractor, and the new view fills
+// in from the first tick instead of waiting out a burn in. A volume holds every view at once, so it is only marched
+// again. Escape time fractals render the new view of the plane from scratch.
+void manager_update_camera(Manager *manager) {
+    if (!manager->camera_changed) {
+        return;
+    }
+
+    manager->camera_changed = false;
+
+    if (is_attractor_escape_time(manager->attractor->type)) {
+        manager_clean_attractor(manager);
+        return;
+    }
+
+    if (!manager_has_camera(manager)) {
+        return;
+    }
+
+    if (manager_uses_volume(manager)) {
+        manager->volume_dirty = true;
+        return;
+    }
+
+    manager_pause_compute(manager);
+    manager_wait_compute_idle(manager);
+
+    manager_apply_camera(manager);
+    manager_clean_attractor(manager);
+}
+
+bool manager_uses_volume(Manager *manager) { return manager->volume_enabled && manager_has_camera(manager); }
+
+// Switches the workers of 3D attractors between drawing through the camera and filling a volume with resolution
+// voxels per side. Restarts the render. The volume is kept while it is disabled, unless its resolution changes.
+void manager_set_volume(Manager *manager, bool enabled, uint32_t resolution) {
+    manager_pause_compute(manager);
+    manager_wait_compute_idle(manager);
+
+    if (manager->volume != NULL && manager->volume->resolution != resolution) {
+        volume_destroy(manager->volume);
+        manager->volume = NULL;
+    }
+
+    if (enabled && manager->volume == NULL) {
+        manager->volume = volume_init(resolution);
+    }
+
+    manager->volume_enabled    = enabled;
+    manager->volume_resolution = manager->volume != NULL ? manager->volume->resolution : resolution;
+
+    manager_apply_camera(manager);
+    manager_clean_attractor(manager);
+}
+
+// Only changes how the volume is drawn, so it is marched again without a restart
+void manager_set_volume_absorption(Manager *manager, float absorption) {
+    manager->volume_absorption = absorption;
+    manager->volume_dirty      = true;
+}
+
+// Must be called before manager_init_compute, which hands the atlas to the background searches
+bool manager_load_atlas(Manager *manager, const char *path) {
+    Atlas *atlas = atlas_open(path);
+
+    if (atlas == NULL) {
+        return false;
+    }
+
+    if (!set_attractor_atlas(manager->attractor, atlas)) {
+        printf("atlas %s was built for another attractor, ignoring it\n", path);
+        atlas_close(atlas);
+        return false;
+    }
+
+    printf("loaded atlas %s: %u of %u cells are interesting\n", path, atlas->header->num_interesting,
+           atlas->header->num_cells);
+
+    atlas_close(manager->atlas);
+    manager->atlas = atlas;
+
+    return true;
+}
@@ -22,9 +22,35 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "atlas.h"
 #include "attractor.h"
+#include "bifurcation.h"
+#include "budget.h"
+#include "camera.h"
+#include "candidates.h"
 #include "compute.h"
+#include "convergence.h"
+#include "escape_time.h"
+#include "escape_view.h"
+#include "expression.h"
+#include "gallery.h"
+#include "parameter_map.h"
+#include "power.h"
 #include "rendering.h" // For ScalingMethod enum
+#include "volume.h"
+#include "volume_render.h"
+
+// While samples are coming in, the volume is marched again this often, in seconds
+#define MANAGER_VOLUME_REFRESH_INTERVAL 0.25f
+// Every step of the scroll wheel zooms escape time fractals in or out by this factor
+#define MANAGER_ESCAPE_ZOOM_STEP 1.25
+
+// Background work the compute workers do instead of rendering, until it is done
+typedef enum {
+    MANAGER_JOB_NONE,
+    MANAGER_JOB_GALLERY,
+    MANAGER_JOB_PARAMETER_MAP,
+} ManagerJob;
 
 typedef struct {
     /////////////////
@@ -58,6 +84,7 @@ typedef struct {
 
     uint32_t *texture_data;
     float    *texture_data_gl;
+    bool      texture_dirty; // texture_data_gl has changes that were not uploaded yet
 
     // Unique value counts
     uint32_t unique_clifford_values;
@@ -66,11 +93,41 @@ typedef struct {
 
     float border_size_percent;
 
+    // Low resolution rendering while parameters are being dragged
+    uint32_t preview_downsample;
+    bool     preview_active;
+
     //////////////////
     // Attractors
     //
     Attractor *attractor;
 
+    // Renders a bifurcation diagram of the attractor instead of the attractor itself
+    bool         bifurcation_enabled;
+    Bifurcation *bifurcation;
+
+    // Views attractors with 3D orbits. Moved by the input callbacks, and handed to the workers once per frame by
+    // manager_update_camera.
+    Camera camera;
+    bool   camera_changed;
+    bool   camera_dragging;
+
+    // Optional for 3D attractors. The workers fill a volume instead of their maps, and the image is ray marched from
+    // it, so moving the camera only marches again instead of restarting the render. Allocated when first enabled.
+    bool         volume_enabled;
+    uint32_t     volume_resolution;
+    float        volume_absorption;
+    Volume      *volume;
+    VolumeRender volume_render;
+    bool         volume_dirty; // The view changed since the last march
+    float        volume_marched_time;
+
+    // Where escape time fractals are looked at, moved by the input callbacks like the camera. They have no samples to
+    // take, so rendering the view is the job of the workers whenever they have no other, and every clean starts it
+    // over. Tiles come in over a few frames, from the center out.
+    EscapeView   escape_view;
+    EscapeRender escape_render;
+
     /////////////////
     // GUI
     //
@@ -81,6 +138,30 @@ typedef struct {
     //
     uint32_t  compute_count;
     Compute **computes;
+
+    // Chaotic parameter sets found in the background, for instant Randomize
+    CandidateQueue *candidates;
+
+    // Optional, mapped at startup. Every random search draws from its interesting cells.
+    Atlas *atlas;
+
+    // Background jobs. While one is active the workers run it instead of rendering.
+    ManagerJob    job;
+    Gallery      *gallery;
+    ParameterMap *parameter_map;
+
+    RenderBudget budget;
+    uint64_t     sample_pool;
+    Convergence  convergence;
+
+    bool          deterministic;
+    uint64_t      seed;
+    BlockSchedule schedule;
+
+    /////////////////
+    // Power
+    //
+    PowerSettings power;
 } Manager;
 
 extern Manager *manager;
@@ -89,17 +170,50 @@ Manager *init_manager();
 
 void Manager_tick_timer(Manager *manager);
 
+void update_attractor_texture_data(Manager *manager);
+void upload_attractor_texture(Manager *manager);
 void blit_attractor_to_texture(Manager *manager);
 
 void manager_init_compute(Manager *manager);
 void manager_destroy_compute(Manager *manager);
 void manager_pause_compute(Manager *manager);
 void manager_resume_compute(Manager *manager);
+void manager_wait_compute_idle(Manager *manager);
 void manager_clean_attractor(Manager *manager);
 void manager_reset_attractor(Manager *manager);
 
 void manager_compute_iterate_until_timeout(Manager *manager, float timeout);
+void manager_randomize_until_chaotic(Manager *manager);
+void manager_next_random_attractor(Manager *manager);
+
+void manager_update_jobs(Manager *manager);
+void manager_start_gallery(Manager *manager);
+void manager_promote_thumbnail(Manager *manager, uint32_t index);
+void manager_start_parameter_map(Manager *manager, const uint32_t *axis, const float *min, const float *max);
+void manager_pick_parameter_map(Manager *manager, float u, float v);
+
+uint64_t manager_get_total_samples(Manager *manager);
+void     manager_apply_budget(Manager *manager);
+bool     manager_update_budget(Manager *manager);
+bool     manager_is_idle(Manager *manager);
 
 void manager_propagate_attractor(Manager *manager);
+void manager_set_preview(Manager *manager, bool enabled);
+void manager_set_deterministic(Manager *manager, bool enabled, uint64_t seed);
+void manager_set_attractor_type(Manager *manager, AttractorType type);
+void manager_set_formula(Manager *manager, const Expression *expression);
+bool manager_has_camera(Manager *manager);
+void manager_orbit_camera(Manager *manager, float delta_x, float delta_y);
+void manager_zoom_camera(Manager *manager, float steps);
+void manager_reset_camera(Manager *manager);
+void manager_pan_escape_view(Manager *manager, float delta_x, float delta_y);
+void manager_zoom_escape_view(Manager *manager, float steps, float window_x, float window_y);
+void manager_update_camera(Manager *manager);
+bool manager_uses_volume(Manager *manager);
+void manager_set_volume(Manager *manager, bool enabled, uint32_t resolution);
+void manager_set_volume_absorption(Manager *manager, float absorption);
+void manager_set_bifurcation(Manager *manager, bool enabled, uint32_t parameter, uint32_t coordinate, float min,
+                             float max);
+bool manager_load_atlas(Manager *manager, const char *path);
 
 #endif // SRC_MANAGER_H_
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+// Scalar kernels of the 2D maps, generated from one template per kernel and instantiated for every map in
+// FOR_EACH_MAP. The render kernel and the batch probes live in maps_batch.cpp, which is built with the SIMD flags.
+
+#include <math.h>
+
+#include "chaos.h"
+#include "maps.hpp"
+#include "maps_c.h"
+
+template <typename Map>
+static void advance_map(const float *parameters, float *state, uint32_t num_iterations, float *points) {
+    Map   map(parameters);
+    float x = state[0];
+    float y = state[1];
+
+    for (uint32_t i = 0; i < num_iterations; i++) {
+        map(x, y, x, y);
+
+        if (points != NULL) {
+            points[i * ATTRACTOR_ORBIT_DIMENSIONS + 0] = x;
+            points[i * ATTRACTOR_ORBIT_DIMENSIONS + 1] = y;
+            points[i * ATTRACTOR_ORBIT_DIMENSIONS + 2] = 0;
+        }
+    }
+
+    state[0] = x;
+    state[1] = y;
+}
+
+template <typename Map>
+static void probe_map(Attractor *attractor, uint32_t num_iterations, ChaosProbe *probe) {
+    Map map(attractor->parameters);
+
+    float state[2] = {attractor_random(attractor) * 2 - 1, attractor_random(attractor) * 2 - 1};
+    float shadow[2];
+
+    CycleDetector     cycle;
+    LyapunovEstimator lyapunov;
+    cycle_detector_init(&cycle, state, 2);
+    lyapunov_init(&lyapunov, state, shadow, 2);
+    chaos_probe_init(probe);
+
+    for (uint32_t i = 0; i < num_iterations; i++) {
+        map(state[0], state[1], state[0], state[1]);
+
+        if (chaos_probe_update(probe, &cycle, state)) {
+            break;
+        }
+
+        map(shadow[0], shadow[1], shadow[0], shadow[1]);
+
+        lyapunov_update(&lyapunov, state, shadow, i >= CHAOS_PROBE_WARMUP);
+    }
+
+    chaos_probe_finish(probe, &lyapunov);
+}
+
+#define DEFINE_MAP_KERNELS(name, Map)                                                                                  \
+    void probe_##name(Attractor *attractor, uint32_t num_iterations, ChaosProbe *probe) {                              \
+        probe_map<Map>(attractor, num_iterations, probe);                                                              \
+    }                                                                                                                  \
+    void advance_##name(const float *parameters, float *state, uint32_t num_iterations, float *points) {               \
+        advance_map<Map>(parameters, state, num_iterations, points);                                                   \
+    }
+
+extern "C" {
+FOR_EACH_MAP(DEFINE_MAP_KERNELS)
+}
@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef SRC_MAPS_HPP_
+#define SRC_MAPS_HPP_
+
+#include <math.h>
+#include <stdint.h>
+
+// The 2D maps with template generated kernels, see FOR_EACH_MAP in maps_c.h. Each one is a function object: built
+// once from the parameters, so whatever it derives from them is hoisted out of the kernel loops, then called with a
+// point to get the next one. It must stay branch free, since the batch kernels run it across SIMD lanes.
+
+// Cosine of an angle whose sine is taken as well. GCC fuses such a pair into one sincosf call, which has no vector
+// version and keeps the batch probes from vectorizing, so it is taken as a shifted sine instead.
+static inline float cos_beside_sin(float angle) { return sinf(angle + 1.57079632679f); }
+
+struct DeJong {
+    static const uint32_t num_parameters = 4;
+
+    float a, b, c, d;
+
+    DeJong() = default;
+    explicit DeJong(const float *p) : a(p[0]), b(p[1]), c(p[2]), d(p[3]) {}
+
+    void operator()(float x, float y, float &next_x, float &next_y) const {
+        next_x = sinf(a * y) - cosf(b * x);
+        next_y = sinf(c * x) - cosf(d * y);
+    }
+};
+
+struct Henon {
+    static const uint32_t num_parameters = 2;
+
+    float a, b;
+
+    Henon() = default;
+    explicit Henon(const float *p) : a(p[0]), b(p[1]) {}
+
+    void operator()(float x, float y, float &next_x, float &next_y) const {
+        next_x = 1 - a * x * x + y;
+        next_y = b * x;
+    }
+};
+
+struct Svensson {
+    static const uint32_t num_parameters = 4;
+
+    float a, b, c, d;
+
+    Svensson() = default;
+    explicit Svensson(const float *p) : a(p[0]), b(p[1]), c(p[2]), d(p[3]) {}
+
+    void operator()(float x, float y, float &next_x, float &next_y) const {
+        next_x = d * sinf(a * x) - sinf(b * y);
+        next_y = c * cos_beside_sin(a * x) + cos_beside_sin(b * y);
+    }
+};
+
+struct Bedhead {
+    static const uint32_t num_parameters = 2;
+
+    float a, inverse_b;
+
+    Bedhead() = default;
+    explicit Bedhead(const float *p) : a(p[0]), inverse_b(1 / p[1]) {}
+
+    void operator()(float x, float y, float &next_x, float &next_y) const {
+        next_x = sinf(x * y * inverse_b) * y + cosf(a * x - y);
+        next_y = x + sinf(y) * inverse_b;
+    }
+};
+
+struct Tinkerbell {
+    static const uint32_t num_parameters = 4;
+
+    float a, b, c, d;
+
+    Tinkerbell() = default;
+    explicit Tinkerbell(const float *p) : a(p[0]), b(p[1]), c(p[2]), d(p[3]) {}
+
+    void operator()(float x, float y, float &next_x, float &next_y) const {
+        next_x = x * x - y * y + a * x + b * y;
+        next_y = 2 * x * y + c * x + d * y;
+    }
+};
+
+// x' = y + alpha (1 - sigma y^2) y + f(x), y' = -x + f(x'), with f(x) = mu x + 2 (1 - mu) x^2 / (1 + x^2)
+struct GumowskiMira {
+    static const uint32_t num_parameters = 3;
+
+    float alpha, sigma, mu, two_one_minus_mu;
+
+    GumowskiMira() = default;
+    explicit GumowskiMira(const float *p) : alpha(p[0]), sigma(p[1]), mu(p[2]), two_one_minus_mu(2 * (1 - p[2])) {}
+
+    float f(float x) const { return mu * x + two_one_minus_mu * x * x / (1 + x * x); }
+
+    void operator()(float x, float y, float &next_x, float &next_y) const {
+        float new_x = y + alpha * (1 - sigma * y * y) * y + f(x);
+
+        next_y = -x + f(new_x);
+        next_x = new_x;
+    }
+};
+
+// x' = 1 + u (x cos t - y sin t), y' = u (x sin t + y cos t), with t = 0.4 - 6 / (1 + x^2 + y^2)
+struct Ikeda {
+    static const uint32_t num_parameters = 1;
+
+    float u;
+
+    Ikeda() = default;
+    explicit Ikeda(const float *p) : u(p[0]) {}
+
+    void operator()(float x, float y, float &next_x, float &next_y) const {
+        float t = 0.4f - 6 / (1 + x * x + y * y);
+        float s = sinf(t);
+        float c = cos_beside_sin(t);
+
+        next_x = 1 + u * (x * c - y * s);
+        next_y = u * (x * s + y * c);
+    }
+};
+
+// Sprott's general quadratic map, x' = a0 + a1 x + a2 x^2 + a3 x y + a4 y + a5 y^2 and the same for y' with a6 to a11
+struct SprottQuadratic {
+    static const uint32_t num_parameters = 12;
+
+    float a[num_parameters];
+
+    SprottQuadratic() = default;
+    explicit SprottQuadratic(const float *p) {
+        for (uint32_t i = 0; i < num_parameters; i++) {
+            a[i] = p[i];
+        }
+    }
+
+    void operator()(float x, float y, float &next_x, float &next_y) const {
+        float xx = x * x;
+        float xy = x * y;
+        float yy = y * y;
+
+        next_x = a[0] + a[1] * x + a[2] * xx + a[3] * xy + a[4] * y + a[5] * yy;
+        next_y = a[6] + a[7] * x + a[8] * xx + a[9] * xy + a[10] * y + a[11] * yy;
+    }
+};
+
+// Sprott's general cubic map, with the terms 1, x, x^2, x^3, x^2 y, x y, x y^2, y, y^2 and y^3 in that order
+struct SprottCubic {
+    static const uint32_t num_parameters = 20;
+
+    float a[num_parameters];
+
+    SprottCubic() = default;
+    explicit SprottCubic(const float *p) {
+        for (uint32_t i = 0; i < num_parameters; i++) {
+            a[i] = p[i];
+        }
+    }
+
+    void operator()(float x, float y, float &next_x, float &next_y) const {
+        float xx  = x * x;
+        float xy  = x * y;
+        float yy  = y * y;
+        float xxx = xx * x;
+        float xxy = xx * y;
+        float xyy = xy * y;
+        float yyy = yy * y;
+
+        next_x = a[0] + a[1] * x + a[2] * xx + a[3] * xxx + a[4] * xxy + a[5] * xy + a[6] * xyy + a[7] * y +
+                 a[8] * yy + a[9] * yyy;
+        next_y = a[10] + a[11] * x + a[12] * xx + a[13] * xxx + a[14] * xxy + a[15] * xy + a[16] * xyy + a[17] * y +
+                 a[18] * yy + a[19] * yyy;
+    }
+};
+
+#endif // SRC_MAPS_HPP_
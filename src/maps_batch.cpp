@@ -0,0 +1,468 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+// Lane kernels of the 2D maps, generated from one template each like the kernels in maps.cpp: the render kernel, one
+// orbit per lane, and the batch probes, one parameter set per lane. Built with the vector math flags, see SIMD_FLAGS
+// in the Makefile and clifford_batch.c. Under -ffast-math isfinite can not be relied on, so divergence is read from
+// the exponent bits instead.
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "chaos.h"
+#include "maps.hpp"
+#include "maps_c.h"
+
+// A float whose biased exponent reaches this is at least 2^20, about CHAOS_DIVERGENCE_LIMIT. Infinities and NaNs have
+// the largest exponent, so they are caught as well.
+#define MAP_BATCH_DIVERGED_EXPONENT (127 + 20)
+// Steps between checks for lanes that diverged or settled. A lane back where it was at the previous check is on a
+// fixed point or a cycle whose period divides this, which covers most of the cycles random parameters end up on.
+#define MAP_BATCH_RETIRE_CHECK 64
+// Steps after the warmup whose bounding box frames the coverage grid. Unlike Clifford, the maps have no closed form
+// bounds to lay it over.
+#define MAP_BATCH_FRAME_STEPS 256
+
+// Iterations each fixed start runs before and while measuring the frame
+#define MAP_FRAME_BURN_IN    1024
+#define MAP_FRAME_ITERATIONS 8192
+// Fraction of the measured extent added on every side of the frame
+#define MAP_FRAME_MARGIN 0.05f
+// Frame used when no start settles on something worth drawing
+#define MAP_FRAME_FALLBACK 2.0f
+
+static inline uint32_t has_diverged(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    return ((bits >> 23) & 0xff) >= MAP_BATCH_DIVERGED_EXPONENT;
+}
+
+// State of CHAOS_BATCH_LANES probes in structure of arrays form, one parameter set per lane
+template <typename Map>
+struct MapLanes {
+    // Transposed, so each parameter of all lanes is loaded at once. An array of Map would take a gather per parameter,
+    // which GCC gives up on for the larger maps.
+    float parameters[Map::num_parameters][CHAOS_BATCH_LANES];
+
+    float    x[CHAOS_BATCH_LANES];
+    float    y[CHAOS_BATCH_LANES];
+    float    shadow_x[CHAOS_BATCH_LANES];
+    float    shadow_y[CHAOS_BATCH_LANES];
+    float    log_sum[CHAOS_BATCH_LANES];
+    uint32_t diverged[CHAOS_BATCH_LANES];
+    uint32_t settled[CHAOS_BATCH_LANES];
+    float    checkpoint_x[CHAOS_BATCH_LANES];
+    float    checkpoint_y[CHAOS_BATCH_LANES];
+
+    float min_x[CHAOS_BATCH_LANES];
+    float max_x[CHAOS_BATCH_LANES];
+    float min_y[CHAOS_BATCH_LANES];
+    float max_y[CHAOS_BATCH_LANES];
+
+    // Maps the bounding box of the first MAP_BATCH_FRAME_STEPS steps after the warmup onto the coverage grid
+    float    origin_x[CHAOS_BATCH_LANES];
+    float    origin_y[CHAOS_BATCH_LANES];
+    float    cell_scale_x[CHAOS_BATCH_LANES];
+    float    cell_scale_y[CHAOS_BATCH_LANES];
+    uint32_t cell[CHAOS_BATCH_LANES];
+    uint32_t coverage[CHAOS_BATCH_LANES][CHAOS_COVERAGE_GRID]; // One bit per cell
+};
+
+// Same contract as probe_clifford_lanes. Diverged lanes are parked at the origin, so the vector sinf and cosf never
+// see the huge arguments that send them down their slow scalar paths.
+template <typename Map>
+static void probe_map_lanes(const float *parameters, const float *states, uint32_t count, uint32_t num_iterations,
+                            ChaosProbe *probes) {
+    MapLanes<Map> lanes;
+
+    const uint32_t frame_end = CHAOS_PROBE_WARMUP + MAP_BATCH_FRAME_STEPS;
+
+    memset(lanes.coverage, 0, sizeof(lanes.coverage));
+
+    for (uint32_t l = 0; l < CHAOS_BATCH_LANES; l++) {
+        uint32_t source = l < count ? l : 0;
+
+        for (uint32_t k = 0; k < Map::num_parameters; k++) {
+            lanes.parameters[k][l] = parameters[source * Map::num_parameters + k];
+        }
+
+        lanes.x[l]            = states[source * 2 + 0];
+        lanes.y[l]            = states[source * 2 + 1];
+        lanes.shadow_x[l]     = lanes.x[l] + CHAOS_LYAPUNOV_SEPARATION;
+        lanes.shadow_y[l]     = lanes.y[l];
+        lanes.log_sum[l]      = 0;
+        lanes.diverged[l]     = 0;
+        lanes.settled[l]      = 0;
+        lanes.checkpoint_x[l] = CHAOS_DIVERGENCE_LIMIT; // Far from any orbit that has not diverged
+        lanes.checkpoint_y[l] = CHAOS_DIVERGENCE_LIMIT;
+
+        lanes.min_x[l] = INFINITY;
+        lanes.max_x[l] = -INFINITY;
+        lanes.min_y[l] = INFINITY;
+        lanes.max_y[l] = -INFINITY;
+    }
+
+    for (uint32_t i = 0; i < num_iterations; i++) {
+        float accumulate = i >= CHAOS_PROBE_WARMUP ? 1 : 0;
+
+        for (uint32_t l = 0; l < CHAOS_BATCH_LANES; l++) {
+            // Unrolled so the loop over the lanes stays free of control flow, which GCC does not do on its own for
+            // the 20 parameters of the cubic map
+            float lane_parameters[Map::num_parameters];
+#pragma GCC unroll 32
+            for (uint32_t k = 0; k < Map::num_parameters; k++) {
+                lane_parameters[k] = lanes.parameters[k][l];
+            }
+
+            Map   map(lane_parameters);
+            float x, y, shadow_x, shadow_y;
+
+            map(lanes.x[l], lanes.y[l], x, y);
+            map(lanes.shadow_x[l], lanes.shadow_y[l], shadow_x, shadow_y);
+
+            uint32_t diverged = lanes.diverged[l] | has_diverged(x) | has_diverged(y) | has_diverged(shadow_x) |
+                                has_diverged(shadow_y);
+
+            // Selects rather than multiplications, since a NaN times zero is still a NaN
+            x        = diverged ? 0 : x;
+            y        = diverged ? 0 : y;
+            shadow_x = diverged ? CHAOS_LYAPUNOV_SEPARATION : shadow_x;
+            shadow_y = diverged ? 0 : shadow_y;
+
+            float delta_x  = shadow_x - x;
+            float delta_y  = shadow_y - y;
+            float distance = fmaxf(sqrtf(delta_x * delta_x + delta_y * delta_y), 1e-30f);
+            float scale    = CHAOS_LYAPUNOV_SEPARATION / distance;
+
+            lanes.log_sum[l] += accumulate * logf(distance / CHAOS_LYAPUNOV_SEPARATION);
+
+            lanes.x[l]        = x;
+            lanes.y[l]        = y;
+            lanes.shadow_x[l] = x + delta_x * scale;
+            lanes.shadow_y[l] = y + delta_y * scale;
+            lanes.diverged[l] = diverged;
+        }
+
+        // Most of the random parameters of some maps diverge or settle within a few steps, where a scalar probe
+        // would stop, so the batch stops as soon as none of its lanes is left
+        if (i % MAP_BATCH_RETIRE_CHECK == MAP_BATCH_RETIRE_CHECK - 1) {
+            uint32_t active = 0;
+
+            for (uint32_t l = 0; l < CHAOS_BATCH_LANES; l++) {
+                float x         = lanes.x[l];
+                float y         = lanes.y[l];
+                float tolerance = CHAOS_CYCLE_TOLERANCE * (1 + fabsf(x) + fabsf(y));
+
+                lanes.settled[l] |= fabsf(x - lanes.checkpoint_x[l]) + fabsf(y - lanes.checkpoint_y[l]) <= tolerance;
+                lanes.checkpoint_x[l] = x;
+                lanes.checkpoint_y[l] = y;
+
+                active += !lanes.diverged[l] && !lanes.settled[l];
+            }
+
+            if (active == 0) {
+                break;
+            }
+        }
+
+        if (i < CHAOS_PROBE_WARMUP) {
+            continue;
+        }
+
+        for (uint32_t l = 0; l < CHAOS_BATCH_LANES; l++) {
+            lanes.min_x[l] = fminf(lanes.min_x[l], lanes.x[l]);
+            lanes.max_x[l] = fmaxf(lanes.max_x[l], lanes.x[l]);
+            lanes.min_y[l] = fminf(lanes.min_y[l], lanes.y[l]);
+            lanes.max_y[l] = fmaxf(lanes.max_y[l], lanes.y[l]);
+        }
+
+        if (i + 1 < frame_end) {
+            continue;
+        }
+
+        if (i + 1 == frame_end) {
+            for (uint32_t l = 0; l < CHAOS_BATCH_LANES; l++) {
+                lanes.origin_x[l]     = lanes.min_x[l];
+                lanes.origin_y[l]     = lanes.min_y[l];
+                lanes.cell_scale_x[l] = CHAOS_COVERAGE_GRID / fmaxf(lanes.max_x[l] - lanes.min_x[l], CHAOS_MIN_EXTENT);
+                lanes.cell_scale_y[l] = CHAOS_COVERAGE_GRID / fmaxf(lanes.max_y[l] - lanes.min_y[l], CHAOS_MIN_EXTENT);
+            }
+        }
+
+        for (uint32_t l = 0; l < CHAOS_BATCH_LANES; l++) {
+            float    cell_x = (lanes.x[l] - lanes.origin_x[l]) * lanes.cell_scale_x[l];
+            float    cell_y = (lanes.y[l] - lanes.origin_y[l]) * lanes.cell_scale_y[l];
+            uint32_t column = fminf(fmaxf(cell_x, 0), CHAOS_COVERAGE_GRID - 1);
+            uint32_t row    = fminf(fmaxf(cell_y, 0), CHAOS_COVERAGE_GRID - 1);
+
+            lanes.cell[l] = row * CHAOS_COVERAGE_GRID + column;
+        }
+
+        // The scatter into the bitmaps is the only part that stays scalar
+        for (uint32_t l = 0; l < CHAOS_BATCH_LANES; l++) {
+            uint32_t cell = lanes.cell[l];
+
+            lanes.coverage[l][cell / CHAOS_COVERAGE_GRID] |= 1u << (cell % CHAOS_COVERAGE_GRID);
+        }
+    }
+
+    for (uint32_t l = 0; l < count; l++) {
+        ChaosProbe *probe = &probes[l];
+
+        chaos_probe_init(probe);
+        probe->iterations = num_iterations;
+
+        if (lanes.diverged[l]) {
+            probe->classification = ORBIT_DIVERGENT;
+            continue;
+        }
+
+        // The period is only known to divide MAP_BATCH_RETIRE_CHECK, so it is left at zero
+        if (lanes.settled[l]) {
+            probe->classification = ORBIT_PERIODIC;
+            continue;
+        }
+
+        if (num_iterations <= CHAOS_PROBE_WARMUP) {
+            continue;
+        }
+
+        probe->has_lyapunov = true;
+        probe->lyapunov     = lanes.log_sum[l] / (num_iterations - CHAOS_PROBE_WARMUP);
+        probe->min[0]       = lanes.min_x[l];
+        probe->max[0]       = lanes.max_x[l];
+        probe->min[1]       = lanes.min_y[l];
+        probe->max[1]       = lanes.max_y[l];
+
+        chaos_probe_classify_by_lyapunov(probe);
+
+        if (num_iterations <= frame_end) {
+            continue;
+        }
+
+        uint32_t cells = 0;
+        for (uint32_t row = 0; row < CHAOS_COVERAGE_GRID; row++) {
+            cells += __builtin_popcount(lanes.coverage[l][row]);
+        }
+
+        probe->has_coverage = true;
+        probe->coverage     = (float)cells / (CHAOS_COVERAGE_GRID * CHAOS_COVERAGE_GRID);
+    }
+}
+
+// Unlike Clifford, these maps have no closed form bounds, so the frame is measured from a few orbits. The starts are
+// fixed rather than drawn from the rng, so every worker measures the same frame for the same parameters.
+template <typename Map>
+static void measure_map_frame(Attractor *attractor, const Map &map) {
+    static const float starts[][2] = {{0.1f, 0.1f}, {-0.5f, 0.3f}, {0.7f, -0.2f}, {-0.2f, -0.6f}};
+
+    float min[2] = {INFINITY, INFINITY};
+    float max[2] = {-INFINITY, -INFINITY};
+
+    for (uint32_t s = 0; s < sizeof(starts) / sizeof(starts[0]); s++) {
+        float x = starts[s][0];
+        float y = starts[s][1];
+
+        for (uint32_t i = 0; i < MAP_FRAME_BURN_IN; i++) {
+            map(x, y, x, y);
+        }
+
+        float start_min[2] = {x, y};
+        float start_max[2] = {x, y};
+        bool  bounded      = true;
+
+        for (uint32_t i = 0; i < MAP_FRAME_ITERATIONS && bounded; i++) {
+            map(x, y, x, y);
+
+            bounded      = !(has_diverged(x) | has_diverged(y));
+            start_min[0] = fminf(start_min[0], x);
+            start_max[0] = fmaxf(start_max[0], x);
+            start_min[1] = fminf(start_min[1], y);
+            start_max[1] = fmaxf(start_max[1], y);
+        }
+
+        // Orbits escaping to infinity would stretch the frame until the attractor is a single pixel, and so would a
+        // far away fixed point or cycle coexisting with the attractor
+        bool collapsed =
+            start_max[0] - start_min[0] <= CHAOS_MIN_EXTENT && start_max[1] - start_min[1] <= CHAOS_MIN_EXTENT;
+
+        if (!bounded || collapsed) {
+            continue;
+        }
+
+        for (uint32_t d = 0; d < 2; d++) {
+            min[d] = fminf(min[d], start_min[d]);
+            max[d] = fmaxf(max[d], start_max[d]);
+        }
+    }
+
+    for (uint32_t d = 0; d < 2; d++) {
+        float extent = max[d] - min[d];
+
+        if (!(extent > CHAOS_MIN_EXTENT)) {
+            min[d] = -MAP_FRAME_FALLBACK;
+            max[d] = MAP_FRAME_FALLBACK;
+            extent = max[d] - min[d];
+        }
+
+        attractor->frame_min[d] = min[d] - extent * MAP_FRAME_MARGIN;
+        attractor->frame_max[d] = max[d] + extent * MAP_FRAME_MARGIN;
+    }
+
+    memcpy(attractor->frame_parameters, attractor->parameters, attractor->num_parameters * sizeof(float));
+    attractor->frame_valid = true;
+}
+
+// The frame is only measured again when the parameters changed since the last time
+template <typename Map>
+static void update_map_frame(Attractor *attractor, const Map &map) {
+    if (attractor->frame_valid &&
+        memcmp(attractor->frame_parameters, attractor->parameters, attractor->num_parameters * sizeof(float)) == 0) {
+        return;
+    }
+
+    measure_map_frame(attractor, map);
+}
+
+// Advances the ATTRACTOR_MAX_ORBITS orbits in orbit_lanes side by side, like iterate_flow_lanes, so every step is a
+// few vector instructions for all of them. The scaling onto the density map is hoisted out of the loop, and points
+// outside of the frame are counted as zero hits on a clamped pixel instead of branching.
+//
+// Orbits that diverge are parked at the origin and stop being drawn, and start over from a random point on the next
+// call, after a cold burn in.
+template <typename Map>
+static void iterate_map(Attractor *attractor, uint32_t num_iterations) {
+    Map map(attractor->parameters);
+
+    update_map_frame(attractor, map);
+
+    float(*lanes)[ATTRACTOR_MAX_ORBITS] = attractor->orbit_lanes;
+
+    if (!attractor->orbit_valid) {
+        for (uint32_t d = 0; d < 2; d++) {
+            for (uint32_t l = 0; l < ATTRACTOR_MAX_ORBITS; l++) {
+                lanes[d][l] = attractor_random(attractor) * 2 - 1;
+            }
+        }
+        attractor->orbit_valid = true;
+    }
+
+    float    x[ATTRACTOR_MAX_ORBITS];
+    float    y[ATTRACTOR_MAX_ORBITS];
+    uint32_t alive[ATTRACTOR_MAX_ORBITS];
+    uint32_t cell[ATTRACTOR_MAX_ORBITS];
+    uint32_t hit[ATTRACTOR_MAX_ORBITS];
+
+    for (uint32_t l = 0; l < ATTRACTOR_MAX_ORBITS; l++) {
+        x[l]     = lanes[0][l];
+        y[l]     = lanes[1][l];
+        alive[l] = 1;
+    }
+
+    for (uint32_t i = 0; i < attractor->burn_in; i++) {
+        for (uint32_t l = 0; l < ATTRACTOR_MAX_ORBITS; l++) {
+            map(x[l], y[l], x[l], y[l]);
+        }
+    }
+    attractor->burn_in = 0;
+
+    const uint32_t width   = get_attractor_map_width(attractor);
+    const uint32_t height  = get_attractor_map_height(attractor);
+    const float    min_x   = attractor->frame_min[0];
+    const float    min_y   = attractor->frame_min[1];
+    const float    scale_x = width / (attractor->frame_max[0] - min_x);
+    const float    scale_y = height / (attractor->frame_max[1] - min_y);
+    const uint32_t steps   = (num_iterations + ATTRACTOR_MAX_ORBITS - 1) / ATTRACTOR_MAX_ORBITS;
+
+    uint32_t *density_map = attractor->density_map;
+
+    for (uint32_t i = 0; i < steps; i++) {
+        // The last step may have more lanes than samples left, the extra lanes advance but do not deposit
+        uint32_t remaining = num_iterations - i * ATTRACTOR_MAX_ORBITS;
+
+        for (uint32_t l = 0; l < ATTRACTOR_MAX_ORBITS; l++) {
+            map(x[l], y[l], x[l], y[l]);
+
+            // Selects rather than multiplications, since a NaN times zero is still a NaN
+            alive[l] &= !(has_diverged(x[l]) | has_diverged(y[l]));
+            x[l] = alive[l] ? x[l] : 0;
+            y[l] = alive[l] ? y[l] : 0;
+
+            float pixel_x = (x[l] - min_x) * scale_x;
+            float pixel_y = (y[l] - min_y) * scale_y;
+
+            uint32_t inside = alive[l] & (l < remaining) & (pixel_x >= 0) & (pixel_x < width) & (pixel_y >= 0) &
+                              (pixel_y < height);
+            uint32_t column = inside ? (uint32_t)pixel_x : 0;
+            uint32_t row    = inside ? (uint32_t)pixel_y : 0;
+
+            cell[l] = column + row * width;
+            hit[l]  = inside;
+        }
+
+        for (uint32_t l = 0; l < ATTRACTOR_MAX_ORBITS; l++) {
+            density_map[cell[l]] += hit[l];
+        }
+    }
+
+    for (uint32_t l = 0; l < ATTRACTOR_MAX_ORBITS; l++) {
+        lanes[0][l] = x[l];
+        lanes[1][l] = y[l];
+
+        if (alive[l]) {
+            continue;
+        }
+
+        lanes[0][l]        = attractor_random(attractor) * 2 - 1;
+        lanes[1][l]        = attractor_random(attractor) * 2 - 1;
+        attractor->burn_in = ATTRACTOR_COLD_BURN_IN;
+    }
+}
+
+// parameters holds count sets of Map::num_parameters, one per candidate. The starting points are drawn from the
+// attractor's rng.
+template <typename Map>
+static void probe_map_batch(Attractor *attractor, const float *parameters, uint32_t count, uint32_t num_iterations,
+                            ChaosProbe *probes) {
+    float states[CHAOS_BATCH_LANES * 2];
+
+    for (uint32_t start = 0; start < count; start += CHAOS_BATCH_LANES) {
+        uint32_t lanes = count - start < CHAOS_BATCH_LANES ? count - start : CHAOS_BATCH_LANES;
+
+        for (uint32_t l = 0; l < lanes * 2; l++) {
+            states[l] = attractor_random(attractor) * 2 - 1;
+        }
+
+        probe_map_lanes<Map>(parameters + start * Map::num_parameters, states, lanes, num_iterations, probes + start);
+    }
+}
+
+#define DEFINE_MAP_LANE_KERNELS(name, Map)                                                                             \
+    void iterate_##name(Attractor *attractor, uint32_t num_iterations) {                                               \
+        iterate_map<Map>(attractor, num_iterations);                                                                   \
+    }                                                                                                                  \
+    void probe_##name##_batch(Attractor *attractor, const float *parameters, uint32_t count, uint32_t num_iterations,  \
+                              ChaosProbe *probes) {                                                                    \
+        probe_map_batch<Map>(attractor, parameters, count, num_iterations, probes);                                    \
+    }
+
+extern "C" {
+FOR_EACH_MAP(DEFINE_MAP_LANE_KERNELS)
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef SRC_MAPS_C_H_
+#define SRC_MAPS_C_H_
+
+#include <stdint.h>
+
+#include "attractor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Every 2D map with kernels generated from the templates in maps.cpp and maps_batch.cpp, as (prefix of the C
+// functions, map type in maps.hpp). Adding a map here, to maps.hpp and to the registry in attractor.c is all it takes.
+#define FOR_EACH_MAP(X)                                                                                                \
+    X(de_jong, DeJong)                                                                                                 \
+    X(henon, Henon)                                                                                                    \
+    X(svensson, Svensson)                                                                                              \
+    X(bedhead, Bedhead)                                                                                                \
+    X(tinkerbell, Tinkerbell)                                                                                          \
+    X(gumowski_mira, GumowskiMira)                                                                                     \
+    X(ikeda, Ikeda)                                                                                                    \
+    X(sprott_quadratic, SprottQuadratic)                                                                               \
+    X(sprott_cubic, SprottCubic)
+
+#define DECLARE_MAP_KERNELS(name, Map)                                                                                 \
+    void iterate_##name(Attractor *attractor, uint32_t num_iterations);                                                \
+    void probe_##name(Attractor *attractor, uint32_t num_iterations, ChaosProbe *probe);                               \
+    void probe_##name##_batch(Attractor *attractor, const float *parameters, uint32_t count, uint32_t num_iterations,  \
+                              ChaosProbe *probes);                                                                     \
+    void advance_##name(const float *parameters, float *state, uint32_t num_iterations, float *points);
+
+FOR_EACH_MAP(DECLARE_MAP_KERNELS)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SRC_MAPS_C_H_
@@ -0,0 +1,239 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "attractor.h"
+#include "chaos.h"
+#include "parameter_map.h"
+
+#define PARAMETER_MAP_TILES_PER_ROW (PARAMETER_MAP_SIZE / PARAMETER_MAP_TILE_SIZE)
+#define PARAMETER_MAP_TILES         (PARAMETER_MAP_TILES_PER_ROW * PARAMETER_MAP_TILES_PER_ROW)
+#define PARAMETER_MAP_TILE_PIXELS   (PARAMETER_MAP_TILE_SIZE * PARAMETER_MAP_TILE_SIZE)
+
+ParameterMap *parameter_map_init(AttractorType type, uint32_t num_workers) {
+    ParameterMap *map  = malloc(sizeof(ParameterMap));
+    uint32_t      size = PARAMETER_MAP_SIZE * PARAMETER_MAP_SIZE;
+
+    map->lyapunov = malloc(size * sizeof(float));
+    map->coverage = malloc(size * sizeof(float));
+    map->step     = malloc(size * sizeof(uint8_t));
+
+    map->tile_levels = malloc(PARAMETER_MAP_TILES * sizeof(uint32_t));
+
+    map->num_items   = PARAMETER_MAP_TILES * PARAMETER_MAP_LEVELS;
+    map->num_workers = num_workers;
+    map->workers     = malloc(num_workers * sizeof(ParameterMapWorker));
+
+    for (uint32_t i = 0; i < num_workers; i++) {
+        map->workers[i].map     = map;
+        map->workers[i].scratch = make_attractor(type, 1, 1);
+    }
+
+    // Defaults to the first two parameters over the same range as the GUI sliders
+    Attractor *scratch  = map->workers[0].scratch;
+    map->num_parameters = scratch->num_parameters;
+    memcpy(map->parameters, scratch->parameters, scratch->num_parameters * sizeof(float));
+
+    map->axis[0] = 0;
+    map->axis[1] = scratch->num_parameters > 1 ? 1 : 0;
+    map->min[0]  = -2;
+    map->max[0]  = 2;
+    map->min[1]  = -2;
+    map->max[1]  = 2;
+
+    parameter_map_restart(map);
+
+    return map;
+}
+
+void parameter_map_destroy(ParameterMap *map) {
+    for (uint32_t i = 0; i < map->num_workers; i++) {
+        destroy_attractor(map->workers[i].scratch);
+    }
+
+    free(map->workers);
+    free(map->lyapunov);
+    free(map->coverage);
+    free(map->step);
+    free(map->tile_levels);
+    free(map);
+}
+
+// Clears the map and starts over from the coarsest pass. No worker may be running a parameter map tick.
+void parameter_map_restart(ParameterMap *map) {
+    uint32_t size = PARAMETER_MAP_SIZE * PARAMETER_MAP_SIZE;
+
+    for (uint32_t i = 0; i < size; i++) {
+        map->lyapunov[i] = NAN;
+        map->coverage[i] = 0;
+    }
+
+    memset(map->step, UINT8_MAX, size * sizeof(uint8_t));
+    memset(map->tile_levels, 0, PARAMETER_MAP_TILES * sizeof(uint32_t));
+
+    map->next      = 0;
+    map->completed = 0;
+}
+
+// u and v go from 0 to 1, left to right and top to bottom
+void parameter_map_get_parameters(ParameterMap *map, float u, float v, float *parameters) {
+    memcpy(parameters, map->parameters, map->num_parameters * sizeof(float));
+
+    parameters[map->axis[0]] = map->min[0] + u * (map->max[0] - map->min[0]);
+    parameters[map->axis[1]] = map->max[1] - v * (map->max[1] - map->min[1]);
+}
+
+// Probes every pixel of a tile that is new at this level, and paints it over the step x step block it stands for
+void parameter_map_tick(void *data) {
+    ParameterMapWorker *worker = data;
+    ParameterMap       *map    = worker->map;
+    uint32_t            item   = __atomic_fetch_add(&map->next, 1, __ATOMIC_RELAXED);
+
+    if (item >= map->num_items) {
+        // Nothing left to claim, wait for the manager to clear the job
+        struct timespec ts = {0, 1000000};
+        nanosleep(&ts, NULL);
+        return;
+    }
+
+    uint32_t level  = item / PARAMETER_MAP_TILES;
+    uint32_t tile   = item % PARAMETER_MAP_TILES;
+    uint32_t step   = PARAMETER_MAP_COARSEST_STEP >> level;
+    uint32_t tile_x = (tile % PARAMETER_MAP_TILES_PER_ROW) * PARAMETER_MAP_TILE_SIZE;
+    uint32_t tile_y = (tile / PARAMETER_MAP_TILES_PER_ROW) * PARAMETER_MAP_TILE_SIZE;
+
+    Attractor *scratch        = worker->scratch;
+    uint32_t   num_parameters = map->num_parameters;
+    uint32_t   count          = 0;
+    uint32_t   pixels[PARAMETER_MAP_TILE_PIXELS];
+    float      parameters[PARAMETER_MAP_TILE_PIXELS * ATTRACTOR_MAX_PARAMETERS];
+    ChaosProbe probes[PARAMETER_MAP_TILE_PIXELS];
+
+    for (uint32_t y = tile_y; y < tile_y + PARAMETER_MAP_TILE_SIZE; y += step) {
+        for (uint32_t x = tile_x; x < tile_x + PARAMETER_MAP_TILE_SIZE; x += step) {
+            // Already probed by a coarser pass
+            if (level > 0 && x % (2 * step) == 0 && y % (2 * step) == 0) {
+                continue;
+            }
+
+            float u = (x + 0.5f) / PARAMETER_MAP_SIZE;
+            float v = (y + 0.5f) / PARAMETER_MAP_SIZE;
+
+            pixels[count] = y * PARAMETER_MAP_SIZE + x;
+            parameter_map_get_parameters(map, u, v, parameters + count * num_parameters);
+            count++;
+        }
+    }
+
+    if (!probe_attractor_batch(scratch, parameters, count, PARAMETER_MAP_PROBE_ITERATIONS, probes)) {
+        for (uint32_t i = 0; i < count; i++) {
+            memcpy(scratch->parameters, parameters + i * num_parameters, num_parameters * sizeof(float));
+
+            if (!probe_attractor(scratch, PARAMETER_MAP_PROBE_ITERATIONS, &probes[i])) {
+                chaos_probe_init(&probes[i]);
+            }
+        }
+    }
+
+    // The level before was claimed earlier and its worker is already on it, so the wait is at most one tile. Without
+    // it the blocks of both levels could interleave, and coarse values land over finer ones.
+    while (__atomic_load_n(&map->tile_levels[tile], __ATOMIC_ACQUIRE) < level) {
+        struct timespec ts = {0, 100000};
+        nanosleep(&ts, NULL);
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        ChaosProbe *probe    = &probes[i];
+        float       lyapunov = probe->has_lyapunov ? probe->lyapunov : NAN;
+        float       coverage = probe->has_coverage ? probe->coverage : 0;
+        uint32_t    x0       = pixels[i] % PARAMETER_MAP_SIZE;
+        uint32_t    y0       = pixels[i] / PARAMETER_MAP_SIZE;
+
+        if (probe->classification == ORBIT_DIVERGENT) {
+            lyapunov = NAN;
+        }
+
+        for (uint32_t y = y0; y < y0 + step; y++) {
+            for (uint32_t x = x0; x < x0 + step; x++) {
+                uint32_t index = y * PARAMETER_MAP_SIZE + x;
+
+                if (map->step[index] < step) {
+                    continue;
+                }
+
+                map->lyapunov[index] = lyapunov;
+                map->coverage[index] = coverage;
+                map->step[index]     = step;
+            }
+        }
+    }
+
+    // Pairs with the acquire above, so the next level of the tile sees this one's step and values
+    __atomic_store_n(&map->tile_levels[tile], level + 1, __ATOMIC_RELEASE);
+    __atomic_fetch_add(&map->completed, 1, __ATOMIC_RELEASE);
+}
+
+bool parameter_map_is_done(ParameterMap *map) {
+    return __atomic_load_n(&map->completed, __ATOMIC_ACQUIRE) >= map->num_items;
+}
+
+float parameter_map_get_progress(ParameterMap *map) {
+    return (float)__atomic_load_n(&map->completed, __ATOMIC_ACQUIRE) / map->num_items;
+}
+
+// Lyapunov maps use the usual palette, yellow where orbits are stable and blue where they are chaotic, both fading to
+// black at zero. Divergent and unknown pixels are gray.
+void parameter_map_get_color(ParameterMap *map, ParameterMapMetric metric, uint32_t index, float *rgba) {
+    rgba[3] = 1;
+
+    if (metric == PARAMETER_MAP_COVERAGE) {
+        float value = sqrtf(map->coverage[index]);
+
+        rgba[0] = value;
+        rgba[1] = value;
+        rgba[2] = value;
+        return;
+    }
+
+    float lyapunov = map->lyapunov[index];
+
+    if (isnan(lyapunov)) {
+        rgba[0] = 0.2f;
+        rgba[1] = 0.2f;
+        rgba[2] = 0.2f;
+        return;
+    }
+
+    float t = fminf(fabsf(lyapunov) * 2, 1);
+
+    if (lyapunov < 0) {
+        rgba[0] = t;
+        rgba[1] = 0.8f * t;
+        rgba[2] = 0;
+    } else {
+        rgba[0] = 0.1f * t;
+        rgba[1] = 0.4f * t;
+        rgba[2] = t;
+    }
+}
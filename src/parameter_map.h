@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef SRC_PARAMETER_MAP_H_
+#define SRC_PARAMETER_MAP_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "attractor.h"
+
+#define PARAMETER_MAP_SIZE 256
+// Work is handed out in tiles of this many pixels per side
+#define PARAMETER_MAP_TILE_SIZE 16
+// The first pass probes one pixel per block of this size, and every pass after halves it
+#define PARAMETER_MAP_COARSEST_STEP 16
+#define PARAMETER_MAP_LEVELS        5
+// Shorter than the probe used to accept candidates, the map only needs the sign and rough size of the exponent
+#define PARAMETER_MAP_PROBE_ITERATIONS 1024
+
+typedef enum {
+    PARAMETER_MAP_LYAPUNOV,
+    PARAMETER_MAP_COVERAGE,
+} ParameterMapMetric;
+
+typedef struct ParameterMap ParameterMap;
+
+typedef struct {
+    ParameterMap *map;
+    Attractor    *scratch; // Probes run on it, so every worker has its own rng
+} ParameterMapWorker;
+
+// A 2D slice of parameter space, with two parameters along the axes and the others fixed. Every pixel is probed and
+// colored by its Lyapunov exponent or its coverage. Work items are (level, tile) pairs handed out coarse to fine, so
+// the whole map shows up after the first pass and then sharpens. Items of different levels run at the same time, but
+// each tile is painted one level after the other.
+struct ParameterMap {
+    uint32_t num_parameters;
+    float    parameters[ATTRACTOR_MAX_PARAMETERS]; // Values of the parameters that are not on an axis
+
+    uint32_t axis[2]; // Parameter shown along x and along y
+    float    min[2];
+    float    max[2];
+
+    float   *lyapunov; // NAN where the exponent is not known
+    float   *coverage;
+    uint8_t *step;     // Size of the block each pixel's value was probed for, so coarse passes never overwrite finer
+
+    uint32_t *tile_levels; // Levels painted per tile. A tile's level is only painted once the ones before it are.
+
+    uint32_t num_items;
+    uint32_t next;      // Next work item to claim
+    uint32_t completed; // Work items done
+
+    uint32_t            num_workers;
+    ParameterMapWorker *workers;
+};
+
+ParameterMap *parameter_map_init(AttractorType type, uint32_t num_workers);
+void          parameter_map_destroy(ParameterMap *map);
+void          parameter_map_restart(ParameterMap *map);
+void          parameter_map_tick(void *data);
+bool          parameter_map_is_done(ParameterMap *map);
+float         parameter_map_get_progress(ParameterMap *map);
+
+void parameter_map_get_parameters(ParameterMap *map, float u, float v, float *parameters);
+void parameter_map_get_color(ParameterMap *map, ParameterMapMetric metric, uint32_t index, float *rgba);
+
+#endif // SRC_PARAMETER_MAP_H_
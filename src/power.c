@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <string.h>
+
+#include <GLFW/glfw3.h>
+
+#include "power.h"
+
+void power_init(PowerSettings *power) {
+    memset(power, 0, sizeof(PowerSettings));
+
+    power->policy                = POWER_POLICY_POLITE;
+    power->active_frame_rate     = 60.0f;
+    power->background_frame_rate = 10.0f;
+    power->hidden_frame_rate     = 10.0f;
+    power->background_worker_cap = 2;
+    power->window_state          = WINDOW_STATE_ACTIVE;
+}
+
+void power_update_window_state(PowerSettings *power, GLFWwindow *window) {
+    if (glfwGetWindowAttrib(window, GLFW_ICONIFIED) || !glfwGetWindowAttrib(window, GLFW_VISIBLE)) {
+        power->window_state = WINDOW_STATE_HIDDEN;
+    } else if (!glfwGetWindowAttrib(window, GLFW_FOCUSED)) {
+        power->window_state = WINDOW_STATE_UNFOCUSED;
+    } else {
+        power->window_state = WINDOW_STATE_ACTIVE;
+    }
+}
+
+float power_get_frame_time(const PowerSettings *power) {
+    switch (power->window_state) {
+        case WINDOW_STATE_HIDDEN: return 1.0f / power->hidden_frame_rate;
+        case WINDOW_STATE_UNFOCUSED:
+            if (power->policy == POWER_POLICY_POLITE) {
+                return 1.0f / power->background_frame_rate;
+            }
+            break;
+        default: break;
+    }
+
+    return 1.0f / power->active_frame_rate;
+}
+
+uint32_t power_get_worker_cap(const PowerSettings *power, uint32_t compute_count) {
+    if (power->policy != POWER_POLICY_POLITE || power->window_state == WINDOW_STATE_ACTIVE) {
+        return compute_count;
+    }
+
+    if (power->background_worker_cap < compute_count) {
+        return power->background_worker_cap;
+    }
+
+    return compute_count;
+}
+
+// Nothing is visible while hidden, so there is no point in uploading or drawing anything
+bool power_should_present(const PowerSettings *power) { return power->window_state != WINDOW_STATE_HIDDEN; }
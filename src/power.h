@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef SRC_POWER_H_
+#define SRC_POWER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <GLFW/glfw3.h>
+
+typedef enum {
+    POWER_POLICY_FULL_SPEED, // Keep rendering at full speed in the background, good for long renders
+    POWER_POLICY_POLITE,     // Back off when the window is not being looked at, good for interactive sessions
+} PowerPolicy;
+
+typedef enum {
+    WINDOW_STATE_ACTIVE,
+    WINDOW_STATE_UNFOCUSED,
+    WINDOW_STATE_HIDDEN,
+} WindowState;
+
+typedef struct {
+    PowerPolicy policy;
+
+    float    active_frame_rate;
+    float    background_frame_rate; // Presentation rate while unfocused with the polite policy
+    float    hidden_frame_rate;     // Loop rate while minimized or hidden, nothing is presented
+    uint32_t background_worker_cap; // Maximum number of workers while in the background with the polite policy
+
+    WindowState window_state;
+} PowerSettings;
+
+void power_init(PowerSettings *power);
+void power_update_window_state(PowerSettings *power, GLFWwindow *window);
+
+float    power_get_frame_time(const PowerSettings *power);
+uint32_t power_get_worker_cap(const PowerSettings *power, uint32_t compute_count);
+bool     power_should_present(const PowerSettings *power);
+
+#endif // SRC_POWER_H_
@@ -80,9 +80,16 @@ void copy_attractor_to_texture_data(Attractor *attractor, uint32_t *texture_data
     uint32_t border_size_x = width * border_size_percent;
     uint32_t border_size_y = height * border_size_percent;
 
+    // Low resolution maps are upscaled with nearest neighbour sampling
+    uint32_t downsample = attractor->downsample;
+    uint32_t map_width  = get_attractor_map_width(attractor);
+    uint32_t map_height = get_attractor_map_height(attractor);
+
     for (int i = 0; i < attractor->width; i++) {
         for (int j = 0; j < attractor->height; j++) {
-            int      index         = i + j * (attractor->width);
+            uint32_t map_x         = i / downsample < map_width ? i / downsample : map_width - 1;
+            uint32_t map_y         = j / downsample < map_height ? j / downsample : map_height - 1;
+            int      index         = map_x + map_y * map_width;
             int      texture_index = ((border_size_x + i) + (border_size_y + j) * width) * 4;
             uint32_t density       = attractor->density_map[index];
 
@@ -90,6 +97,13 @@ void copy_attractor_to_texture_data(Attractor *attractor, uint32_t *texture_data
             texture_data[texture_index + 1] = density;
             texture_data[texture_index + 2] = density;
             texture_data[texture_index + 3] = 255;
+
+            // Colored attractors carry the average color of the pixel, from 0 to 255, instead of the density
+            if (attractor->color_map != NULL && density > 0) {
+                for (int c = 0; c < 3; c++) {
+                    texture_data[texture_index + c + 1] = attractor->color_map[index * 3 + c] / density;
+                }
+            }
         }
     }
 }
@@ -104,7 +118,7 @@ float sigmoid_normalize(float x, float midpoint, float steepness) {
 
 void normalize_texture_data(const uint32_t *texture_data, float *texture_data_gl, uint32_t width, uint32_t height,
                             ScalingMethod scaling_method, float power_exponent, float sigmoid_midpoint,
-                            float sigmoid_steepness) {
+                            float sigmoid_steepness, bool colored) {
     uint32_t max_value = 0;
     for (int i = 0; i < width * height; i++) {
         if (texture_data[i * 4 + 0] > max_value) {
@@ -135,12 +149,22 @@ void normalize_texture_data(const uint32_t *texture_data, float *texture_data_gl
 
             case SQRT_SCALING: normalized = sqrtf(normalized); break;
 
+            // The usual display for fractal flames, which spans the whole range of densities instead of a decade
+            case LOG_DENSITY_SCALING: normalized = logf(1.0f + pixel_value) / logf(1.0f + max_value); break;
+
             default: break;
         }
 
-        texture_data_gl[i * 4 + 0] = normalized;
-        texture_data_gl[i * 4 + 1] = normalized;
-        texture_data_gl[i * 4 + 2] = normalized;
+        if (colored) {
+            // Tints the brightness with the average color, stored in the last three channels
+            texture_data_gl[i * 4 + 0] = normalized * texture_data[i * 4 + 1] / 255.0f;
+            texture_data_gl[i * 4 + 1] = normalized * texture_data[i * 4 + 2] / 255.0f;
+            texture_data_gl[i * 4 + 2] = normalized * texture_data[i * 4 + 3] / 255.0f;
+        } else {
+            texture_data_gl[i * 4 + 0] = normalized;
+            texture_data_gl[i * 4 + 1] = normalized;
+            texture_data_gl[i * 4 + 2] = normalized;
+        }
         texture_data_gl[i * 4 + 3] = 1.0f;
     }
 }
@@ -155,3 +179,36 @@ void clean_texture_data(uint32_t *texture_data, float *texture_data_gl, uint32_t
 void render_texture_to_gl(float *texture_data_gl, uint32_t width, uint32_t height) {
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, width, height, 0, GL_RGBA, GL_FLOAT, texture_data_gl);
 }
+
+// Uploads RGBA float data to a texture other than the main render's, for images drawn by the GUI. The main render
+// relies on its texture staying bound, so the previous binding is restored.
+void upload_gui_texture(uint32_t texture_id, float *texture_data_gl, uint32_t width, uint32_t height) {
+    GLint bound_texture;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &bound_texture);
+
+    glBindTexture(GL_TEXTURE_2D, texture_id);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    render_texture_to_gl(texture_data_gl, width, height);
+
+    glBindTexture(GL_TEXTURE_2D, bound_texture);
+}
+
+// Uploads a whole attractor map to its own texture, for thumbnails drawn by the GUI
+void render_attractor_thumbnail(Attractor *attractor, uint32_t texture_id, ScalingMethod scaling_method,
+                                float power_exponent, float sigmoid_midpoint, float sigmoid_steepness) {
+    uint32_t  width           = attractor->width;
+    uint32_t  height          = attractor->height;
+    uint32_t *texture_data    = malloc(width * height * 4 * sizeof(uint32_t));
+    float    *texture_data_gl = malloc(width * height * 4 * sizeof(float));
+
+    clean_texture_data(texture_data, texture_data_gl, width, height);
+    copy_attractor_to_texture_data(attractor, texture_data, width, height, 0);
+    normalize_texture_data(texture_data, texture_data_gl, width, height, scaling_method, power_exponent,
+                           sigmoid_midpoint, sigmoid_steepness, attractor->color_map != NULL);
+
+    upload_gui_texture(texture_id, texture_data_gl, width, height);
+
+    free(texture_data);
+    free(texture_data_gl);
+}
@@ -30,6 +30,7 @@ typedef enum {
     POWER_SCALING,
     SIGMOID_SCALING,
     SQRT_SCALING,
+    LOG_DENSITY_SCALING,
 } ScalingMethod;
 
 typedef enum {
@@ -52,7 +53,10 @@ void  copy_attractor_to_texture_data(struct Attractor *attractor, uint32_t *text
 float sigmoid_normalize(float x, float midpoint, float steepness);
 void  normalize_texture_data(const uint32_t *texture_data, float *texture_data_gl, uint32_t width, uint32_t height,
                              ScalingMethod scaling_method, float power_exponent, float sigmoid_midpoint,
-                             float sigmoid_steepness);
+                             float sigmoid_steepness, bool colored);
 void  render_texture_to_gl(float *texture_data_gl, uint32_t width, uint32_t height);
+void  upload_gui_texture(uint32_t texture_id, float *texture_data_gl, uint32_t width, uint32_t height);
+void  render_attractor_thumbnail(struct Attractor *attractor, uint32_t texture_id, ScalingMethod scaling_method,
+                                 float power_exponent, float sigmoid_midpoint, float sigmoid_steepness);
 
 #endif // SRC_RENDERING_H_
@@ -0,0 +1,647 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+// Headless parameter space scanner. Sweeps or randomly samples the parameters of an attractor on every core, scores
+// each candidate and appends the results to a CSV or binary file, or builds the atlas the viewer draws random
+// parameters from. For Sprott's maps it also streams the codes of the chaotic ones to a catalog. Built from the same
+// sources as the viewer, but without GLFW or GL, so it runs on servers.
+
+#include <math.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <entropy.h>
+#include <pcg_variants.h>
+
+#include "atlas.h"
+#include "attractor.h"
+#include "chaos.h"
+#include "sprott.h"
+#include "utils.h"
+
+// Candidates a worker claims at once, and writes out in a single locked call
+#define SCANNER_BATCH_SIZE 256
+
+#define SCANNER_BINARY_MAGIC   "ATTRSCAN"
+#define SCANNER_BINARY_VERSION 1
+
+typedef enum {
+    SCAN_MODE_RANDOM,
+    SCAN_MODE_SWEEP,
+    SCAN_MODE_ATLAS,
+} ScanMode;
+
+typedef enum {
+    SCAN_FORMAT_CSV,
+    SCAN_FORMAT_BINARY,
+    SCAN_FORMAT_CATALOG, // One line per chaotic candidate with its letter code, judged by the probe alone
+} ScanFormat;
+
+typedef struct {
+    uint64_t   index;
+    OrbitClass classification; // ORBIT_UNKNOWN when the attractor has no probe
+    float      lyapunov;       // NAN when the attractor has no probe
+    float      occupancy;
+    float      entropy;
+    float      parameters[ATTRACTOR_MAX_PARAMETERS];
+} ScanResult;
+
+typedef struct {
+    AttractorType type;
+    ScanMode      mode;
+    ScanFormat    format;
+    const char   *output_path;
+    uint64_t      seed;
+    uint32_t      threads;
+    uint64_t      count;      // Candidates to draw in random mode
+    uint32_t      steps;      // Grid points per parameter in sweep mode, cells per parameter in atlas mode
+    float         range[2];   // Parameter range in sweep and atlas mode
+    uint32_t      size;       // Side of the density map used for occupancy and entropy
+    uint32_t      iterations; // Samples accumulated per candidate that passes the probe, none to skip scoring
+    bool          chaotic_only;
+    const char   *atlas_path; // Random candidates are drawn from this atlas
+
+    uint32_t num_parameters;
+    uint64_t total;
+
+    Atlas      *atlas;
+    AtlasHeader atlas_header; // Grid being built in atlas mode
+    uint8_t    *atlas_scores;
+
+    FILE           *output;
+    pthread_mutex_t output_lock;
+
+    uint64_t next; // Next candidate index to claim
+    uint64_t scanned;
+    uint64_t chaotic;
+} Scanner;
+
+typedef struct {
+    Scanner  *scanner;
+    pthread_t thread;
+} ScanWorker;
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void handle_interrupt(int signum) { stop_requested = 1; }
+
+static void print_usage(const char *program) {
+    printf("usage: %s [options]\n", program);
+    printf("  --attractor TYPE     attractor to scan (default 0):\n");
+    for (uint32_t type = 0; type < ATTRACTOR_TYPE_COUNT; type++) {
+        printf("                         %u  %s\n", type, get_attractor_name(type));
+    }
+    printf("  --random N           score N random candidates (default 1e6)\n");
+    printf("  --sweep STEPS        score a grid of STEPS points per parameter instead\n");
+    printf("  --build-atlas STEPS  build an atlas of STEPS cells per parameter into the output file instead\n");
+    printf("  --range MIN MAX      parameter range of the sweep or atlas (default -2 2)\n");
+    printf("  --atlas FILE         draw the random candidates from the interesting cells of an atlas\n");
+    printf("  --seed SEED          seed of the random candidates and probes (default: random)\n");
+    printf("  --threads N          number of worker threads (default: all cores)\n");
+    printf("  --size N             side of the density map used for scoring (default 256)\n");
+    printf("  --iterations N       samples per candidate used for scoring (default 1e5)\n");
+    printf("  --output FILE        append the results to FILE (default: stdout)\n");
+    printf("  --binary             write binary records instead of CSV\n");
+    printf("  --chaotic-only       only write candidates that pass the chaos probe\n");
+    printf("  --catalog            only write the letter codes of the chaotic candidates of a Sprott map, unscored\n");
+}
+
+static uint32_t get_core_count() {
+#ifdef _SC_NPROCESSORS_ONLN
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (cores > 0) {
+        return cores;
+    }
+#endif
+
+    return 8;
+}
+
+static bool parse_arguments(int argc, char *argv[], Scanner *scanner) {
+    memset(scanner, 0, sizeof(Scanner));
+
+    scanner->type       = ATTRACTOR_TYPE_CLIFFORD;
+    scanner->mode       = SCAN_MODE_RANDOM;
+    scanner->format     = SCAN_FORMAT_CSV;
+    scanner->threads    = get_core_count();
+    scanner->count      = 1000000;
+    scanner->range[0]   = -2;
+    scanner->range[1]   = 2;
+    scanner->size       = 256;
+    scanner->iterations = 100000;
+
+    bool has_seed = false;
+
+    for (int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+
+        if (strcmp(argv[i], "--attractor") == 0 && has_value) {
+            scanner->type = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--random") == 0 && has_value) {
+            scanner->mode  = SCAN_MODE_RANDOM;
+            scanner->count = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--sweep") == 0 && has_value) {
+            scanner->mode  = SCAN_MODE_SWEEP;
+            scanner->steps = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--build-atlas") == 0 && has_value) {
+            scanner->mode  = SCAN_MODE_ATLAS;
+            scanner->steps = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--atlas") == 0 && has_value) {
+            scanner->atlas_path = argv[++i];
+        } else if (strcmp(argv[i], "--range") == 0 && i + 2 < argc) {
+            scanner->range[0] = strtod(argv[++i], NULL);
+            scanner->range[1] = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--seed") == 0 && has_value) {
+            scanner->seed = strtoull(argv[++i], NULL, 10);
+            has_seed      = true;
+        } else if (strcmp(argv[i], "--threads") == 0 && has_value) {
+            scanner->threads = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--size") == 0 && has_value) {
+            scanner->size = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--iterations") == 0 && has_value) {
+            scanner->iterations = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--output") == 0 && has_value) {
+            scanner->output_path = argv[++i];
+        } else if (strcmp(argv[i], "--binary") == 0) {
+            scanner->format = SCAN_FORMAT_BINARY;
+        } else if (strcmp(argv[i], "--chaotic-only") == 0) {
+            scanner->chaotic_only = true;
+        } else if (strcmp(argv[i], "--catalog") == 0) {
+            scanner->format = SCAN_FORMAT_CATALOG;
+        } else {
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+
+    if (scanner->type >= ATTRACTOR_TYPE_COUNT || scanner->threads == 0 || scanner->size == 0 ||
+        (scanner->mode == SCAN_MODE_SWEEP && scanner->steps < 2)) {
+        print_usage(argv[0]);
+        return false;
+    }
+
+    // The probe is all a catalog needs, and only the codes that pass it are written
+    if (scanner->format == SCAN_FORMAT_CATALOG) {
+        if (!is_sprott_type(scanner->type) || scanner->mode == SCAN_MODE_ATLAS) {
+            print_usage(argv[0]);
+            return false;
+        }
+
+        scanner->chaotic_only = true;
+        scanner->iterations   = 0;
+    }
+
+    // The atlas is written in one go at the end, and is mapped by the viewer, so it has to be a file of its own
+    if (scanner->mode == SCAN_MODE_ATLAS && (scanner->steps < 1 || scanner->output_path == NULL)) {
+        print_usage(argv[0]);
+        return false;
+    }
+
+    if (!has_seed) {
+        entropy_getbytes((void *)&scanner->seed, sizeof(scanner->seed));
+    }
+
+    return true;
+}
+
+// Puts the parameters of a candidate into the attractor. Every candidate reseeds the attractor from (seed, index),
+// so its parameters, probe and score only depend on the seed and index, not on the thread that scanned it.
+static void load_candidate(Scanner *scanner, Attractor *attractor, uint64_t index) {
+    seed_attractor(attractor, scanner->seed, index);
+
+    if (scanner->mode == SCAN_MODE_RANDOM) {
+        randomize_attractor(attractor);
+        return;
+    }
+
+    // The index is a number in base steps, with one digit per parameter
+    uint64_t remainder = index;
+
+    for (uint32_t i = 0; i < attractor->num_parameters; i++) {
+        float t = (float)(remainder % scanner->steps) / (scanner->steps - 1);
+
+        attractor->parameters[i] = scanner->range[0] + t * (scanner->range[1] - scanner->range[0]);
+        remainder /= scanner->steps;
+    }
+
+    clean_attractor(attractor);
+    invalidate_orbit(attractor);
+}
+
+// Fills the density map of a candidate that passed the probe, and scores it
+static void score_candidate(Scanner *scanner, Attractor *attractor, ScanResult *result) {
+    if (scanner->iterations == 0) {
+        return;
+    }
+
+    memcpy(attractor->parameters, result->parameters, attractor->num_parameters * sizeof(float));
+    seed_attractor(attractor, scanner->seed, result->index);
+    clean_attractor(attractor);
+    invalidate_orbit(attractor);
+
+    iterate_attractor(attractor, scanner->iterations);
+
+    result->occupancy = get_occupancy(attractor);
+    result->entropy   = get_density_entropy(attractor);
+}
+
+// Scans up to CHAOS_BATCH_LANES consecutive candidates, probing them together when the attractor has a batch probe.
+// The density map is only filled for candidates the probe did not reject, which is where most of the time goes.
+// Returns how many are chaotic, and flags each of them in chaotic.
+static uint32_t scan_candidates(Scanner *scanner, Attractor *attractor, uint64_t start, uint32_t count,
+                                ScanResult *results, bool *chaotic) {
+    float      parameters[CHAOS_BATCH_LANES * ATTRACTOR_MAX_PARAMETERS];
+    ChaosProbe probes[CHAOS_BATCH_LANES];
+    bool       has_probe[CHAOS_BATCH_LANES];
+    uint32_t   num_parameters = scanner->num_parameters;
+    uint32_t   num_chaotic    = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        ScanResult *result = &results[i];
+
+        load_candidate(scanner, attractor, start + i);
+        memcpy(parameters + i * num_parameters, attractor->parameters, num_parameters * sizeof(float));
+
+        result->index          = start + i;
+        result->classification = ORBIT_UNKNOWN;
+        result->lyapunov       = NAN;
+        result->occupancy      = 0;
+        result->entropy        = 0;
+        memcpy(result->parameters, attractor->parameters, num_parameters * sizeof(float));
+
+        // Without a batch probe each candidate is probed right away, from its own random stream
+        has_probe[i] = attractor->functions.probe_batch == NULL &&
+                       probe_attractor(attractor, CHAOS_PROBE_ITERATIONS, &probes[i]);
+    }
+
+    // The starting points of a batch are drawn from the complemented seed, so they do not repeat the draws of the
+    // candidate with the same index
+    if (attractor->functions.probe_batch != NULL) {
+        seed_attractor(attractor, ~scanner->seed, start);
+        probe_attractor_batch(attractor, parameters, count, CHAOS_PROBE_ITERATIONS, probes);
+
+        for (uint32_t i = 0; i < count; i++) {
+            has_probe[i] = true;
+        }
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        ScanResult *result = &results[i];
+
+        if (has_probe[i]) {
+            result->classification = probes[i].classification;
+
+            if (probes[i].has_lyapunov) {
+                result->lyapunov = probes[i].lyapunov;
+            }
+
+            if (is_orbit_rejected(&probes[i])) {
+                chaotic[i] = false;
+                continue;
+            }
+        }
+
+        score_candidate(scanner, attractor, result);
+
+        chaotic[i] = has_probe[i] ? is_orbit_chaotic(&probes[i]) : result->occupancy >= 0.01;
+        num_chaotic += chaotic[i];
+    }
+
+    return num_chaotic;
+}
+
+// Probes CHAOS_BATCH_LANES random parameter sets inside an atlas cell, and scores the cell by the fraction of them
+// that is chaotic
+static uint8_t score_cell(Scanner *scanner, Attractor *attractor, uint32_t cell) {
+    float      parameters[CHAOS_BATCH_LANES * ATTRACTOR_MAX_PARAMETERS];
+    ChaosProbe probes[CHAOS_BATCH_LANES];
+    float      min[ATTRACTOR_MAX_PARAMETERS];
+    float      max[ATTRACTOR_MAX_PARAMETERS];
+    uint32_t   num_parameters = scanner->num_parameters;
+    uint32_t   chaotic        = 0;
+
+    atlas_get_cell_bounds(&scanner->atlas_header, cell, min, max);
+    seed_attractor(attractor, scanner->seed, cell);
+
+    for (uint32_t i = 0; i < CHAOS_BATCH_LANES; i++) {
+        for (uint32_t j = 0; j < num_parameters; j++) {
+            parameters[i * num_parameters + j] = min[j] + attractor_random(attractor) * (max[j] - min[j]);
+        }
+    }
+
+    if (probe_attractor_batch(attractor, parameters, CHAOS_BATCH_LANES, CHAOS_PROBE_ITERATIONS, probes)) {
+        for (uint32_t i = 0; i < CHAOS_BATCH_LANES; i++) {
+            chaotic += is_orbit_chaotic(&probes[i]);
+        }
+    } else {
+        for (uint32_t i = 0; i < CHAOS_BATCH_LANES; i++) {
+            ScanResult result = {.index = cell};
+
+            memcpy(result.parameters, parameters + i * num_parameters, num_parameters * sizeof(float));
+            memcpy(attractor->parameters, result.parameters, num_parameters * sizeof(float));
+
+            bool has_probe = probe_attractor(attractor, CHAOS_PROBE_ITERATIONS, &probes[i]);
+
+            if (has_probe && is_orbit_rejected(&probes[i])) {
+                continue;
+            }
+
+            score_candidate(scanner, attractor, &result);
+            chaotic += has_probe ? is_orbit_chaotic(&probes[i]) : result.occupancy >= 0.01;
+        }
+    }
+
+    return (chaotic * 255 + CHAOS_BATCH_LANES / 2) / CHAOS_BATCH_LANES;
+}
+
+static void write_header(Scanner *scanner) {
+    if (scanner->format == SCAN_FORMAT_CATALOG) {
+        fprintf(scanner->output, "# %s codes and their Lyapunov exponent, in nats per iteration\n",
+                get_attractor_name(scanner->type));
+        return;
+    }
+
+    if (scanner->format == SCAN_FORMAT_BINARY) {
+        uint32_t version = SCANNER_BINARY_VERSION;
+
+        fwrite(SCANNER_BINARY_MAGIC, 1, 8, scanner->output);
+        fwrite(&version, sizeof(version), 1, scanner->output);
+        fwrite(&scanner->num_parameters, sizeof(scanner->num_parameters), 1, scanner->output);
+        return;
+    }
+
+    fprintf(scanner->output, "index,class,lyapunov,occupancy,entropy");
+    for (uint32_t i = 0; i < scanner->num_parameters; i++) {
+        fprintf(scanner->output, ",p%u", i);
+    }
+    fprintf(scanner->output, "\n");
+}
+
+// Binary records are packed: u64 index, u32 class (an OrbitClass), f32 lyapunov, f32 occupancy, f32 entropy, then
+// num_parameters f32, all in host byte order
+static void write_results(Scanner *scanner, const ScanResult *results, uint32_t count) {
+    pthread_mutex_lock(&scanner->output_lock);
+
+    for (uint32_t i = 0; i < count; i++) {
+        const ScanResult *result = &results[i];
+
+        if (scanner->format == SCAN_FORMAT_CATALOG) {
+            char code[SPROTT_MAX_CODE_LENGTH];
+
+            sprott_encode(result->parameters, scanner->num_parameters, code);
+            fprintf(scanner->output, "%s %.6f\n", code, result->lyapunov);
+            continue;
+        }
+
+        if (scanner->format == SCAN_FORMAT_BINARY) {
+            uint32_t classification = result->classification;
+
+            fwrite(&result->index, sizeof(result->index), 1, scanner->output);
+            fwrite(&classification, sizeof(classification), 1, scanner->output);
+            fwrite(&result->lyapunov, sizeof(float), 1, scanner->output);
+            fwrite(&result->occupancy, sizeof(float), 1, scanner->output);
+            fwrite(&result->entropy, sizeof(float), 1, scanner->output);
+            fwrite(result->parameters, sizeof(float), scanner->num_parameters, scanner->output);
+            continue;
+        }
+
+        fprintf(scanner->output, "%llu,%s,%.6f,%.6f,%.6f", (unsigned long long)result->index,
+                get_orbit_class_name(result->classification), result->lyapunov, result->occupancy, result->entropy);
+        for (uint32_t j = 0; j < scanner->num_parameters; j++) {
+            fprintf(scanner->output, ",%.6f", result->parameters[j]);
+        }
+        fprintf(scanner->output, "\n");
+    }
+
+    pthread_mutex_unlock(&scanner->output_lock);
+}
+
+static void *scan_worker_loop(void *data) {
+    ScanWorker *worker    = data;
+    Scanner    *scanner   = worker->scanner;
+    uint32_t    size      = scanner->iterations > 0 ? scanner->size : 1; // Every candidate clears the density map
+    Attractor  *attractor = make_attractor(scanner->type, size, size);
+    ScanResult *results   = malloc(SCANNER_BATCH_SIZE * sizeof(ScanResult));
+
+    set_attractor_atlas(attractor, scanner->atlas);
+
+    while (!stop_requested) {
+        uint64_t start = __atomic_fetch_add(&scanner->next, SCANNER_BATCH_SIZE, __ATOMIC_RELAXED);
+
+        if (start >= scanner->total) {
+            break;
+        }
+
+        uint64_t end = start + SCANNER_BATCH_SIZE < scanner->total ? start + SCANNER_BATCH_SIZE : scanner->total;
+
+        uint32_t count   = 0;
+        uint32_t chaotic = 0;
+
+        if (scanner->mode == SCAN_MODE_ATLAS) {
+            for (uint64_t cell = start; cell < end; cell++) {
+                scanner->atlas_scores[cell] = score_cell(scanner, attractor, cell);
+                chaotic += scanner->atlas_scores[cell] >= ATLAS_MIN_INTERESTING_SCORE;
+            }
+
+            __atomic_fetch_add(&scanner->scanned, end - start, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&scanner->chaotic, chaotic, __ATOMIC_RELAXED);
+            continue;
+        }
+
+        // Batches start at multiples of SCANNER_BATCH_SIZE, so the lanes are grouped the same way on any number of
+        // threads and the results stay reproducible
+        for (uint64_t index = start; index < end; index += CHAOS_BATCH_LANES) {
+            uint32_t    lanes   = end - index < CHAOS_BATCH_LANES ? end - index : CHAOS_BATCH_LANES;
+            ScanResult *scanned = &results[count];
+            bool        is_chaotic[CHAOS_BATCH_LANES];
+
+            chaotic += scan_candidates(scanner, attractor, index, lanes, scanned, is_chaotic);
+
+            // Compact the rejected candidates away when only the chaotic ones are kept
+            for (uint32_t i = 0; i < lanes; i++) {
+                if (is_chaotic[i] || !scanner->chaotic_only) {
+                    results[count++] = scanned[i];
+                }
+            }
+        }
+
+        write_results(scanner, results, count);
+
+        __atomic_fetch_add(&scanner->scanned, end - start, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&scanner->chaotic, chaotic, __ATOMIC_RELAXED);
+    }
+
+    free(results);
+    destroy_attractor(attractor);
+
+    return NULL;
+}
+
+int main(int argc, char *argv[]) {
+    Scanner scanner;
+    if (!parse_arguments(argc, argv, &scanner)) {
+        return -1;
+    }
+
+    {
+        uint64_t seeds[2];
+        entropy_getbytes((void *)seeds, sizeof(seeds));
+        pcg32_srandom(seeds[0], seeds[1]);
+    }
+
+    {
+        Attractor *attractor = make_attractor(scanner.type, 1, 1);
+
+        scanner.num_parameters = attractor->num_parameters;
+
+        if (scanner.atlas_path != NULL) {
+            scanner.atlas = atlas_open(scanner.atlas_path);
+
+            if (scanner.atlas == NULL || !set_attractor_atlas(attractor, scanner.atlas)) {
+                fprintf(stderr, "cannot draw candidates from atlas %s\n", scanner.atlas_path);
+                return -1;
+            }
+        }
+
+        destroy_attractor(attractor);
+    }
+
+    if (scanner.num_parameters > ATTRACTOR_MAX_PARAMETERS) {
+        fprintf(stderr, "attractor has too many parameters to scan\n");
+        return -1;
+    }
+
+    scanner.total = scanner.count;
+
+    // Grids too large to count in 64 bits are rejected rather than scanned in part
+    bool too_large = false;
+
+    if (scanner.mode == SCAN_MODE_SWEEP || scanner.mode == SCAN_MODE_ATLAS) {
+        scanner.total = 1;
+
+        for (uint32_t i = 0; i < scanner.num_parameters; i++) {
+            too_large |= scanner.total > UINT64_MAX / scanner.steps;
+            scanner.total *= scanner.steps;
+        }
+    }
+
+    if (scanner.mode == SCAN_MODE_SWEEP && too_large) {
+        fprintf(stderr, "sweep of %u steps over %u parameters has more than 2^64 points, use fewer steps\n",
+                scanner.steps, scanner.num_parameters);
+        return -1;
+    }
+
+    scanner.output = stdout;
+
+    if (scanner.mode == SCAN_MODE_ATLAS) {
+        if (too_large || scanner.total > ATLAS_MAX_CELLS) {
+            fprintf(stderr, "atlas would have more than %u cells, use fewer steps\n", ATLAS_MAX_CELLS);
+            return -1;
+        }
+
+        scanner.atlas_header = (AtlasHeader){
+            .type           = scanner.type,
+            .num_parameters = scanner.num_parameters,
+            .steps          = scanner.steps,
+            .min            = scanner.range[0],
+            .max            = scanner.range[1],
+            .num_cells      = scanner.total,
+        };
+
+        scanner.atlas_scores = calloc(scanner.total, sizeof(uint8_t));
+        scanner.output       = NULL;
+    } else if (scanner.output_path != NULL) {
+        bool is_new = access(scanner.output_path, F_OK) != 0;
+
+        scanner.output = fopen(scanner.output_path, scanner.format == SCAN_FORMAT_BINARY ? "ab" : "a");
+
+        if (scanner.output == NULL) {
+            fprintf(stderr, "failed to open %s\n", scanner.output_path);
+            return -1;
+        }
+
+        // Appending to an existing file continues its table
+        if (is_new) {
+            write_header(&scanner);
+        }
+    } else {
+        write_header(&scanner);
+    }
+
+    pthread_mutex_init(&scanner.output_lock, NULL);
+    signal(SIGINT, handle_interrupt);
+
+    fprintf(stderr, "scanning %llu candidates on %u threads, seed %llu\n", (unsigned long long)scanner.total,
+            scanner.threads, (unsigned long long)scanner.seed);
+
+    ScanWorker *workers    = malloc(scanner.threads * sizeof(ScanWorker));
+    double      start_time = get_time();
+
+    for (uint32_t i = 0; i < scanner.threads; i++) {
+        workers[i].scanner = &scanner;
+        pthread_create(&workers[i].thread, NULL, scan_worker_loop, &workers[i]);
+    }
+
+    // Progress report, until the workers run out of candidates or the scan is interrupted
+    while (!stop_requested && __atomic_load_n(&scanner.scanned, __ATOMIC_RELAXED) < scanner.total) {
+        struct timespec ts = {1, 0};
+        nanosleep(&ts, NULL);
+
+        uint64_t scanned = __atomic_load_n(&scanner.scanned, __ATOMIC_RELAXED);
+        uint64_t chaotic = __atomic_load_n(&scanner.chaotic, __ATOMIC_RELAXED);
+
+        fprintf(stderr, "%llu / %llu scanned, %llu chaotic, %.0f candidates/s\n", (unsigned long long)scanned,
+                (unsigned long long)scanner.total, (unsigned long long)chaotic, scanned / (get_time() - start_time));
+    }
+
+    for (uint32_t i = 0; i < scanner.threads; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+
+    fprintf(stderr, "done: %llu scanned, %llu chaotic in %.1fs\n", (unsigned long long)scanner.scanned,
+            (unsigned long long)scanner.chaotic, get_time() - start_time);
+
+    if (scanner.mode == SCAN_MODE_ATLAS) {
+        if (stop_requested) {
+            fprintf(stderr, "interrupted, %s was not written\n", scanner.output_path);
+        } else if (atlas_write(scanner.output_path, &scanner.atlas_header, scanner.atlas_scores)) {
+            fprintf(stderr, "wrote atlas %s\n", scanner.output_path);
+        }
+
+        free(scanner.atlas_scores);
+    }
+
+    if (scanner.output != stdout && scanner.output != NULL) {
+        fclose(scanner.output);
+    }
+
+    atlas_close(scanner.atlas);
+
+    pthread_mutex_destroy(&scanner.output_lock);
+    free(workers);
+
+    return 0;
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "attractor.h"
+#include "search.h"
+
+Search *search_init(AttractorType type, uint32_t num_threads, const Atlas *atlas) {
+    Search  *search      = malloc(sizeof(Search));
+    uint32_t num_workers = num_threads + 1;
+
+    search->found       = false;
+    search->done        = false;
+    search->candidates  = 0;
+    search->num_workers = num_workers;
+    search->workers     = malloc(num_workers * sizeof(SearchWorker));
+
+    for (uint32_t i = 0; i < num_workers; i++) {
+        search->workers[i].search  = search;
+        search->workers[i].scratch = make_attractor(type, SEARCH_MAP_SIZE, SEARCH_MAP_SIZE);
+        set_attractor_atlas(search->workers[i].scratch, atlas);
+    }
+
+    search->num_parameters = search->workers[0].scratch->num_parameters;
+    search->parameters     = malloc(search->num_parameters * sizeof(float));
+
+    return search;
+}
+
+void search_destroy(Search *search) {
+    for (uint32_t i = 0; i < search->num_workers; i++) {
+        destroy_attractor(search->workers[i].scratch);
+    }
+
+    free(search->workers);
+    free(search->parameters);
+    free(search);
+}
+
+// Evaluates one candidate. The data is the SearchWorker of the calling thread.
+void search_tick(void *data) {
+    SearchWorker *worker = data;
+    Search       *search = worker->search;
+
+    // Someone else already won, there is nothing left to do until the job is cleared
+    if (__atomic_load_n(&search->found, __ATOMIC_RELAXED)) {
+        return;
+    }
+
+    bool accepted = randomize_candidate(worker->scratch);
+
+    __atomic_fetch_add(&search->candidates, 1, __ATOMIC_RELAXED);
+
+    if (!accepted) {
+        return;
+    }
+
+    bool expected = false;
+    if (!__atomic_compare_exchange_n(&search->found, &expected, true, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+        return;
+    }
+
+    memcpy(search->parameters, worker->scratch->parameters, search->num_parameters * sizeof(float));
+
+    // Pairs with the acquire in search_is_done, so the parameters are visible once done is
+    __atomic_store_n(&search->done, true, __ATOMIC_RELEASE);
+}
+
+bool search_is_done(Search *search) { return __atomic_load_n(&search->done, __ATOMIC_ACQUIRE); }
+
+// Evaluates candidates on the calling thread until a winner is found. Waking the compute threads takes up to a
+// millisecond, which is about as long as a whole search on a single thread, so instead of sleeping the caller helps.
+void search_join(Search *search) {
+    SearchWorker *worker = &search->workers[search->num_workers - 1];
+
+    while (!search_is_done(search)) {
+        search_tick(worker);
+    }
+}
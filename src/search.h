@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef SRC_SEARCH_H_
+#define SRC_SEARCH_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "attractor.h"
+
+// Size of the scratch density map each worker evaluates candidates on. It is only filled by attractors without a
+// probe, so it can be much smaller than the render.
+#define SEARCH_MAP_SIZE 128
+
+typedef struct Search Search;
+
+typedef struct {
+    Search    *search;
+    Attractor *scratch; // Owns its rng and density map, so workers never touch each other's state
+} SearchWorker;
+
+// Parallel randomize_until_chaotic. Every worker draws and probes its own candidates, and the first chaotic one
+// found wins and stops the others. There is one more worker than compute threads, for the thread that joins the
+// search while waiting on it.
+struct Search {
+    uint32_t num_parameters;
+    float   *parameters; // The winning candidate, valid once done is set
+
+    bool     found;      // Claimed by the winning worker with a compare and swap
+    bool     done;       // Set after the winner copied its parameters
+    uint64_t candidates; // Candidates evaluated by all workers
+
+    uint32_t      num_workers;
+    SearchWorker *workers;
+};
+
+Search *search_init(AttractorType type, uint32_t num_threads, const Atlas *atlas);
+void    search_destroy(Search *search);
+void    search_tick(void *data);
+void    search_join(Search *search);
+bool    search_is_done(Search *search);
+
+#endif // SRC_SEARCH_H_
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "sprott.h"
+
+bool is_sprott_type(AttractorType type) {
+    return type == ATTRACTOR_TYPE_SPROTT_QUADRATIC || type == ATTRACTOR_TYPE_SPROTT_CUBIC;
+}
+
+// The length of a code is the number of coefficients, which tells the quadratic and cubic maps apart
+bool sprott_type_from_code(const char *code, AttractorType *type) {
+    switch (strlen(code)) {
+        case 12: *type = ATTRACTOR_TYPE_SPROTT_QUADRATIC; return true;
+        case 20: *type = ATTRACTOR_TYPE_SPROTT_CUBIC; return true;
+        default: return false;
+    }
+}
+
+float sprott_letter_to_coefficient(char letter) {
+    int center = SPROTT_NUM_LETTERS / 2;
+
+    return (letter - SPROTT_FIRST_LETTER - center) * SPROTT_LETTER_STEP;
+}
+
+// Returns false, leaving coefficients partly written, if the code has the wrong length or a letter outside A to Y.
+// Lowercase letters are accepted.
+bool sprott_decode(const char *code, float *coefficients, uint32_t num_coefficients) {
+    if (strlen(code) != num_coefficients) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < num_coefficients; i++) {
+        char letter = code[i] >= 'a' && code[i] <= 'z' ? code[i] - 'a' + 'A' : code[i];
+
+        if (letter < SPROTT_FIRST_LETTER || letter >= SPROTT_FIRST_LETTER + SPROTT_NUM_LETTERS) {
+            return false;
+        }
+
+        coefficients[i] = sprott_letter_to_coefficient(letter);
+    }
+
+    return true;
+}
+
+// Writes the code of the nearest letters into code, which must hold num_coefficients + 1 chars. Returns whether every
+// coefficient was already on a letter, as opposed to rounded to one or clamped into A to Y.
+bool sprott_encode(const float *coefficients, uint32_t num_coefficients, char *code) {
+    int  center = SPROTT_NUM_LETTERS / 2;
+    bool exact  = true;
+
+    for (uint32_t i = 0; i < num_coefficients; i++) {
+        float steps = coefficients[i] / SPROTT_LETTER_STEP;
+        int   index = (int)lroundf(steps) + center;
+
+        if (index < 0) {
+            index = 0;
+        } else if (index >= SPROTT_NUM_LETTERS) {
+            index = SPROTT_NUM_LETTERS - 1;
+        }
+
+        exact &= fabsf(sprott_letter_to_coefficient(SPROTT_FIRST_LETTER + index) - coefficients[i]) < 1e-4f;
+        code[i] = SPROTT_FIRST_LETTER + index;
+    }
+
+    code[num_coefficients] = '\0';
+
+    return exact;
+}
+
+// Draws a random code, so every candidate is one of the 25^12 or 25^20 maps of the catalog
+void randomize_sprott(Attractor *attractor) {
+    for (uint32_t i = 0; i < attractor->num_parameters; i++) {
+        uint32_t letter = attractor_random(attractor) * SPROTT_NUM_LETTERS;
+
+        // attractor_random rounds up to 1 once in a while
+        if (letter >= SPROTT_NUM_LETTERS) {
+            letter = SPROTT_NUM_LETTERS - 1;
+        }
+
+        attractor->parameters[i] = sprott_letter_to_coefficient(SPROTT_FIRST_LETTER + letter);
+    }
+}
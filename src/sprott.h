@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef SRC_SPROTT_H_
+#define SRC_SPROTT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "attractor.h"
+
+// Sprott's letter codes for polynomial maps. Every coefficient is one letter, from A for -1.2 up to Y for 1.2 in steps
+// of 0.1, so a quadratic map is named by 12 letters and a cubic one by 20. Sprott's own catalogs prefix the code with a
+// letter for the kind of map, which is left out here since the length already tells them apart.
+#define SPROTT_FIRST_LETTER 'A'
+#define SPROTT_NUM_LETTERS  25
+#define SPROTT_LETTER_STEP  0.1f
+
+// Longest code, plus the terminator
+#define SPROTT_MAX_CODE_LENGTH (20 + 1)
+
+bool  is_sprott_type(AttractorType type);
+bool  sprott_type_from_code(const char *code, AttractorType *type);
+float sprott_letter_to_coefficient(char letter);
+bool  sprott_decode(const char *code, float *coefficients, uint32_t num_coefficients);
+bool  sprott_encode(const float *coefficients, uint32_t num_coefficients, char *code);
+void  randomize_sprott(Attractor *attractor);
+
+#endif // SRC_SPROTT_H_
@@ -22,6 +22,7 @@
 #include <math.h>
 #include <pcg_variants.h>
 #include <stdbool.h>
+#include <time.h>
 
 bool toggle(bool *value) {
     assert(value);
@@ -32,3 +33,11 @@ bool toggle(bool *value) {
 }
 
 float random() { return ldexp(pcg32_random(), -32); }
+
+// Monotonic time in seconds. Same as glfwGetTime, for code that has to run without a window.
+double get_time() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
@@ -30,7 +30,8 @@ typedef enum Direction {
     DOWN,
 } Direction;
 
-bool  toggle(bool *value);
-float random();
+bool   toggle(bool *value);
+float  random();
+double get_time();
 
 #endif // SRC_UTILS_H_
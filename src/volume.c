@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "volume.h"
+
+Volume *volume_init(uint32_t resolution) {
+    Volume *volume = malloc(sizeof(Volume));
+
+    resolution = resolution < VOLUME_MIN_RESOLUTION ? VOLUME_MIN_RESOLUTION : resolution;
+    resolution = resolution > VOLUME_MAX_RESOLUTION ? VOLUME_MAX_RESOLUTION : resolution;
+    resolution = resolution / VOLUME_BRICK_SIZE * VOLUME_BRICK_SIZE;
+
+    uint32_t bricks     = resolution / VOLUME_BRICK_SIZE;
+    uint32_t num_bricks = bricks * bricks * bricks;
+
+    volume->resolution = resolution;
+    volume->bricks     = bricks;
+    volume->voxels     = calloc((size_t)num_bricks * VOLUME_BRICK_VOXELS, sizeof(uint16_t));
+    volume->occupied   = calloc(num_bricks, sizeof(uint8_t));
+
+    volume->samples         = 0;
+    volume->occupied_bricks = 0;
+
+    return volume;
+}
+
+void volume_destroy(Volume *volume) {
+    if (volume == NULL) {
+        return;
+    }
+
+    free(volume->voxels);
+    free(volume->occupied);
+    free(volume);
+}
+
+// Only the occupied bricks have anything to clear, which for most attractors is a small part of the cube. No worker
+// may be depositing.
+void volume_clear(Volume *volume) {
+    uint32_t num_bricks = volume->bricks * volume->bricks * volume->bricks;
+
+    for (uint32_t i = 0; i < num_bricks; i++) {
+        if (volume->occupied[i]) {
+            memset(volume->voxels + (size_t)i * VOLUME_BRICK_VOXELS, 0, VOLUME_BRICK_VOXELS * sizeof(uint16_t));
+            volume->occupied[i] = 0;
+        }
+    }
+
+    volume->samples         = 0;
+    volume->occupied_bricks = 0;
+}
+
+// Factor that takes a count to a density averaging about 1 over the occupied bricks, so how opaque the volume looks
+// does not change as samples pile up
+float volume_get_density_scale(const Volume *volume) {
+    uint64_t samples = __atomic_load_n(&volume->samples, __ATOMIC_RELAXED);
+    uint32_t bricks  = __atomic_load_n(&volume->occupied_bricks, __ATOMIC_RELAXED);
+
+    if (samples == 0) {
+        return 0;
+    }
+
+    return (float)((double)bricks * VOLUME_BRICK_VOXELS / samples);
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef SRC_VOLUME_H_
+#define SRC_VOLUME_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Voxels are stored in bricks of this many voxels per side, so the samples of an orbit, which move little from one
+// step to the next, and the steps of a ray stay within a few cache lines
+#define VOLUME_BRICK_BITS   3
+#define VOLUME_BRICK_SIZE   (1u << VOLUME_BRICK_BITS)
+#define VOLUME_BRICK_VOXELS (VOLUME_BRICK_SIZE * VOLUME_BRICK_SIZE * VOLUME_BRICK_SIZE)
+
+#define VOLUME_MIN_RESOLUTION     64
+#define VOLUME_DEFAULT_RESOLUTION 256
+#define VOLUME_MAX_RESOLUTION     512 // 256MB of counts
+
+// Counts stop this far short of UINT16_MAX. The test and the add are separate atomics, so this many workers can all
+// pass the test on one voxel before any of them adds, and the count still does not wrap.
+#define VOLUME_SATURATION_MARGIN 256
+#define VOLUME_SATURATION        (UINT16_MAX - VOLUME_SATURATION_MARGIN)
+
+// Sample counts over the cube [-1, 1]^3 of an attractor's normalized space, the same space the camera looks at. All
+// the workers deposit into one volume with relaxed atomics, so it is not duplicated per worker, and the ray marcher
+// renders it from any viewpoint without iterating the attractor again.
+typedef struct {
+    uint32_t resolution; // Voxels along each side, a multiple of VOLUME_BRICK_SIZE
+    uint32_t bricks;     // Bricks along each side
+
+    uint16_t *voxels;   // One brick after the other, each with x varying fastest, then y, then z
+    uint8_t  *occupied; // One byte per brick, set by the first sample that lands in it. The ray marcher skips the rest.
+
+    uint64_t samples;         // Deposited so far
+    uint32_t occupied_bricks; // Bricks with their byte set
+} Volume;
+
+Volume *volume_init(uint32_t resolution);
+void    volume_destroy(Volume *volume);
+void    volume_clear(Volume *volume);
+float   volume_get_density_scale(const Volume *volume);
+
+// Index in voxels of the voxel at (x, y, z). Bricks are VOLUME_BRICK_VOXELS long, so the brick holding a voxel is its
+// index shifted right by three times VOLUME_BRICK_BITS.
+static inline uint32_t volume_get_voxel(uint32_t bricks, uint32_t x, uint32_t y, uint32_t z) {
+    const uint32_t mask  = VOLUME_BRICK_SIZE - 1;
+    uint32_t       brick = ((z >> VOLUME_BRICK_BITS) * bricks + (y >> VOLUME_BRICK_BITS)) * bricks +
+                     (x >> VOLUME_BRICK_BITS);
+    uint32_t local = ((z & mask) << (2 * VOLUME_BRICK_BITS)) | ((y & mask) << VOLUME_BRICK_BITS) | (x & mask);
+
+    return brick * VOLUME_BRICK_VOXELS + local;
+}
+
+static inline uint32_t volume_get_brick(uint32_t voxel) { return voxel >> (3 * VOLUME_BRICK_BITS); }
+
+// Safe to call from any number of workers at once, up to VOLUME_SATURATION_MARGIN. The occupancy byte is tested
+// before it is exchanged, so after the first sample a brick only ever reads it.
+static inline void volume_deposit(Volume *volume, uint32_t voxel) {
+    uint16_t *count = &volume->voxels[voxel];
+    uint8_t  *brick = &volume->occupied[volume_get_brick(voxel)];
+
+    if (__atomic_load_n(count, __ATOMIC_RELAXED) < VOLUME_SATURATION) {
+        __atomic_fetch_add(count, 1, __ATOMIC_RELAXED);
+    }
+
+    if (!__atomic_load_n(brick, __ATOMIC_RELAXED) && !__atomic_exchange_n(brick, 1, __ATOMIC_RELAXED)) {
+        __atomic_fetch_add(&volume->occupied_bricks, 1, __ATOMIC_RELAXED);
+    }
+}
+
+// Workers add up their deposits and report them once per tick, rather than contending on one counter per sample
+static inline void volume_add_samples(Volume *volume, uint64_t samples) {
+    __atomic_fetch_add(&volume->samples, samples, __ATOMIC_RELAXED);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SRC_VOLUME_H_
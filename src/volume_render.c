@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+// Built with the SIMD flags. Every lane of a packet runs the same branch free step, a voxel or a whole brick long, so
+// the loop over lanes vectorizes with gathers for the voxel reads.
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "volume_render.h"
+
+// Keeps direction components off zero, so their reciprocals stay finite. -ffast-math assumes there are no infinities.
+#define VOLUME_RENDER_MIN_DIRECTION 1e-6f
+// How far past the side of an empty brick a skip lands, in voxels, so the next step is inside the next brick
+#define VOLUME_RENDER_SKIP_EPSILON 0.01f
+
+void volume_render_start(VolumeRender *render, const Volume *volume, const Camera *camera, float absorption,
+                         uint32_t *image, uint32_t width, uint32_t height) {
+    float eye[3];
+    float half_resolution = volume->resolution * 0.5f;
+
+    camera_get_rays(camera, (float)width / height, eye, render->forward, render->right, render->up);
+
+    // Voxel coordinates are the normalized ones moved to [0, resolution]. Directions keep their length, so ray
+    // parameters are in voxels.
+    for (int i = 0; i < 3; i++) {
+        render->eye[i] = (eye[i] + 1) * half_resolution;
+    }
+
+    render->volume        = volume;
+    render->density_scale = volume_get_density_scale(volume);
+    render->absorption    = absorption;
+    render->image         = image;
+    render->width         = width;
+    render->height        = height;
+
+    render->tiles_per_row = (width + VOLUME_RENDER_TILE_SIZE - 1) / VOLUME_RENDER_TILE_SIZE;
+    render->num_tiles     = render->tiles_per_row * ((height + VOLUME_RENDER_TILE_SIZE - 1) / VOLUME_RENDER_TILE_SIZE);
+    render->next          = 0;
+    render->completed     = 0;
+}
+
+// Count at a point in voxel coordinates, blended from the 8 voxels whose centers surround it. Taking the nearest
+// voxel instead draws the voxel grid over the image wherever the orbit forms thin sheets.
+static inline float sample_trilinear(const uint16_t *voxels, uint32_t bricks, float resolution, const float *p) {
+    uint32_t low[3];
+    float    weight[3];
+
+    for (int i = 0; i < 3; i++) {
+        float center = fminf(fmaxf(p[i] - 0.5f, 0), resolution - 2);
+
+        low[i]    = (uint32_t)center;
+        weight[i] = fminf(center - low[i], 1);
+    }
+
+    float c000 = voxels[volume_get_voxel(bricks, low[0], low[1], low[2])];
+    float c100 = voxels[volume_get_voxel(bricks, low[0] + 1, low[1], low[2])];
+    float c010 = voxels[volume_get_voxel(bricks, low[0], low[1] + 1, low[2])];
+    float c110 = voxels[volume_get_voxel(bricks, low[0] + 1, low[1] + 1, low[2])];
+    float c001 = voxels[volume_get_voxel(bricks, low[0], low[1], low[2] + 1)];
+    float c101 = voxels[volume_get_voxel(bricks, low[0] + 1, low[1], low[2] + 1)];
+    float c011 = voxels[volume_get_voxel(bricks, low[0], low[1] + 1, low[2] + 1)];
+    float c111 = voxels[volume_get_voxel(bricks, low[0] + 1, low[1] + 1, low[2] + 1)];
+
+    float c00 = c000 + (c100 - c000) * weight[0];
+    float c10 = c010 + (c110 - c010) * weight[0];
+    float c01 = c001 + (c101 - c001) * weight[0];
+    float c11 = c011 + (c111 - c011) * weight[0];
+    float c0  = c00 + (c10 - c00) * weight[1];
+    float c1  = c01 + (c11 - c01) * weight[1];
+
+    return c0 + (c1 - c0) * weight[2];
+}
+
+// Marches the rays of VOLUME_RENDER_PACKET pixels of a row, starting at column x. Lanes past the end of the row or
+// whose ray misses the volume start out done.
+static void march_packet(VolumeRender *render, uint32_t x, uint32_t y) {
+    const Volume   *volume     = render->volume;
+    const uint16_t *voxels     = volume->voxels;
+    const uint8_t  *occupied   = volume->occupied;
+    const uint32_t  bricks     = volume->bricks;
+    const float     resolution = volume->resolution;
+    const float     brick_size = VOLUME_BRICK_SIZE;
+
+    // A step is one voxel, which is 2 / resolution in normalized units
+    const float step_length = 2 / resolution;
+    const float emission    = render->density_scale * step_length;
+    const float absorption  = render->density_scale * step_length * render->absorption;
+    const float *eye        = render->eye;
+
+    float    direction[3][VOLUME_RENDER_PACKET];
+    float    inverse[3][VOLUME_RENDER_PACKET];
+    float    t[VOLUME_RENDER_PACKET];
+    float    t_end[VOLUME_RENDER_PACKET];
+    float    transmittance[VOLUME_RENDER_PACKET];
+    float    radiance[VOLUME_RENDER_PACKET];
+    uint32_t active[VOLUME_RENDER_PACKET];
+
+    float v = (y + 0.5f) / render->height * 2 - 1;
+
+    for (uint32_t l = 0; l < VOLUME_RENDER_PACKET; l++) {
+        float u      = (x + l + 0.5f) / render->width * 2 - 1;
+        float length = 0;
+
+        for (int i = 0; i < 3; i++) {
+            direction[i][l] = render->forward[i] + u * render->right[i] + v * render->up[i];
+            length += direction[i][l] * direction[i][l];
+        }
+
+        float t_near = 0;
+        float t_far  = INFINITY;
+
+        for (int i = 0; i < 3; i++) {
+            float d = direction[i][l] / sqrtf(length);
+            d       = fabsf(d) < VOLUME_RENDER_MIN_DIRECTION ? copysignf(VOLUME_RENDER_MIN_DIRECTION, d) : d;
+
+            direction[i][l] = d;
+            inverse[i][l]   = 1 / d;
+
+            // Where the ray crosses the two faces of the volume on this axis
+            float t0 = -eye[i] * inverse[i][l];
+            float t1 = (resolution - eye[i]) * inverse[i][l];
+
+            t_near = fmaxf(t_near, fminf(t0, t1));
+            t_far  = fminf(t_far, fmaxf(t0, t1));
+        }
+
+        t[l]             = t_near;
+        t_end[l]         = t_far;
+        transmittance[l] = 1;
+        radiance[l]      = 0;
+        active[l]        = (x + l < render->width) & (t_near < t_far);
+    }
+
+    // Every step moves a ray at least a voxel or to the next brick, so this is never reached by a ray that is still
+    // inside. It only bounds the loop.
+    const uint32_t max_steps = 4 * volume->resolution;
+
+    for (uint32_t s = 0; s < max_steps; s++) {
+        uint32_t any_active = 0;
+
+        for (uint32_t l = 0; l < VOLUME_RENDER_PACKET; l++) {
+            float p[3], exit = INFINITY;
+            uint32_t c[3];
+
+            for (int i = 0; i < 3; i++) {
+                p[i] = eye[i] + t[l] * direction[i][l];
+                p[i] = fminf(fmaxf(p[i], 0), resolution - 1);
+                c[i] = (uint32_t)p[i];
+
+                // Distance to the side of the current brick the ray leaves through
+                float brick_start = (float)(c[i] & ~(VOLUME_BRICK_SIZE - 1));
+                float side        = direction[i][l] > 0 ? brick_start + brick_size : brick_start;
+                exit              = fminf(exit, (side - p[i]) * inverse[i][l]);
+            }
+
+            uint32_t voxel = volume_get_voxel(bricks, c[0], c[1], c[2]);
+            uint32_t full  = occupied[volume_get_brick(voxel)] & active[l];
+            float    count = full ? sample_trilinear(voxels, bricks, resolution, p) : 0;
+
+            radiance[l] += transmittance[l] * count * emission;
+            transmittance[l] *= expf(-count * absorption);
+
+            // Empty bricks are crossed in one step, of as many whole voxels as it takes to leave them. Samples stay
+            // on the same grid along the ray whatever was skipped, which neighbouring rays share, so the image has
+            // no banding where their skips end at different places.
+            t[l] += full ? 1 : ceilf(fmaxf(exit, 0) + VOLUME_RENDER_SKIP_EPSILON);
+
+            active[l] &= (t[l] < t_end[l]) & (transmittance[l] > VOLUME_RENDER_MIN_TRANSMITTANCE);
+            any_active |= active[l];
+        }
+
+        if (!any_active) {
+            break;
+        }
+    }
+
+    uint32_t *row = render->image + y * render->width;
+
+    for (uint32_t l = 0; l < VOLUME_RENDER_PACKET && x + l < render->width; l++) {
+        row[x + l] = (uint32_t)(radiance[l] * VOLUME_RENDER_OUTPUT_SCALE);
+    }
+}
+
+void volume_render_tick(void *data) {
+    VolumeRender *render = data;
+    uint32_t      tile   = __atomic_fetch_add(&render->next, 1, __ATOMIC_RELAXED);
+
+    if (tile >= render->num_tiles) {
+        // Nothing left to claim, wait for the manager to clear the job
+        struct timespec ts = {0, 1000000};
+        nanosleep(&ts, NULL);
+        return;
+    }
+
+    uint32_t tile_x = (tile % render->tiles_per_row) * VOLUME_RENDER_TILE_SIZE;
+    uint32_t tile_y = (tile / render->tiles_per_row) * VOLUME_RENDER_TILE_SIZE;
+
+    for (uint32_t y = tile_y; y < tile_y + VOLUME_RENDER_TILE_SIZE && y < render->height; y++) {
+        for (uint32_t x = tile_x; x < tile_x + VOLUME_RENDER_TILE_SIZE && x < render->width;
+             x += VOLUME_RENDER_PACKET) {
+            march_packet(render, x, y);
+        }
+    }
+
+    __atomic_fetch_add(&render->completed, 1, __ATOMIC_RELEASE);
+}
+
+bool volume_render_is_done(VolumeRender *render) {
+    return __atomic_load_n(&render->completed, __ATOMIC_ACQUIRE) == render->num_tiles;
+}
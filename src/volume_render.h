@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2025  Renan S. Silva, aka h3nnn4n
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+ * documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+ * Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+ * WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#ifndef SRC_VOLUME_RENDER_H_
+#define SRC_VOLUME_RENDER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "camera.h"
+#include "volume.h"
+
+// Work is handed out in tiles of this many pixels per side
+#define VOLUME_RENDER_TILE_SIZE 16
+// Rays marched side by side, one per SIMD lane. Neighbouring pixels, so their steps read nearby voxels.
+#define VOLUME_RENDER_PACKET 8
+// Rays stop once this little of what is behind would still show through
+#define VOLUME_RENDER_MIN_TRANSMITTANCE 0.01f
+// The image is fixed point, in units of 1 / VOLUME_RENDER_OUTPUT_SCALE of emitted light
+#define VOLUME_RENDER_OUTPUT_SCALE 65536.0f
+
+#define VOLUME_RENDER_DEFAULT_ABSORPTION 2.0f
+#define VOLUME_RENDER_MAX_ABSORPTION     16.0f
+
+// One image of a volume through a camera, rendered by any number of workers. Each ray is marched front to back
+// through the voxels it crosses, adding the light every voxel emits in proportion to its density and dimming what is
+// behind by its absorption. The result goes into a density map, so it is tone mapped like any other render. With no
+// absorption it is the same sum of samples along each ray that drawing the orbit through the camera gives.
+typedef struct {
+    const Volume *volume;
+
+    // In voxel coordinates, see camera_get_rays
+    float eye[3];
+    float forward[3];
+    float right[3];
+    float up[3];
+
+    float density_scale; // From counts to densities, see volume_get_density_scale
+    float absorption;    // Per unit of density and of normalized length
+
+    uint32_t *image;
+    uint32_t  width;
+    uint32_t  height;
+
+    uint32_t tiles_per_row;
+    uint32_t num_tiles;
+    uint32_t next;      // Next tile to claim
+    uint32_t completed; // Tiles done
+} VolumeRender;
+
+void volume_render_start(VolumeRender *render, const Volume *volume, const Camera *camera, float absorption,
+                         uint32_t *image, uint32_t width, uint32_t height);
+void volume_render_tick(void *data);
+bool volume_render_is_done(VolumeRender *render);
+
+#endif // SRC_VOLUME_RENDER_H_